@@ -0,0 +1,131 @@
+#ifndef _BATCH_OPTIONS_H
+#define _BATCH_OPTIONS_H
+
+#include <string>
+
+// Command line options of the cableTest executable.
+//
+// Without options the application opens its window (when built with
+// USE_OSG) and runs until it is closed. In headless mode no graphics are
+// created and the run stops after a fixed number of steps or a fixed amount
+// of simulated time, which makes it usable on batch nodes.
+//
+//   --headless           Do not create any window, camera or graphics extension.
+//   --scene <name>       "bricks" (default) for the two-cable brick scene,
+//                        "crane" for the ExCableSystem crane or "stress" for
+//                        a yard of cranes (see StressScene).
+//   --steps <n>          Stop after n steps.
+//   --sim-time <t>       Stop after t seconds of simulated time.
+//   --time-step <dt>     Simulated time of a step (default 1/60 s): the application
+//                        runs at 1 / dt steps per second of simulated time, and
+//                        --sim-time is converted into steps with it.
+//   --real-time          Pace the steps at 1 / time step per second of wall time
+//                        instead of running them as fast as possible (see
+//                        FixedRateScheduler).
+//   --max-catch-up <n>   With --real-time, most steps run back to back to catch
+//                        up after a long frame (default 4); the others are dropped.
+//   --substeps <n>       Split every step in n substeps, for stiff cables: n
+//                        updates at n times the frame rate on Vortex, n times the
+//                        solver substeps on the native backend.
+//   --stats <file>       Write the step time summary to file; CSV when the
+//                        name ends with ".csv", JSON otherwise.
+//   --profile <file>     Write the time of each phase of every step to file (CSV).
+//   --cable <file>       Crane scene only: create the cable from the definition
+//                        file (see Sim::CableDefinitionLoader).
+//   --cranes <n>         Stress scene only: number of cranes (default 4).
+//   --cables-per-crane <n>
+//                        Stress scene only: cables of each crane (default 1).
+//   --cable-length <l>   Stress scene only: length of each cable in m (default 40).
+//   --section-length <l> Crane and stress scenes: maximum length of the
+//                        sections of the flexible segments, in m.
+//   --pulleys <n>        Stress scene only: pulleys on each cable, the crane
+//                        pulleys then static idlers (default 2).
+//   --layout <name>      Stress scene only: "grid" (default) or "random".
+//   --seed <n>           Stress scene only: seed of the random layout.
+//   --adaptive-sections  Crane scene, native runner only: refine the cable
+//                        sections where the cable bends or touches, and coarsen
+//                        them elsewhere.
+//   --implicit-cables    Native runner only: solve the sections of each cable
+//                        together, which holds stiff cables with 2 substeps per
+//                        step instead of 20 (see Sim::CableChain::solve).
+//   --threads <n>        Native runner only: solve the independent islands of
+//                        the scene (the cranes, the cables that do not touch)
+//                        on n threads; 0 for one per hardware thread. The
+//                        results are the same for any n (default 1).
+//   --memory-report      Native runner only: print the memory held by the scene at
+//                        the end of the run, by mechanism and kind of object (see
+//                        Sim::NativeScene::getMemoryReport).
+//   --record <file>      Native runner only: record the state at every step in
+//                        a binary trajectory file (see TrajectoryRecorder).
+//   --export <file>      Native runner only: write the geometry of the parts, then
+//                        their transforms and the cable sections at every step, in
+//                        a binary scene file for the offline renderers (see
+//                        SceneExporter).
+//   --telemetry <file>   Native runner only: stream the tension and strain of
+//                        every cable section at every step to file (CSV) from
+//                        a monitoring thread (see CableTelemetry).
+//   --render-rate <hz>   Native runner only: hand a snapshot of the scene to a
+//                        render thread after every step; the thread draws the
+//                        latest one hz times per second of wall time, whatever
+//                        the step rate (see RenderSnapshot).
+//   --record-controls <file>
+//                        Save the crane controls given with the keyboard, keyed
+//                        by step (see ControlLog).
+//   --replay-controls <file>
+//                        Crane scene only: apply the saved controls at the steps
+//                        they were recorded at.
+//   --motion <file>      Crane scene only: drive the motors with the velocity
+//                        profiles of the file (see CraneController).
+//   --save-checkpoint <file>
+//                        Native runner only: save the state of the scene at the
+//                        end of the run (see Sim::NativeScene::saveCheckpoint).
+//   --load-checkpoint <file>
+//                        Native runner only: start from the state saved by a run
+//                        of the same scene, instead of from rest.
+struct BatchOptions
+{
+    BatchOptions();
+
+    // Parse the command line. Returns false and prints the usage when an
+    // option is unknown or malformed.
+    bool parse(int argc, const char* argv[]);
+
+    // Number of steps to run, 0 when the run is not limited.
+    size_t getMaxStepCount() const;
+
+    void printUsage(const char* iProgramName) const;
+
+    bool headless;
+    std::string sceneName;
+    size_t stepCount;
+    double simulationTime;
+    double timeStep;
+    bool realTime;
+    size_t maxCatchUpSteps;
+    int substepCount;
+    std::string statsFileName;
+    std::string profileFileName;
+    std::string cableFileName;
+    size_t craneCount;
+    size_t cablesPerCrane;
+    double cableLength;
+    double sectionLength;
+    size_t pulleyCount;
+    std::string layout;
+    unsigned int seed;
+    bool adaptiveSections;
+    bool implicitCables;
+    size_t threadCount;
+    bool memoryReport;
+    std::string recordFileName;
+    std::string exportFileName;
+    std::string telemetryFileName;
+    double renderRate;
+    std::string recordControlsFileName;
+    std::string replayControlsFileName;
+    std::string motionFileName;
+    std::string saveCheckpointFileName;
+    std::string loadCheckpointFileName;
+};
+
+#endif // _BATCH_OPTIONS_H
@@ -0,0 +1,123 @@
+#ifndef _BENCHMARK_SUITE_H
+#define _BENCHMARK_SUITE_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Sim
+{
+    class NativeScene;
+}
+
+// Named step-time benchmarks of the native backend, compared against a
+// baseline.
+//
+// Each case builds its scene in a fresh Sim::NativeScene and runs a fixed
+// number of steps, recording the wall-clock time of every step, the heap
+// allocations made by the steps and the peak resident set size of the
+// process while the case runs. The results are written as JSON; a previous
+// results file used as the baseline makes the suite fail the cases that got
+// slower or bigger than its thresholds allow.
+class BenchmarkSuite
+{
+public:
+    // Build the scene of a case; the scene owns everything it needs.
+    typedef void (*Builder)(Sim::NativeScene& ioScene);
+
+    // Number of heap allocations made by the process so far. The suite
+    // cannot count them itself: the executable replaces operator new and
+    // hands its counter here, or NULL to not count them.
+    typedef size_t (*AllocationCounter)();
+
+    struct Case
+    {
+        std::string name;
+        std::string description;
+        Builder builder;
+        size_t stepCount;
+    };
+
+    struct Result
+    {
+        std::string name;
+        size_t stepCount;
+        // Step times in seconds.
+        double mean;
+        double p50;
+        double p90;
+        double p99;
+        double max;
+        // Negative when not measured.
+        double allocationsPerStep;
+        double peakRssKiB;
+        // Filled by compare(): "pass", "fail" or "new" without baseline.
+        std::string status;
+        std::vector<std::string> regressions;
+    };
+
+    // Allowed growth over the baseline: ratios for the times and the
+    // memory, an absolute number for the allocations. The times also get a
+    // slack, the percentiles of steps of a few microseconds being noisy.
+    struct Thresholds
+    {
+        Thresholds();
+
+        double p50Ratio;
+        double p99Ratio;
+        double timeSlackMs;
+        double allocationsPerStep;
+        double peakRssRatio;
+    };
+
+    // Constructor
+    // The suite holds the standard cases, see the source for the scenes.
+    //
+    BenchmarkSuite();
+
+    const std::vector<Case>& getCases() const { return mCases; }
+
+    void setAllocationCounter(AllocationCounter iCounter) { mAllocationCounter = iCounter; }
+
+    // Run the cases whose name is in iNames, or all of them when it is
+    // empty. A step count of 0 keeps the one of each case. Returns false
+    // and prints the name when a case does not exist.
+    //
+    bool run(const std::vector<std::string>& iNames, size_t iStepCount);
+
+    // Read the results of a previous run, and optional "thresholds" in the
+    // same file. Returns false and prints the reason on failure.
+    //
+    bool loadBaseline(const std::string& iFileName);
+
+    // Compare the results to the baseline. Returns false when a case
+    // regressed.
+    //
+    bool compare();
+
+    const std::vector<Result>& getResults() const { return mResults; }
+
+    // Write the results, and the thresholds, as JSON. Returns false if the
+    // file cannot be written.
+    //
+    bool writeJson(const std::string& iFileName) const;
+
+    void printResults() const;
+
+private:
+    // @internal helpers
+    Result _runCase(const Case& iCase, size_t iStepCount) const;
+    void _writeJson(std::ostream& oStream) const;
+
+private:
+    std::vector<Case> mCases;
+    AllocationCounter mAllocationCounter;
+    Thresholds mThresholds;
+
+    std::vector<Result> mResults;
+    // Baseline values by case name then by result key ("p50", ...).
+    std::map< std::string, std::map<std::string, double> > mBaseline;
+};
+
+#endif // _BENCHMARK_SUITE_H
@@ -0,0 +1,15 @@
+#ifndef _BRICK_SCENE_H
+#define _BRICK_SCENE_H
+
+#include "SimBackend.h"
+
+// Create the test mechanism with the four bricks and the two cables linking them:
+// "testCableExtension" between brick_2 and brick_1 and the stiff breakable
+// "testCableExtension2" between brick_3 and brick_4.
+//
+// With iImplicitCables, the cables are solved implicitly by the native backend.
+//
+// Returns the new mechanism.
+Sim::MechanismId CreateBrickScene(Sim::IScene& iScene, bool iImplicitCables = false);
+
+#endif // _BRICK_SCENE_H
@@ -0,0 +1,90 @@
+#ifndef _CABLE_BROADPHASE_H
+#define _CABLE_BROADPHASE_H
+
+#include "NativeMath.h"
+
+#include <utility>
+#include <vector>
+
+namespace Sim
+{
+    class CableChain;
+
+    // Bounding volume hierarchy over the sections of a CableChain.
+    //
+    // A chain needs no sorting to build a good hierarchy: consecutive
+    // sections are close to each other, so the tree is a complete binary
+    // tree over the sections in chain order, stored in an array (node k has
+    // the children 2k and 2k+1, the section i is the leaf mLeafCount + i).
+    // It is rebuilt only when the chain inserts or erases nodes, and refit
+    // otherwise.
+    //
+    // The boxes of the sections are fattened by a margin, and a section only
+    // refits its branch when it leaves its fat box. Between two substeps
+    // most sections move much less than the margin, so update() usually
+    // touches no box at all and the owner keeps the pairs it found before.
+    //
+    // The pairs of sections of the same chain that share a node always
+    // overlap and are never reported.
+    class CableBroadphase
+    {
+    public:
+        typedef std::pair<size_t, size_t> SectionPair;
+
+        // Constructor
+        //
+        CableBroadphase();
+
+        // Fit the tree to the sections of iChain, each section being a
+        // capsule of radius iRadius, with boxes fattened by iMargin. The
+        // broken sections are left out. Returns true when a box changed, the
+        // pairs found before are then out of date.
+        //
+        bool update(const CableChain& iChain, double iRadius, double iMargin);
+
+        // Append the sections whose box overlaps iBox, in increasing order.
+        //
+        void query(const Aabb& iBox, std::vector<size_t>& oSections);
+
+        // Append the pairs of sections of the chain whose boxes overlap, the
+        // first section of a pair before the second one in the chain.
+        //
+        void findSelfPairs(std::vector<SectionPair>& oPairs);
+
+        // Append the pairs (section of this chain, section of iOther) whose
+        // boxes overlap.
+        //
+        void findPairs(const CableBroadphase& iOther, std::vector<SectionPair>& oPairs);
+
+        // Bounds of the whole chain.
+        const Aabb& getBounds() const { return mBoxes.size() > 1 ? mBoxes[1] : mEmpty; }
+
+        // Fat boxes moved by the last update(), or the section count when it rebuilt the tree.
+        size_t getRefitCount() const { return mRefitCount; }
+
+        // Bytes allocated by the tree and the scratch stacks.
+        size_t getMemoryUsage() const;
+
+    private:
+        // @internal helpers
+        void _rebuild(const CableChain& iChain, double iRadius, double iMargin);
+        Aabb _getSectionBox(const CableChain& iChain, size_t iSection, double iRadius) const;
+        bool _isLeaf(size_t iNode) const { return iNode >= mLeafCount; }
+
+    private:
+        size_t mSectionCount;
+        // Power of two, the leaves past the sections stay empty.
+        size_t mLeafCount;
+        size_t mLayoutRevision;
+        size_t mRefitCount;
+        // mBoxes[0] is not used.
+        std::vector<Aabb> mBoxes;
+        Aabb mEmpty;
+
+        // Scratch stacks of the traversals, kept to avoid allocating in the step.
+        std::vector<size_t> mStack;
+        std::vector<SectionPair> mPairStack;
+    };
+}
+
+#endif // _CABLE_BROADPHASE_H
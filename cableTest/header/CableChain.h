@@ -0,0 +1,208 @@
+#ifndef _CABLE_CHAIN_H
+#define _CABLE_CHAIN_H
+
+#include "CableKernels.h"
+#include "ChainArray.h"
+#include "SimBackend.h"
+
+#include <string>
+#include <vector>
+
+namespace Sim
+{
+    // Lumped-mass cable of the native backend.
+    //
+    // The cable is a chain of nodes linked by sections: section i goes from
+    // node i to node i+1. The state is stored as structure of arrays so that
+    // CableKernels steps all the nodes and sections with vector instructions.
+    //
+    // The arrays hold only the deployed sections, so the step cost follows
+    // the deployed length. Their capacity is sized once at build for the
+    // deployable length of the cable (CableParams::deployableLength), so the
+    // winch pays out without reallocating them; they only grow beyond it when
+    // the sections are refined. They are ChainArrays: a section split or
+    // merged at the winch or near the load only moves the elements between
+    // it and that end of the cable.
+    //
+    // The sections of adaptive segments are also refined where the cable
+    // bends, touches down or changes tension sharply, down to the
+    // minimum section length, and coarsened up to the maximum one where it
+    // is straight and evenly loaded. The thresholds to merge are well below
+    // the ones to split, so that sections do not flip between the two. Both
+    // operations keep the total mass and momentum of the chain.
+    //
+    // The nodes at the points of the definition are pinned on their part; the
+    // owner of the chain moves them with the parts (see NativeScene). The
+    // cable slides without friction through the pinned nodes between the
+    // first and the last one, and the first section is spooled by the winch.
+    class CableChain
+    {
+    public:
+        // A section that broke, and the tension that broke it.
+        struct SectionBreak
+        {
+            size_t section;
+            double tension;
+        };
+
+        // Constructor
+        //
+        CableChain();
+
+        // Build the nodes and sections from the definition. iPointPositions
+        // are the world positions of the points of the definition.
+        //
+        void build(const CableDefinition& iDefinition, const std::vector<Vec3>& iPointPositions);
+
+        const CableDefinition& getDefinition() const { return mDefinition; }
+
+        // Step kernels, called in this order in each substep.
+        void predict(double h, const Vec3& iGravity);
+        void slide();
+        // Returns false when an implicit iteration found the chain already
+        // solved and did not move it.
+        bool solve(double h, const double* iPinnedInvMass = NULL, int iIteration = 0);
+        void updateVelocities(double h);
+
+        // True when the sections are solved together (CableParams::implicitAxial).
+        // The red-black passes of the default solve need many substeps to
+        // converge on a stiff cable, which then stretches like a softer one;
+        // the implicit solve converges in one. Its pinned nodes are lumped
+        // with their part: iPinnedInvMass gives, for each pinned node, the
+        // inverse mass matrix of the node and its part at the node (6
+        // coefficients xx, xy, xz, yy, yz, zz per node), so that a heavy
+        // load is held by the whole chain in a single substep. The free
+        // nodes are not read, and a NULL array solves the chain alone.
+        // Further iterations of the implicit solve in the same substep
+        // (iIteration > 0) correct the error of the linearization when the
+        // chain turns quickly; they are skipped once every section is within
+        // a small ratio of the length the solve gives it.
+        bool isImplicit() const { return mDefinition.params.implicitAxial; }
+        // Impulse (times the substep) given to a node by its sections in
+        // the last implicit solve; the owner passes the share of the part to
+        // it.
+        Vec3 getNodeImpulse(size_t iNode) const;
+
+        // Add iLength to the rest length of the first section (negative to
+        // reel in), updating the masses of the nodes at its ends.
+        void spool(double iLength);
+
+        // Nodes
+        size_t getNodeCount() const { return mX.size(); }
+        Vec3 getNodePosition(size_t iNode) const { return Vec3(mX[iNode], mY[iNode], mZ[iNode]); }
+        void setNodePosition(size_t iNode, const Vec3& iPosition) { mX[iNode] = iPosition.x; mY[iNode] = iPosition.y; mZ[iNode] = iPosition.z; }
+        Vec3 getNodePreviousPosition(size_t iNode) const { return Vec3(mPreviousX[iNode], mPreviousY[iNode], mPreviousZ[iNode]); }
+        double getNodeInvMass(size_t iNode) const { return mInvMass[iNode]; }
+        // kInvalidId when the node is free.
+        PartId getNodePart(size_t iNode) const { return mNodePart[iNode]; }
+        const Vec3& getNodeOffset(size_t iNode) const { return mNodeOffset[iNode]; }
+        // Flag a node in contact in the current substep; adaptive sections
+        // are refined around it in the next one.
+        void setNodeContact(size_t iNode) { mContact[iNode] = 1; }
+
+        // Sections
+        size_t getSectionCount() const { return mRestLength.size(); }
+        double getSectionRestLength(size_t iSection) const { return mRestLength[iSection]; }
+        double getSectionTension(size_t iSection) const { return mTension[iSection]; }
+        bool isSectionBroken(size_t iSection) const { return mIntact[iSection] == 0.0; }
+
+        bool isBroken() const { return mBroken; }
+
+        // Breaks in the order they happened. Their sections follow the
+        // layout: they are renumbered when nodes are inserted or erased
+        // before them. The first getRestoredBreakCount() ones were restored
+        // by the last loadState(), the others happened since.
+        size_t getBreakCount() const { return mBreaks.size(); }
+        const SectionBreak& getBreak(size_t iBreak) const { return mBreaks[iBreak]; }
+        size_t getRestoredBreakCount() const { return mRestoredBreakCount; }
+
+        // Changes whenever nodes are inserted or erased, so that the data
+        // kept per node or section by other objects can be rebuilt.
+        size_t getLayoutRevision() const { return mLayoutRevision; }
+        bool hasCollision() const { return mCollide; }
+
+        // Current length along the nodes.
+        double getLength() const;
+        double getRestLength() const;
+
+        // Bytes allocated by the arrays of the chain.
+        size_t getMemoryUsage() const;
+
+        // Checkpoint of the dynamic state: the nodes, the section layout,
+        // the tensions, the breaks and the broken flag. loadState() expects
+        // a chain built from the same definition; it returns false, leaving
+        // the chain unchanged, when the data is truncated or its pinned
+        // nodes do not match the points of the definition.
+        void saveState(std::vector<unsigned char>& oBuffer) const;
+        bool loadState(const unsigned char*& ioData, const unsigned char* iEnd);
+
+    private:
+        // @internal helpers
+        void _addNode(const Vec3& iPosition, PartId iPart, const Vec3& iOffset);
+        void _addSection(double iRestLength, const CableSegmentDefinition* iSegment);
+        void _insertNode(size_t iNode);
+        void _eraseNode(size_t iNode);
+        void _updateSections();
+        void _splitSection(size_t iSection);
+        void _mergeSections(size_t iSection);
+        void _absorbNode(size_t iNode, size_t iRemoved, double iNodeLength, double iShare);
+        bool _needsDetail(size_t iNode) const;
+        bool _isSmooth(size_t iNode) const;
+        bool _isContactEdge(size_t iNode) const;
+        double _getBendCosine(size_t iNode) const;
+        double _getTensionJump(size_t iNode) const;
+        void _updateNodeMasses();
+        void _updateNodeMass(size_t iNode);
+        void _fitCapacity(size_t iNodeCount);
+        CableKernels::Chain _getKernelChain();
+
+    private:
+        CableDefinition mDefinition;
+        bool mCollide;
+        bool mBroken;
+        std::vector<SectionBreak> mBreaks;
+        size_t mRestoredBreakCount;
+        size_t mLayoutRevision;
+        // Nodes of the deployable length, counted at build.
+        size_t mDeployableNodeCount;
+
+        // Nodes
+        ChainArray<double> mX;
+        ChainArray<double> mY;
+        ChainArray<double> mZ;
+        ChainArray<double> mPreviousX;
+        ChainArray<double> mPreviousY;
+        ChainArray<double> mPreviousZ;
+        ChainArray<double> mVx;
+        ChainArray<double> mVy;
+        ChainArray<double> mVz;
+        ChainArray<double> mInvMass;
+        ChainArray<PartId> mNodePart;
+        ChainArray<Vec3> mNodeOffset;
+        ChainArray<char> mContact;
+
+        // Sections
+        ChainArray<double> mRestLength;
+        ChainArray<double> mIntact;
+        ChainArray<double> mTension;
+        ChainArray<char> mFlexible;
+        ChainArray<double> mMaxLength;
+        ChainArray<double> mMinLength;
+        ChainArray<char> mAdaptive;
+        std::vector<double> mCorrectionX;
+        std::vector<double> mCorrectionY;
+        std::vector<double> mCorrectionZ;
+
+        // Scratch arrays of the implicit solve, empty otherwise.
+        std::vector<double> mActive;
+        std::vector<double> mBias;
+        std::vector<double> mUpper;
+        std::vector<double> mLambda;
+        std::vector<double> mDiagonal;
+        std::vector<double> mCoupling;
+        std::vector<double> mLumpedInvMass;
+        std::vector<size_t> mPinnedNodes;
+    };
+}
+
+#endif // _CABLE_CHAIN_H
@@ -0,0 +1,88 @@
+#ifndef _CABLE_DEFINITION_LOADER_H
+#define _CABLE_DEFINITION_LOADER_H
+
+#include "SimBackend.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Sim
+{
+    // Reads a cable definition from a compact text file, so that cables can
+    // be set up without writing the definition code by hand.
+    //
+    // The file has one entry per line; '#' starts a comment:
+    //
+    //   name My crane cable
+    //   point winch CraneAssembly Winch
+    //   point pulley CraneAssembly MidPulley inverse
+    //   point ring jTest jTestPart axis 1 0 0
+    //   point attachment LoadAssembly Load offset 0 0 -0.5
+    //   span 2 flexible adaptive max 1.0 min 0.2
+    //   segment 6 flexible max 3.0 min 0.2 fixed collision 2
+    //   stiffness 10000
+    //   damping 2000
+    //   collision 2
+    //   max-tension 50000
+    //   density 1.0
+    //   radius 0.05
+    //   deployable-length 60
+    //   implicit
+    //
+    // Points are given in order with the names of their assembly and part.
+    // "span i" overrides the straight segment between points i and i+1;
+    // "segment n" uses the CableSystems numbering directly (see
+    // CableDefinition::getSpanSegmentIndex()); "adaptive" lets the native
+    // backend refine the sections where needed. "max-tension" enables the
+    // breakage, and "implicit" the implicit solve of the native backend;
+    // "deployable-length" sizes the native cable for the winch pay-out.
+    //
+    // The file is parsed once; resolve() then only looks up each assembly
+    // and part name once per scene, so one loader can set up the same cable
+    // in many scenes.
+    class CableDefinitionLoader
+    {
+    public:
+        // Constructor
+        //
+        CableDefinitionLoader();
+
+        // Read the file. Returns false and prints the error with its line
+        // number when the file cannot be read or an entry is malformed.
+        //
+        bool load(const std::string& iFileName);
+        bool parse(std::istream& iStream, const std::string& iSourceName);
+
+        // Name given in the file.
+        const std::string& getName() const { return mDefinition.name; }
+
+        size_t getPointCount() const { return mDefinition.points.size(); }
+
+        // Fill oDefinition with the part handles of iScene. The assemblies
+        // are searched in the mechanisms of iMechanisms, in order. Returns
+        // false when a name is not found.
+        //
+        bool resolve(const IScene& iScene, const std::vector<MechanismId>& iMechanisms, CableDefinition& oDefinition) const;
+
+    private:
+        // @internal helpers
+        bool _parseLine(std::istream& iLine, const std::string& iKeyword);
+        bool _parsePoint(std::istream& iLine);
+        bool _parseSegment(std::istream& iLine, size_t iIndex);
+
+    private:
+        // Definition without the part handles.
+        CableDefinition mDefinition;
+
+        // Names of the part of each point.
+        std::vector<std::string> mAssemblyNames;
+        std::vector<std::string> mPartNames;
+
+        // Segments given by "span": their index is the point index until
+        // the end of the file, when all the points are known.
+        std::vector<size_t> mSpanSegments;
+    };
+}
+
+#endif // _CABLE_DEFINITION_LOADER_H
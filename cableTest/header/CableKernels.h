@@ -0,0 +1,134 @@
+#ifndef _CABLE_KERNELS_H
+#define _CABLE_KERNELS_H
+
+#include <cstddef>
+
+// Select the instruction set of the cable kernels at compile time.
+// AVX2 is used when the compiler targets it (-mavx2, /arch:AVX2), SSE2 on
+// any x86-64 target, and the scalar code everywhere else or when
+// CABLE_KERNELS_SCALAR is defined.
+#if defined(CABLE_KERNELS_SCALAR)
+#elif defined(__AVX2__)
+#define CABLE_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CABLE_KERNELS_SSE2
+#endif
+
+namespace Sim
+{
+    // Vectorized kernels stepping the nodes and sections of a cable stored as
+    // structure of arrays. Section i links node i and node i+1, so a chain of
+    // n sections has n+1 nodes.
+    namespace CableKernels
+    {
+        // Raw view on the arrays of one chain.
+        struct Chain
+        {
+            size_t nodeCount;
+            double* x;
+            double* y;
+            double* z;
+            double* previousX;
+            double* previousY;
+            double* previousZ;
+            double* vx;
+            double* vy;
+            double* vz;
+            const double* invMass;
+
+            size_t sectionCount;
+            const double* restLength;
+            // 1 for the sections that can pull, 0 for the broken ones.
+            const double* intact;
+            double* tension;
+
+            // Scratch arrays of sectionCount elements.
+            double* correctionX;
+            double* correctionY;
+            double* correctionZ;
+
+            // Scratch arrays of sectionCount elements used by the implicit
+            // solve only, NULL otherwise.
+            double* active;
+            double* bias;
+            double* upper;
+            double* lambda;
+            double* diagonal;
+            double* coupling;
+
+            // Nodes moving with a part, for the implicit solve only: their
+            // invMass is 0 and their inverse mass is the symmetric matrix
+            // given by the 6 coefficients xx, xy, xz, yy, yz, zz at
+            // pinnedInvMass[6 * node].
+            size_t pinnedCount;
+            const size_t* pinnedNodes;
+            const double* pinnedInvMass;
+        };
+
+        // Raw view on the arrays of the section frames drawn by the
+        // renderers (see CableMeshBuilder). The nodes are given as for a
+        // chain, and section i goes from node i to node i+1.
+        struct SectionFrames
+        {
+            size_t sectionCount;
+            const double* x;
+            const double* y;
+            const double* z;
+
+            // Outputs of sectionCount elements: the center of the section,
+            // the rotation (w, x, y, z) taking the z axis along the section
+            // and the length of the section.
+            double* centerX;
+            double* centerY;
+            double* centerZ;
+            double* qw;
+            double* qx;
+            double* qy;
+            double* qz;
+            double* length;
+        };
+
+        // Name of the instruction set selected at compile time.
+        const char* getInstructionSet();
+
+        // Save the positions, apply the gravity and move the nodes with their velocities.
+        void predict(const Chain& chain, double h, double gx, double gy, double gz);
+
+        // One XPBD pass on the sections of parity iParity (0 for the even ones).
+        // The sections of the same parity share no node, so they are solved
+        // together; the tension of the solved sections is updated.
+        void solveSections(const Chain& chain, int iParity, double h, double iStiffness, double iDamping);
+
+        // One XPBD pass on all the sections at once: the corrections of the
+        // sections are coupled through their shared nodes, which gives a
+        // tridiagonal system solved directly in O(n). Sections that would
+        // push are taken out of the system and it is solved again. The
+        // corrections are the ones solveSections() converges to, so a stiff
+        // chain keeps its length whatever the substep. The pinned nodes are
+        // the boundary terms of the system: their matrix couples the
+        // sections around them whatever their directions, so that a node on
+        // a pulley or on a part that turns moves the way the part makes it.
+        // The first pass of a substep starts from zero multipliers; with
+        // iAccumulate, the pass relinearizes the constraints at the current
+        // positions and continues from the multipliers given by the tensions
+        // of the previous pass. The tensions of all the sections are
+        // updated, and the corrections of the pass are left in
+        // correctionX/Y/Z.
+        // A relinearized pass is skipped when the chain already satisfies
+        // the constraints: no section is off its length by more than
+        // iTolerance times its rest length. Returns false, with zero
+        // corrections, when nothing was solved.
+        bool solveSectionsImplicit(const Chain& chain, double h, double iStiffness, double iDamping, bool iAccumulate, double iTolerance);
+
+        // Derive the velocities from the displacement of the substep.
+        void updateVelocities(const Chain& chain, double h);
+
+        // Compute the frame of every section. The rotation is the shortest
+        // one from +z to the section, or from -z for the sections pointing
+        // down, followed by a half turn around x; either way it is well
+        // conditioned, and a section of zero length gets a valid rotation.
+        void computeSectionFrames(const SectionFrames& frames);
+    }
+}
+
+#endif // _CABLE_KERNELS_H
@@ -0,0 +1,96 @@
+#ifndef _CABLE_MESH_BUILDER_H
+#define _CABLE_MESH_BUILDER_H
+
+#include <cstddef>
+#include <vector>
+
+struct RenderSnapshot;
+
+// Geometry of the cables of a RenderSnapshot, in the two forms the
+// renderers draw:
+// - instances: the transform of every section, to draw a cylinder of unit
+//   radius and unit length along z, centered on the origin, scaled by the
+//   radius of the cable and the length of the section. This is the compact
+//   form written by SceneExporter.
+// - tubes: a triangle mesh around each cable, with a ring of vertices at
+//   every node. The ring of a node is the one of the previous node carried
+//   along the cable, so that the tube does not twist where the cable bends.
+//
+// The section frames are computed by CableKernels::computeSectionFrames
+// with vector instructions. The arrays keep their capacity from one frame to
+// the next, so a build allocates only when the cables have more nodes than
+// ever before, and the triangle indices are only rebuilt when the node
+// counts change.
+class CableMeshBuilder
+{
+public:
+    // Floats per instance: the center (x, y, z), the rotation (w, x, y, z)
+    // taking the z axis along the section, and the length of the section.
+    static const size_t kInstanceSize = 8;
+
+    // Constructor
+    // The rings of the tubes have iSideCount vertices, at least 3.
+    //
+    explicit CableMeshBuilder(size_t iSideCount = 8);
+
+    void buildInstances(const RenderSnapshot& iSnapshot);
+    void buildTubes(const RenderSnapshot& iSnapshot);
+
+    // Instances: one per section, those of cable i starting at
+    // getInstanceStart(i).
+    size_t getInstanceCount() const { return mInstances.size() / kInstanceSize; }
+    size_t getInstanceStart(size_t iCable) const { return mInstanceStarts[iCable]; }
+    const std::vector<float>& getInstances() const { return mInstances; }
+
+    // Tubes: the position and the normal of each vertex (3 floats each),
+    // and 3 vertex indices per triangle. The ring of the node at index j of
+    // RenderSnapshot::cableNodes is made of the getSideCount() vertices
+    // starting at getSideCount() * j.
+    size_t getSideCount() const { return mSideCount; }
+    size_t getVertexCount() const { return mPositions.size() / 3; }
+    const std::vector<float>& getPositions() const { return mPositions; }
+    const std::vector<float>& getNormals() const { return mNormals; }
+    const std::vector<unsigned int>& getIndices() const { return mIndices; }
+    // Changes whenever the indices are rebuilt, so that the renderers upload
+    // them again.
+    size_t getIndexRevision() const { return mIndexRevision; }
+
+private:
+    // @internal helpers
+    void _buildIndices(const RenderSnapshot& iSnapshot);
+
+    CableMeshBuilder(const CableMeshBuilder&);
+    CableMeshBuilder& operator=(const CableMeshBuilder&);
+
+private:
+    size_t mSideCount;
+    std::vector<double> mSideCosines;
+    std::vector<double> mSideSines;
+
+    // Nodes of all the cables as structure of arrays, and the frames of the
+    // sections between consecutive nodes; those going from the last node of
+    // a cable to the first node of the next one are not used.
+    std::vector<double> mX;
+    std::vector<double> mY;
+    std::vector<double> mZ;
+    std::vector<double> mCenterX;
+    std::vector<double> mCenterY;
+    std::vector<double> mCenterZ;
+    std::vector<double> mQw;
+    std::vector<double> mQx;
+    std::vector<double> mQy;
+    std::vector<double> mQz;
+    std::vector<double> mLength;
+
+    std::vector<size_t> mInstanceStarts;
+    std::vector<float> mInstances;
+
+    std::vector<float> mPositions;
+    std::vector<float> mNormals;
+    std::vector<unsigned int> mIndices;
+    // Node starts of the snapshot the indices were built for.
+    std::vector<size_t> mIndexedNodeStarts;
+    size_t mIndexRevision;
+};
+
+#endif // _CABLE_MESH_BUILDER_H
@@ -0,0 +1,104 @@
+#ifndef _CABLE_TELEMETRY_H
+#define _CABLE_TELEMETRY_H
+
+#include "SimBackend.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <vector>
+
+namespace Sim
+{
+    class NativeScene;
+}
+
+// Publishes the tension and strain of every cable section of a
+// Sim::NativeScene at every step, with the breakage events, for a
+// monitoring thread.
+//
+// publish() is called by the simulation thread after each step and writes
+// one frame per cable in a SpscRing; the breaks go in a second ring so
+// that they are not lost with the frames. The frames are allocated up
+// front with room for a maximum number of sections, so publishing never
+// locks, and only allocates the per cable state on its first call. The
+// sections beyond the maximum are left out, and when a ring is full the
+// frame or event is dropped and counted. The monitoring thread drains the
+// rings with pop() and popBreak() without ever blocking the simulation.
+class CableTelemetry
+{
+public:
+    struct Settings
+    {
+        Settings();
+
+        // Sections stored per frame.
+        size_t maxSectionCount;
+        // Frames in the ring, rounded up to a power of two. The ring of
+        // breaks has the same capacity.
+        size_t capacity;
+    };
+
+    struct Section
+    {
+        float tension;
+        // (length - rest length) / rest length
+        float strain;
+        bool broken;
+    };
+
+    struct Frame
+    {
+        size_t step;
+        double time;
+        Sim::CableId cable;
+        bool broken;
+        // Sections of the cable; only the first sections.size() are stored.
+        size_t sectionCount;
+        // Over all the sections, stored or not.
+        double maxTension;
+        size_t maxTensionSection;
+        std::vector<Section> sections;
+    };
+
+    struct Break
+    {
+        size_t step;
+        double time;
+        Sim::CableId cable;
+        size_t section;
+        // Tension that broke the section.
+        double tension;
+    };
+
+    // Constructor
+    //
+    explicit CableTelemetry(const Settings& iSettings = Settings());
+
+    // Producer side, called by the simulation thread after each step. The
+    // cables of iScene must not change once publishing started.
+    void publish(const Sim::NativeScene& iScene);
+
+    // Consumer side. Return false when the ring is empty. The sections of
+    // oFrame are copied in its own vector, which keeps its capacity from
+    // one frame to the next.
+    bool pop(Frame& oFrame);
+    bool popBreak(Break& oBreak);
+
+    size_t getPublishedCount() const { return mPublishedCount; }
+    size_t getDroppedCount() const { return mFrames.getDroppedCount(); }
+    size_t getDroppedBreakCount() const { return mBreaks.getDroppedCount(); }
+    // Frames published without all their sections.
+    size_t getTruncatedCount() const { return mTruncatedCount.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing<Frame> mFrames;
+    SpscRing<Break> mBreaks;
+    std::atomic<size_t> mTruncatedCount;
+
+    // Producer state
+    size_t mPublishedCount;
+    // Breaks of the chain already reported, per cable.
+    std::vector<size_t> mReportedBreakCounts;
+};
+
+#endif // _CABLE_TELEMETRY_H
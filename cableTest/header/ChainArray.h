@@ -0,0 +1,163 @@
+#ifndef _CHAIN_ARRAY_H
+#define _CHAIN_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Sim
+{
+    // Contiguous array of the nodes or of the sections of a CableChain, with
+    // free room on both sides of the elements.
+    //
+    // A cable changes near its ends: the winch pays out and reels in at the
+    // first section, and the length sliding through the last pulley splits
+    // and merges the sections near the load. Inserting or erasing an element
+    // moves the elements on its shorter side, into the room on that side, so
+    // that these changes cost the distance to the nearest end rather than the
+    // length of the cable. When that side has no room left, the elements are
+    // moved once to share the room again, most of it in front, for the winch.
+    //
+    // The elements stay contiguous for the kernels, and the array only
+    // reallocates when its capacity is set or when it is full.
+    template <class T>
+    class ChainArray
+    {
+    public:
+        ChainArray() : mBuffer(), mBegin(0), mEnd(0) {}
+
+        size_t size() const { return mEnd - mBegin; }
+        bool empty() const { return mEnd == mBegin; }
+        size_t capacity() const { return mBuffer.size(); }
+        size_t getMemoryUsage() const { return mBuffer.capacity() * sizeof(T); }
+
+        T& operator[](size_t i) { return mBuffer.data()[mBegin + i]; }
+        const T& operator[](size_t i) const { return mBuffer.data()[mBegin + i]; }
+        T* begin() { return mBuffer.data() + mBegin; }
+        T* end() { return mBuffer.data() + mEnd; }
+        const T* begin() const { return mBuffer.data() + mBegin; }
+        const T* end() const { return mBuffer.data() + mEnd; }
+
+        // Reallocate with room for iCapacity elements, at least the current
+        // ones, and share the room.
+        void setCapacity(size_t iCapacity)
+        {
+            const size_t count = size();
+            std::vector<T> buffer(std::max(iCapacity, count));
+            const size_t begin = _getBalancedBegin(buffer.size(), count);
+            std::copy(this->begin(), this->end(), buffer.begin() + begin);
+            mBuffer.swap(buffer);
+            mBegin = begin;
+            mEnd = begin + count;
+        }
+
+        // The elements added get iValue.
+        void resize(size_t iSize, const T& iValue = T())
+        {
+            if ( iSize > capacity() )
+            {
+                setCapacity(iSize);
+            }
+            if ( mBegin + iSize > capacity() )
+            {
+                _moveTo(capacity() - iSize);
+            }
+            if ( iSize > size() )
+            {
+                std::fill(end(), begin() + iSize, iValue);
+            }
+            mEnd = mBegin + iSize;
+        }
+
+        void push_back(const T& iValue)
+        {
+            insert(size(), iValue);
+        }
+
+        // Insert iValue before the element at iIndex.
+        void insert(size_t iIndex, const T& iValue)
+        {
+            // iValue may be an element of the array.
+            const T value = iValue;
+            const size_t count = size();
+            if ( count == capacity() )
+            {
+                setCapacity(count + count / 2 + 1);
+            }
+
+            bool front = iIndex < count - iIndex;
+            if ( (front && 0 == mBegin) || (!front && capacity() == mEnd) )
+            {
+                _moveTo(_getBalancedBegin(capacity(), count));
+                // There is no room behind when the room is small.
+                front = front || capacity() == mEnd;
+            }
+
+            if ( front )
+            {
+                std::copy(begin(), begin() + iIndex, begin() - 1);
+                --mBegin;
+            }
+            else
+            {
+                std::copy_backward(begin() + iIndex, end(), end() + 1);
+                ++mEnd;
+            }
+            (*this)[iIndex] = value;
+        }
+
+        void erase(size_t iIndex)
+        {
+            if ( iIndex < size() - 1 - iIndex )
+            {
+                std::copy_backward(begin(), begin() + iIndex, begin() + iIndex + 1);
+                ++mBegin;
+            }
+            else
+            {
+                std::copy(begin() + iIndex + 1, end(), begin() + iIndex);
+                --mEnd;
+            }
+        }
+
+        void swap(ChainArray& ioOther)
+        {
+            mBuffer.swap(ioOther.mBuffer);
+            std::swap(mBegin, ioOther.mBegin);
+            std::swap(mEnd, ioOther.mEnd);
+        }
+
+    private:
+        // @internal helpers
+
+        // Three quarters of the room in front.
+        static size_t _getBalancedBegin(size_t iCapacity, size_t iCount)
+        {
+            const size_t room = iCapacity - iCount;
+            return room - room / 4;
+        }
+
+        void _moveTo(size_t iBegin)
+        {
+            T* buffer = mBuffer.data();
+            if ( iBegin < mBegin )
+            {
+                std::copy(begin(), end(), buffer + iBegin);
+            }
+            else if ( iBegin > mBegin )
+            {
+                std::copy_backward(begin(), end(), buffer + iBegin + size());
+            }
+            mEnd = iBegin + size();
+            mBegin = iBegin;
+        }
+
+    private:
+        std::vector<T> mBuffer;
+        // Range of the elements in the buffer.
+        size_t mBegin;
+        size_t mEnd;
+    };
+}
+
+#endif // _CHAIN_ARRAY_H
@@ -0,0 +1,70 @@
+#ifndef _CONTROL_LOG_H
+#define _CONTROL_LOG_H
+
+#include <string>
+#include <vector>
+
+// Forward Declaration
+class MyCrane;
+
+// Control inputs of the crane keyed by step index.
+//
+// The keyboard extension adds an event each time a key changes the speed
+// of a crane motor; the log is saved at the end of the run and replayed in
+// another run, headless or not, by applying the events at the same steps.
+// Runs replaying the same log do the same manoeuvre, so their step times
+// can be compared.
+//
+// The file is text, one event per line: "step time control speed", where
+// control is elongation, elevation or winch and time is informative.
+class ControlLog
+{
+public:
+    enum Control
+    {
+        kControlElongation,
+        kControlElevation,
+        kControlWinch
+    };
+
+    struct Event
+    {
+        size_t step;
+        double time;
+        Control control;
+        double speed;
+    };
+
+    // Constructor
+    //
+    ControlLog();
+
+    // Recording: the main loop sets the step before updating the
+    // application, and the keyboard adds the events of that step.
+    void setStep(size_t iStep, double iTime) { mStep = iStep; mTime = iTime; }
+    void add(Control iControl, double iSpeed);
+
+    size_t getEventCount() const { return mEvents.size(); }
+    const Event& getEvent(size_t iEvent) const { return mEvents[iEvent]; }
+
+    // Returns false and prints the reason if the file cannot be written or
+    // read, or if an event is malformed or out of order.
+    bool save(const std::string& iFileName) const;
+    bool load(const std::string& iFileName);
+
+    // Replay: apply to iCrane the events recorded at iStep. Called once per
+    // step, with increasing steps, before the step is done.
+    //
+    void apply(size_t iStep, MyCrane& iCrane);
+
+    static const char* getControlName(Control iControl);
+
+private:
+    std::vector<Event> mEvents;
+    size_t mStep;
+    double mTime;
+    // Next event to replay.
+    size_t mNextEvent;
+};
+
+#endif // _CONTROL_LOG_H
@@ -0,0 +1,105 @@
+#ifndef _CRANE_CONTROLLER_H
+#define _CRANE_CONTROLLER_H
+
+#include "SimBackend.h"
+
+#include <string>
+#include <vector>
+
+// Forward Declaration
+class MyCrane;
+
+// Velocity of one motor as a function of time, linear between setpoints.
+//
+// Before the first setpoint the velocity is the one of the first setpoint,
+// after the last one it is the one of the last setpoint. Evaluations at
+// increasing times, which is how the simulation uses the profile, walk the
+// setpoints with a cursor and cost O(1) each.
+class VelocityProfile
+{
+public:
+    struct Setpoint
+    {
+        double time;
+        double velocity;
+    };
+
+    // Constructor
+    //
+    VelocityProfile();
+
+    bool isEmpty() const { return mSetpoints.empty(); }
+    size_t getSetpointCount() const { return mSetpoints.size(); }
+    double getEndTime() const { return mSetpoints.empty() ? 0.0 : mSetpoints.back().time; }
+
+    // Append setpoints; their times must not go back. Returns false, and
+    // adds nothing, when they do.
+    //
+    bool add(double iTime, double iVelocity);
+    bool add(const Setpoint* iSetpoints, size_t iCount);
+
+    // Append a move of iDistance (signed) starting at rest at iStartTime:
+    // the velocity ramps up at iAcceleration to iMaxVelocity, cruises and
+    // ramps down to rest. Short moves never reach iMaxVelocity and get a
+    // triangular profile.
+    //
+    bool addTrapezoid(double iStartTime, double iDistance, double iMaxVelocity, double iAcceleration);
+
+    void clear();
+
+    double evaluate(double iTime);
+
+private:
+    std::vector<Setpoint> mSetpoints;
+    // Index of the first setpoint after the last evaluated time.
+    size_t mCursor;
+};
+
+// Drives the three motors of a MyCrane from velocity profiles.
+//
+// On the native backend the controller is called at every substep, inside
+// NativeScene::step(), so profiles sampled faster than the step rate (1 kHz
+// setpoints with 60 Hz steps) are followed at the substep rate. On Vortex,
+// apply() is called before each application update.
+//
+// Profiles can be loaded from a text file, one entry per line:
+//
+//   <motor> <time> <velocity>                            setpoint
+//   trapezoid <motor> <start> <distance> <vmax> <acc>    trapezoidal move
+//
+// where motor is elongation, elevation or winch; '#' starts a comment.
+class CraneController : public Sim::ISubstepCallback
+{
+public:
+    enum Motor
+    {
+        kMotorElongation,
+        kMotorElevation,
+        kMotorWinch,
+        kMotorCount
+    };
+
+    // Constructor
+    //
+    explicit CraneController(MyCrane& iCrane);
+
+    VelocityProfile& getProfile(Motor iMotor) { return mProfiles[iMotor]; }
+
+    // Returns false and prints the reason if the file cannot be read or an
+    // entry is malformed.
+    bool load(const std::string& iFileName);
+
+    // Set the speed of the motors with a profile to their value at iTime.
+    //
+    void apply(double iTime);
+
+    // Sim::ISubstepCallback; the motors are set to the velocity at the
+    // middle of the substep.
+    virtual void preSubstep(double iTime, double h);
+
+private:
+    MyCrane& mCrane;
+    VelocityProfile mProfiles[kMotorCount];
+};
+
+#endif // _CRANE_CONTROLLER_H
@@ -1,64 +1,104 @@
 #ifndef _EX_CABLE_SYSTEM_H
 #define _EX_CABLE_SYSTEM_H
 
-#include <VxSim/VxScene.h>
-
-#include <Vx/VxSmartPtr.h>
+#include "SimBackend.h"
 
 // Forward Declaration
 class MyCrane;
-
-namespace Vx
+namespace Sim
 {
-    class VxHinge;
-    class VxPart;
+    class CableDefinitionLoader;
 }
 
 // Module tutorial setup class to be used with the MechanismViewer.
 // The module creates the scene used to populate the tutorial.
 // This is equivalent to load a VXS scene from file.
+//
+// The scene is built through Sim::IScene, so it can be created either in
+// Vortex (Sim::VortexScene) or in the native reference backend (Sim::NativeScene).
 class ExCableSystem
 {
 public:
 
+    // Values of the tutorial that batch runs can change.
+    struct Settings
+    {
+        Settings();
+
+        // Mass of the load in kg.
+        double loadMass;
+
+        // When set, the cable is created from its definition instead of the
+        // one of the tutorial. The loader is only used by the constructor,
+        // which does not keep it.
+        const Sim::CableDefinitionLoader* cableLoader;
+
+        // When positive, override the values of the cable definition.
+        // maxSectionLength applies to the flexible segments, and maxTension
+        // enables the breakage.
+        double axialStiffness;
+        double axialDamping;
+        double maxSectionLength;
+        double maxTension;
+
+        // Refine and coarsen the sections of the flexible segments at run
+        // time (native backend only).
+        bool adaptiveSections;
+
+        // Solve the sections of the cable together, for stiff cables with
+        // large steps (native backend only).
+        bool implicitCables;
+    };
+
     // Constructor
+    // The crane, load, ground and cable system are created in iScene.
     //
-    ExCableSystem();
+    explicit ExCableSystem(Sim::IScene& iScene, const Settings& iSettings = Settings());
 
     // Destructor
     //
     virtual ~ExCableSystem();
 
-    // Called to get the scene
+    // Called to get the crane to control it
+    //
+    MyCrane* getCrane() { return mCrane; }
+
+    // Called to get the cable system of the crane
     //
-    VxSim::VxScene* getScene();
+    Sim::CableId getCable() const { return mCable; }
 
 private:
     // @internal helpers
-    VxSim::VxScene* _createScene();
-    VxSim::VxMechanism* _createCrane();
-    VxSim::VxMechanism* _createLoad();
-    VxSim::VxMechanism* _createGround();
+    void _createScene();
+    Sim::MechanismId _createLoad();
+    Sim::MechanismId _createGround();
 
-    Vx::VxAssembly* _createLoadAssembly();
-    Vx::VxAssembly* _createGroundAssembly();
+    Sim::AssemblyId _createLoadAssembly(Sim::MechanismId iMechanism);
+    Sim::AssemblyId _createGroundAssembly(Sim::MechanismId iMechanism);
 
-    Vx::VxAssembly* _getLoadAssembly();
+    Sim::AssemblyId _getLoadAssembly();
 
-    void _createCableSystemForCrane();
+    Sim::CableId _createCableSystemForCrane();
+    void _applySettings(Sim::CableDefinition& definition) const;
 
 private:
 
-	Vx::VxPart* _jTestPart;
+	Sim::MechanismId _jTestMechanism;
+	Sim::PartId _jTestPart;
 
     // My reference to the scene
-    Vx::VxSmartPtr<VxSim::VxScene> mScene;
+    Sim::IScene& mScene;
+
+    Settings mSettings;
 
     // Pointers to the concrete (objects) in order to modify their behavior during onPreUpdate()
     MyCrane* mCrane;
 
     // The load is another mechanism to be able to have collision between the crane and the load
-    Vx::VxSmartPtr<VxSim::VxMechanism> mLoadMechanism;
+    Sim::MechanismId mLoadMechanism;
+
+    // The cable system going from the winch to the load.
+    Sim::CableId mCable;
 };
 
 #endif // _EX_CABLE_SYSTEM_H
@@ -0,0 +1,83 @@
+#ifndef _FIXED_RATE_SCHEDULER_H
+#define _FIXED_RATE_SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+
+// Paces the steps of a simulation at a fixed rate of wall time.
+//
+// The main loop asks waitForSteps() how many steps to run, runs them and
+// calls endFrame(). When the simulation is ahead, waitForSteps() sleeps
+// until the next step is due and returns 1. When a frame ran long, the
+// steps that became due are returned together so that the simulated time
+// catches up with the wall time, up to a budget of steps per frame: beyond
+// it the simulation cannot catch up, the excess steps are dropped (the
+// simulated time falls behind for good) and the schedule restarts from the
+// current time, rather than running ever longer frames.
+//
+// Every step covers the same simulated time, so a stiff cable stays as
+// stable as in an unpaced run whatever the load of the machine.
+class FixedRateScheduler
+{
+public:
+    struct Settings
+    {
+        Settings();
+
+        // Steps per second of wall time.
+        double stepRate;
+        // Most steps run by one frame to catch up.
+        size_t maxCatchUpSteps;
+    };
+
+    // Constructor
+    //
+    explicit FixedRateScheduler(const Settings& iSettings = Settings());
+
+    // Start the schedule now; the first step is due immediately.
+    //
+    void start();
+
+    // Wait for the next step to be due and return the number of steps to run.
+    //
+    size_t waitForSteps();
+
+    // Called once the steps returned by waitForSteps() are done.
+    //
+    void endFrame();
+
+    size_t getFrameCount() const { return mFrameCount; }
+    size_t getStepCount() const { return mStepCount; }
+    // Frames that had to run more than one step.
+    size_t getCatchUpFrameCount() const { return mCatchUpFrameCount; }
+    // Frames whose steps took longer than the wall time they cover.
+    size_t getOverrunCount() const { return mOverrunCount; }
+    // Steps given up because the catch up budget was exceeded.
+    size_t getDroppedStepCount() const { return mDroppedStepCount; }
+    // Longest delay between the time a step was due and the time it started.
+    double getMaxLag() const { return mMaxLag; }
+
+    // Print the counters on the standard output.
+    //
+    void printReport() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Settings mSettings;
+    Clock::duration mPeriod;
+    Clock::time_point mStart;
+    Clock::time_point mFrameStart;
+    // Steps scheduled since mStart, the next one is due at mStart + mScheduled * mPeriod.
+    size_t mScheduled;
+    size_t mFrameSteps;
+
+    size_t mFrameCount;
+    size_t mStepCount;
+    size_t mCatchUpFrameCount;
+    size_t mOverrunCount;
+    size_t mDroppedStepCount;
+    double mMaxLag;
+};
+
+#endif // _FIXED_RATE_SCHEDULER_H
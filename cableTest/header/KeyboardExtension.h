@@ -1,6 +1,7 @@
 #ifndef _KEYBOARD_EXTENSION_H
 #define _KEYBOARD_EXTENSION_H
 
+#include "ControlLog.h"
 #include "MyCrane.h"
 #include <VxSim/IKeyboard.h>
 #include <VxSim/IExtension.h>
@@ -30,11 +31,21 @@ public:
     //
     void setCrane(MyCrane * iCrane);
 
+    // Record the speed changes in iLog; NULL to stop recording.
+    // The log is not owned by the extension.
+    //
+    void setControlLog(ControlLog * iLog);
+
 private:
+    // Set the speed of a crane motor and record it.
+    void _setSpeed(ControlLog::Control iControl, Vx::VxReal iSpeed);
+
 
     // This is the crane to be controlled by this extension.
     MyCrane * mCrane;
 
+    ControlLog * mControlLog;
+
     Vx::VxReal mInc;
 };
 
@@ -1,55 +1,39 @@
 #ifndef _MY_CRANE_H
 #define _MY_CRANE_H
 
-#include <VxSim/VxExtension.h>
+#include "SimBackend.h"
 
 #include <string>
 
-namespace Vx
-{
-    class VxAssembly;
-    class VxHinge;
-    class VxPart;
-    class VxPrismatic;
-}
-
-namespace VxSim
-{
-    class VxMechanism;
-}
-
 class MyCrane
 {
 public:
     ~MyCrane();
-    MyCrane();
+    explicit MyCrane(Sim::IScene& iScene, const Sim::Vec3& iOrigin = Sim::Vec3());
 
-    VxSim::VxMechanism* getMechanism() { return mMechanism.get(); }
+    Sim::MechanismId getMechanism() const { return mMechanism; }
 
-    void setElevationSpeed(Vx::VxReal iSpeed);
-    void setElongationSpeed(Vx::VxReal iSpeed);
-    void setWinchSpeed(Vx::VxReal iSpeed);
+    void setElevationSpeed(double iSpeed);
+    void setElongationSpeed(double iSpeed);
+    void setWinchSpeed(double iSpeed);
 
 private:
-    VxSim::VxMechanism* createMechanism();
+    Sim::MechanismId createMechanism();
 
-    Vx::VxAssembly* getAssembly();
-    Vx::VxAssembly* createAssembly();
+    Sim::AssemblyId getAssembly();
+    Sim::AssemblyId createAssembly(Sim::MechanismId iMechanism);
 
     // @internal
     // Functions to create the different parts of the crane.
-    Vx::VxPart* createBase();
-    Vx::VxPart* createWinch();
-    Vx::VxPart* createLowerBoom();
-    Vx::VxPart* createUpperBoom();
-    Vx::VxPart* createMidPulley();
-    Vx::VxPart* createTipPulley();
+    Sim::PartId createBase(Sim::AssemblyId iAssembly);
+    Sim::PartId createWinch(Sim::AssemblyId iAssembly);
+    Sim::PartId createLowerBoom(Sim::AssemblyId iAssembly);
+    Sim::PartId createUpperBoom(Sim::AssemblyId iAssembly);
+    Sim::PartId createMidPulley(Sim::AssemblyId iAssembly);
+    Sim::PartId createTipPulley(Sim::AssemblyId iAssembly);
 
     void createConstraints();
 
-
-    VxSim::VxExtension* createKeyboardExtension();
-
 public:
     static const std::string sCraneAssemblyName;
     static const std::string sWinchName;
@@ -57,20 +41,23 @@ public:
     static const std::string sTipPulleyName;
 
 private:
+    // The scene in which the crane is built.
+    Sim::IScene& mScene;
+
+    // Translation of the whole crane in the scene.
+    Sim::Vec3 mOrigin;
+
     // References to the concrete (objects) in order to modify their behavior during onPreUpdate()
-    Vx::VxSmartPtr<VxSim::VxMechanism> mMechanism;
+    Sim::MechanismId mMechanism;
 
 
     // The constraint to link the parts together
     // It also is used to move the boom.
-    Vx::VxHinge*     mHingeForElevation;
-    Vx::VxPrismatic* mPrismaticForElongation;
+    Sim::ConstraintId mHingeForElevation;
+    Sim::ConstraintId mPrismaticForElongation;
 
     // It will also be used to winch the cable in and out.
-    Vx::VxHinge* mHingeForWinch;
-
-    // The crane moves by pressing keyboard keys.
-    Vx::VxSmartPtr<VxSim::VxExtension> mKeyboard;
+    Sim::ConstraintId mHingeForWinch;
 };
 
 #endif
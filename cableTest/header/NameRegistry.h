@@ -0,0 +1,62 @@
+#ifndef _NAME_REGISTRY_H
+#define _NAME_REGISTRY_H
+
+#include "SceneArena.h"
+#include "SimBackend.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Sim
+{
+    // Index of the objects of a scene by name within a scope, the parts of
+    // an assembly or the assemblies of a mechanism for instance.
+    //
+    // The scenes keep one registry per kind of object and add each object
+    // when they create it, so a lookup by name is a hash lookup instead of a
+    // scan comparing the name of every object of the scene. The scopes are
+    // the handles of the scene, small indices, so each one has its own table.
+    class NameRegistry
+    {
+    public:
+        // Constructor
+        // The tables are allocated in iArena, or on the heap without arena.
+        //
+        explicit NameRegistry(SceneArena* iArena = NULL);
+
+        // Register iId under iName in iScope. When the name is already
+        // taken in the scope, the first object keeps it, as a scan in
+        // creation order would find it, and false is returned.
+        //
+        bool add(int iScope, const std::string& iName, int iId);
+
+        // Unregister the object of iScope named iName. Returns false when
+        // there is none.
+        //
+        bool remove(int iScope, const std::string& iName);
+
+        // The id registered under iName in iScope, or kInvalidId.
+        //
+        int find(int iScope, const std::string& iName) const;
+
+        // Number of registered objects.
+        size_t getCount() const { return mCount; }
+
+        // Approximate bytes of the tables: their buckets and entries.
+        size_t getMemoryUsage() const;
+
+        void clear();
+
+    private:
+        typedef ArenaAllocator< std::pair<const std::string, int> > TableAllocator;
+        typedef std::unordered_map<std::string, int, std::hash<std::string>, std::equal_to<std::string>, TableAllocator> Table;
+        SceneArena* mArena;
+        std::vector<Table> mScopes;
+        size_t mCount;
+    };
+}
+
+#endif // _NAME_REGISTRY_H
@@ -0,0 +1,248 @@
+#ifndef _NATIVE_MATH_H
+#define _NATIVE_MATH_H
+
+#include "SimBackend.h"
+
+#include <algorithm>
+
+// Small math helpers used by the native reference backend.
+namespace Sim
+{
+    struct Quat
+    {
+        Quat() : w(1.0), x(0.0), y(0.0), z(0.0) {}
+        Quat(double iW, double iX, double iY, double iZ) : w(iW), x(iX), y(iY), z(iZ) {}
+
+        // Rotation of iAngle around the unit vector iAxis.
+        static Quat fromAxisAngle(const Vec3& iAxis, double iAngle)
+        {
+            const double s = std::sin(0.5 * iAngle);
+            return Quat(std::cos(0.5 * iAngle), iAxis.x * s, iAxis.y * s, iAxis.z * s);
+        }
+
+        // XYZ counter-clockwise rotating Euler angles, see Sim::Pose.
+        static Quat fromEuler(const Vec3& iEuler)
+        {
+            return fromAxisAngle(Vec3(1.0, 0.0, 0.0), iEuler.x)
+                * fromAxisAngle(Vec3(0.0, 1.0, 0.0), iEuler.y)
+                * fromAxisAngle(Vec3(0.0, 0.0, 1.0), iEuler.z);
+        }
+
+        Quat operator*(const Quat& q) const
+        {
+            return Quat(w * q.w - x * q.x - y * q.y - z * q.z,
+                        w * q.x + x * q.w + y * q.z - z * q.y,
+                        w * q.y - x * q.z + y * q.w + z * q.x,
+                        w * q.z + x * q.y - y * q.x + z * q.w);
+        }
+
+        Quat conjugate() const { return Quat(w, -x, -y, -z); }
+        Vec3 vec() const { return Vec3(x, y, z); }
+
+        void normalize()
+        {
+            const double n = std::sqrt(w * w + x * x + y * y + z * z);
+            if ( n > 0.0 )
+            {
+                w /= n; x /= n; y /= n; z /= n;
+            }
+        }
+
+        Vec3 rotate(const Vec3& v) const
+        {
+            // v' = v + 2w(u x v) + 2u x (u x v)
+            const Vec3 u(x, y, z);
+            const Vec3 t = cross(u, v) * 2.0;
+            return v + t * w + cross(u, t);
+        }
+
+        Vec3 inverseRotate(const Vec3& v) const { return conjugate().rotate(v); }
+
+        // Add the small rotation iRotation (axis times angle, world frame).
+        void integrate(const Vec3& iRotation)
+        {
+            const Quat dq = Quat(0.0, iRotation.x, iRotation.y, iRotation.z) * (*this);
+            w += 0.5 * dq.w; x += 0.5 * dq.x; y += 0.5 * dq.y; z += 0.5 * dq.z;
+            normalize();
+        }
+
+        double w, x, y, z;
+    };
+
+    // 3x3 matrix stored row major.
+    struct Mat3
+    {
+        Mat3() { setZero(); }
+
+        static Mat3 identity()
+        {
+            Mat3 m;
+            m.a[0][0] = m.a[1][1] = m.a[2][2] = 1.0;
+            return m;
+        }
+
+        static Mat3 diagonal(const Vec3& d)
+        {
+            Mat3 m;
+            m.a[0][0] = d.x; m.a[1][1] = d.y; m.a[2][2] = d.z;
+            return m;
+        }
+
+        static Mat3 fromQuat(const Quat& q)
+        {
+            Mat3 m;
+            const Vec3 cx = q.rotate(Vec3(1.0, 0.0, 0.0));
+            const Vec3 cy = q.rotate(Vec3(0.0, 1.0, 0.0));
+            const Vec3 cz = q.rotate(Vec3(0.0, 0.0, 1.0));
+            for (int i=0; i<3; ++i)
+            {
+                m.a[i][0] = cx[i]; m.a[i][1] = cy[i]; m.a[i][2] = cz[i];
+            }
+            return m;
+        }
+
+        void setZero()
+        {
+            for (int i=0; i<3; ++i)
+            {
+                a[i][0] = a[i][1] = a[i][2] = 0.0;
+            }
+        }
+
+        Vec3 operator*(const Vec3& v) const
+        {
+            return Vec3(a[0][0] * v.x + a[0][1] * v.y + a[0][2] * v.z,
+                        a[1][0] * v.x + a[1][1] * v.y + a[1][2] * v.z,
+                        a[2][0] * v.x + a[2][1] * v.y + a[2][2] * v.z);
+        }
+
+        Mat3 operator*(const Mat3& m) const
+        {
+            Mat3 r;
+            for (int i=0; i<3; ++i)
+            {
+                for (int j=0; j<3; ++j)
+                {
+                    r.a[i][j] = a[i][0] * m.a[0][j] + a[i][1] * m.a[1][j] + a[i][2] * m.a[2][j];
+                }
+            }
+            return r;
+        }
+
+        Mat3 operator+(const Mat3& m) const
+        {
+            Mat3 r;
+            for (int i=0; i<3; ++i)
+            {
+                for (int j=0; j<3; ++j)
+                {
+                    r.a[i][j] = a[i][j] + m.a[i][j];
+                }
+            }
+            return r;
+        }
+
+        Mat3 operator*(double s) const
+        {
+            Mat3 r;
+            for (int i=0; i<3; ++i)
+            {
+                for (int j=0; j<3; ++j)
+                {
+                    r.a[i][j] = a[i][j] * s;
+                }
+            }
+            return r;
+        }
+
+        Mat3 transpose() const
+        {
+            Mat3 r;
+            for (int i=0; i<3; ++i)
+            {
+                for (int j=0; j<3; ++j)
+                {
+                    r.a[i][j] = a[j][i];
+                }
+            }
+            return r;
+        }
+
+        // Returns the zero matrix when the matrix is singular.
+        Mat3 inverse() const
+        {
+            Mat3 r;
+            const double det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                             - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+            if ( std::fabs(det) < 1e-300 )
+            {
+                return r;
+            }
+            const double invDet = 1.0 / det;
+            r.a[0][0] =  (a[1][1] * a[2][2] - a[1][2] * a[2][1]) * invDet;
+            r.a[0][1] = -(a[0][1] * a[2][2] - a[0][2] * a[2][1]) * invDet;
+            r.a[0][2] =  (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * invDet;
+            r.a[1][0] = -(a[1][0] * a[2][2] - a[1][2] * a[2][0]) * invDet;
+            r.a[1][1] =  (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * invDet;
+            r.a[1][2] = -(a[0][0] * a[1][2] - a[0][2] * a[1][0]) * invDet;
+            r.a[2][0] =  (a[1][0] * a[2][1] - a[1][1] * a[2][0]) * invDet;
+            r.a[2][1] = -(a[0][0] * a[2][1] - a[0][1] * a[2][0]) * invDet;
+            r.a[2][2] =  (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * invDet;
+            return r;
+        }
+
+        double a[3][3];
+    };
+
+    // Axis aligned box; the default box is empty and contains nothing.
+    struct Aabb
+    {
+        Aabb() : min(1e300, 1e300, 1e300), max(-1e300, -1e300, -1e300) {}
+        Aabb(const Vec3& iMin, const Vec3& iMax) : min(iMin), max(iMax) {}
+
+        void add(const Vec3& p)
+        {
+            min = Vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+            max = Vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+        }
+
+        void add(const Aabb& b)
+        {
+            min = Vec3(std::min(min.x, b.min.x), std::min(min.y, b.min.y), std::min(min.z, b.min.z));
+            max = Vec3(std::max(max.x, b.max.x), std::max(max.y, b.max.y), std::max(max.z, b.max.z));
+        }
+
+        void inflate(double d)
+        {
+            min -= Vec3(d, d, d);
+            max += Vec3(d, d, d);
+        }
+
+        bool isEmpty() const { return min.x > max.x; }
+
+        bool overlaps(const Aabb& b) const
+        {
+            return min.x <= b.max.x && b.min.x <= max.x
+                && min.y <= b.max.y && b.min.y <= max.y
+                && min.z <= b.max.z && b.min.z <= max.z;
+        }
+
+        bool contains(const Aabb& b) const
+        {
+            return min.x <= b.min.x && min.y <= b.min.y && min.z <= b.min.z
+                && b.max.x <= max.x && b.max.y <= max.y && b.max.z <= max.z;
+        }
+
+        bool operator==(const Aabb& b) const
+        {
+            return min.x == b.min.x && min.y == b.min.y && min.z == b.min.z
+                && max.x == b.max.x && max.y == b.max.y && max.z == b.max.z;
+        }
+
+        Vec3 min;
+        Vec3 max;
+    };
+}
+
+#endif // _NATIVE_MATH_H
@@ -0,0 +1,424 @@
+#ifndef _NATIVE_SCENE_H
+#define _NATIVE_SCENE_H
+
+#include "CableBroadphase.h"
+#include "NameRegistry.h"
+#include "CableChain.h"
+#include "NativeMath.h"
+#include "SceneArena.h"
+#include "SimBackend.h"
+#include "StepProfiler.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+namespace Sim
+{
+    // Self-contained reference implementation of Sim::IScene.
+    //
+    // It has no dependency on Vortex and is meant to run the crane and cable
+    // scenes on Linux compute nodes. The dynamics use small-step position based
+    // dynamics (XPBD): every step is split in substeps, and each substep
+    // predicts the positions, projects the constraints once and derives the
+    // velocities from the corrected positions.
+    //
+    // Simplifications with respect to Vortex:
+    // - The center of mass of a part is at the origin of its frame, and the
+    //   mass of a part without an explicit mass is computed with a unit density.
+    // - Contacts are only generated between dynamic parts or cable nodes and
+    //   static or animated parts. Static cylinders are approximated by their box.
+    // - The cable passes through the center of winches, pulleys and rings,
+    //   moved by the offset of the point on winches and pulleys. It slides
+    //   without friction through pulleys and rings, and only the winch
+    //   changes its total length.
+    //
+    // The geometries of the parts and the tables of names are allocated in
+    // the arena of the scene (see SceneArena), freed with the scene.
+    //
+    // The scene is split in islands, the parts, constraints and cables that
+    // can act on each other: a crane with its cables and loads, or two cables
+    // that may touch. The static and animated parts belong to no island, the
+    // solve only reads them. Each substep solves the islands independently,
+    // on the workers of a ThreadPool when one is set.
+    class NativeScene : public IScene
+    {
+    public:
+        // Constructor
+        //
+        NativeScene();
+
+        // Destructor
+        //
+        virtual ~NativeScene();
+
+        // Advance the simulation by iTimeStep seconds.
+        //
+        void step(double iTimeStep);
+
+        double getTime() const { return mTime; }
+        size_t getStepCount() const { return mStepCount; }
+
+        void setGravity(const Vec3& iGravity) { mGravity = iGravity; }
+        const Vec3& getGravity() const { return mGravity; }
+
+        // Time the phases of every step in iProfiler; NULL to stop profiling.
+        // The profiler is not owned by the scene.
+        void setProfiler(StepProfiler* iProfiler) { mProfiler = iProfiler; }
+
+        // Called at the start of every substep, timed as the pre-update
+        // phase; NULL to remove. The callback is not owned by the scene.
+        void setSubstepCallback(ISubstepCallback* iCallback) { mSubstepCallback = iCallback; }
+
+        // Solve the islands on the workers of iPool, NULL to solve them one
+        // after the other on the calling thread. The pool is not owned by the
+        // scene. The islands share no state and each one is solved in the
+        // same order whatever the worker, so the results do not depend on
+        // the pool nor on its number of threads.
+        void setThreadPool(ThreadPool* iPool);
+
+        // Islands of the last substep, and how many times they were built.
+        size_t getIslandCount() const { return mIslands.size(); }
+        size_t getIslandBuildCount() const { return mIslandBuildCount; }
+
+        // Number of substeps done by step(). The default is 20.
+        void setSubstepCount(int iSubstepCount) { mSubstepCount = iSubstepCount > 0 ? iSubstepCount : 1; }
+        int getSubstepCount() const { return mSubstepCount; }
+
+        // Access to the state of the parts.
+        size_t getPartCount() const { return mBodies.size(); }
+        const std::string& getPartName(PartId iPart) const { return mBodies[iPart].name; }
+        PartControl getPartControl(PartId iPart) const { return mBodies[iPart].control; }
+        double getPartMass(PartId iPart) const { return mBodies[iPart].mass; }
+        const Quat& getPartOrientation(PartId iPart) const { return mBodies[iPart].orientation; }
+        const Vec3& getPartLinearVelocity(PartId iPart) const { return mBodies[iPart].linearVelocity; }
+        const Vec3& getPartAngularVelocity(PartId iPart) const { return mBodies[iPart].angularVelocity; }
+
+        // Access to the state of the cables.
+        size_t getCableCount() const { return mCables.size(); }
+        const CableChain& getCable(CableId iCable) const { return mCables[iCable].chain; }
+        const std::string& getCableName(CableId iCable) const { return mCables[iCable].chain.getDefinition().name; }
+        size_t getCableNodeCount(CableId iCable) const { return mCables[iCable].chain.getNodeCount(); }
+        Vec3 getCableNodePosition(CableId iCable, size_t iNode) const { return mCables[iCable].chain.getNodePosition(iNode); }
+        size_t getCableSectionCount(CableId iCable) const { return mCables[iCable].chain.getSectionCount(); }
+        double getCableSectionTension(CableId iCable, size_t iSection) const { return mCables[iCable].chain.getSectionTension(iSection); }
+        bool isCableBroken(CableId iCable) const { return mCables[iCable].chain.isBroken(); }
+        double getCableLength(CableId iCable) const { return mCables[iCable].chain.getLength(); }
+
+        // Current value of the free coordinate of a constraint: the angle of
+        // part1 relative to part2 for a hinge, the displacement of part1
+        // relative to part2 for a prismatic.
+        double getConstraintCoordinate(ConstraintId iConstraint) const { return mJoints[iConstraint].coordinate; }
+
+        // Checkpoint of the dynamic state: the time, the transforms and
+        // velocities of the parts, the motor and limit state of the
+        // constraints, the winch angles and the nodes and sections of the
+        // cables. Loading expects a scene built the same way, with the same
+        // parts, constraints and cables; only the state changes, so a
+        // settled scene is restored without running the settling steps.
+        // Both return false and print the reason on failure, and a failed
+        // load leaves the scene unchanged.
+        bool saveCheckpoint(const std::string& iFileName) const;
+        bool loadCheckpoint(const std::string& iFileName);
+
+        // IScene
+        virtual MechanismId createMechanism(const std::string& iName);
+        virtual AssemblyId createAssembly(MechanismId iMechanism, const std::string& iName);
+        virtual PartId createPart(AssemblyId iAssembly, const PartDefinition& iDefinition);
+        virtual void addBox(PartId iPart, const Vec3& iDimensions, const Pose& iRelative = Pose());
+        virtual void addCylinder(PartId iPart, double iRadius, double iHeight, const Pose& iRelative = Pose());
+        virtual void addPlane(PartId iPart);
+        virtual void setSelfCollision(AssemblyId iAssembly, bool iEnabled);
+        virtual ConstraintId createHinge(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis);
+        virtual ConstraintId createPrismatic(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis);
+        virtual void setConstraintControl(ConstraintId iConstraint, ConstraintControl iControl);
+        virtual void setMotorDesiredVelocity(ConstraintId iConstraint, double iVelocity);
+        virtual void setLimits(ConstraintId iConstraint, double iLower, double iUpper);
+        virtual CableId createCable(MechanismId iMechanism, const CableDefinition& iDefinition);
+        virtual AssemblyId findAssembly(MechanismId iMechanism, const std::string& iName) const;
+        virtual PartId findPart(AssemblyId iAssembly, const std::string& iName) const;
+        virtual CableId findCable(MechanismId iMechanism, const std::string& iName) const;
+        virtual Vec3 getPartPosition(PartId iPart) const;
+
+        enum GeometryType
+        {
+            kGeometryBox,
+            kGeometryCylinder,
+            kGeometryPlane
+        };
+
+        // Geometry of a part, placed in the frame of the part. The cylinders
+        // are along their local z axis.
+        struct Geometry
+        {
+            GeometryType type;
+            // Half extents of the box, or of the box bounding the cylinder.
+            Vec3 halfExtents;
+            double radius;
+            double height;
+            Vec3 position;
+            Quat orientation;
+        };
+
+        size_t getPartGeometryCount(PartId iPart) const { return mBodies[iPart].geometries.size(); }
+        const Geometry& getPartGeometry(PartId iPart, size_t iGeometry) const { return mBodies[iPart].geometries[iGeometry]; }
+
+        // Memory held by a kind of object: how many there are and their
+        // bytes, including the arrays they own.
+        struct MemoryUsage
+        {
+            MemoryUsage() : count(0), bytes(0) {}
+
+            void add(size_t iBytes) { ++count; bytes += iBytes; }
+
+            size_t count;
+            size_t bytes;
+        };
+
+        // The objects of a mechanism. The geometries include the contact
+        // samples of the parts, and the constraints are in the mechanism of
+        // their first part.
+        struct MechanismMemory
+        {
+            std::string name;
+            MemoryUsage parts;
+            MemoryUsage geometries;
+            MemoryUsage constraints;
+            MemoryUsage cables;
+        };
+
+        struct MemoryReport
+        {
+            MemoryReport();
+
+            size_t getTotalBytes() const;
+
+            std::vector<MechanismMemory> mechanisms;
+            // The names of the mechanisms and assemblies, and the tables
+            // finding the objects by name.
+            size_t nameBytes;
+            // Islands and scratch arrays of the solver.
+            size_t solverBytes;
+            // Blocks of the arena, bytes handed out and given back; the
+            // geometries and tables counted above live in them.
+            size_t arenaReservedBytes;
+            size_t arenaAllocatedBytes;
+            size_t arenaReleasedBytes;
+            size_t arenaBlockCount;
+        };
+
+        // Memory of the scene, by mechanism then by kind of object. The
+        // bytes of the arrays are their capacity; the containers of names
+        // are estimated.
+        //
+        void getMemoryReport(MemoryReport& oReport) const;
+
+    private:
+        typedef std::vector< Geometry, ArenaAllocator<Geometry> > GeometryArray;
+        typedef std::vector< Vec3, ArenaAllocator<Vec3> > SampleArray;
+
+        struct Body
+        {
+            // The geometries and samples are allocated in iArena.
+            explicit Body(SceneArena* iArena) : geometries(ArenaAllocator<Geometry>(iArena)), samples(ArenaAllocator<Vec3>(iArena)) {}
+
+            std::string name;
+            AssemblyId assembly;
+            PartControl control;
+            bool explicitMass;
+            double mass;
+            double invMass;
+            // Inverse inertia in the part frame.
+            Mat3 invInertia;
+            Vec3 position;
+            Quat orientation;
+            Vec3 linearVelocity;
+            Vec3 angularVelocity;
+            Vec3 previousPosition;
+            Quat previousOrientation;
+            GeometryArray geometries;
+            // Contact sample points in the part frame.
+            SampleArray samples;
+        };
+
+        enum JointType
+        {
+            kJointHinge,
+            kJointPrismatic
+        };
+
+        struct Joint
+        {
+            JointType type;
+            PartId part1;
+            PartId part2;
+            Vec3 localAnchor1;
+            Vec3 localAnchor2;
+            // The axis in the frame of each part.
+            Vec3 localAxis1;
+            Vec3 localAxis2;
+            // Orientation of part1 in the frame of part2 at creation.
+            Quat restRelative;
+            ConstraintControl control;
+            double desiredVelocity;
+            double motorTarget;
+            bool limitsActive;
+            double lower;
+            double upper;
+            // Continuous value of the coordinate, hinge angles are unwrapped.
+            double coordinate;
+        };
+
+        // Pairs of sections in contact candidates, kept from one substep to
+        // the next while no box of the broadphases moves.
+        struct SectionPair
+        {
+            CableId cable1;
+            size_t section1;
+            CableId cable2;
+            size_t section2;
+        };
+
+        // The dynamic parts, constraints and cables of an island are the
+        // ranges [begin, end) of mIslandParts, mIslandJoints and
+        // mIslandCables, in increasing order so that they are solved in the
+        // order of the scene.
+        struct Island
+        {
+            size_t partBegin;
+            size_t partEnd;
+            size_t jointBegin;
+            size_t jointEnd;
+            size_t cableBegin;
+            size_t cableEnd;
+            std::vector<SectionPair> sectionPairs;
+            // The pairs must be found again, the island being new.
+            bool sectionPairsDirty;
+        };
+
+        // Scratch arrays of a worker, kept to avoid allocating in the step.
+        struct Workspace
+        {
+            Workspace();
+
+            // For _solveCableImplicit(): the inverse mass matrices of the
+            // pinned nodes lumped with their part, and the share of the
+            // impulse of each pinned node that goes to its part.
+            std::vector<double> pinnedInvMass;
+            std::vector<Mat3> partShare;
+            // For _solveCableContacts().
+            std::vector<size_t> candidateSections;
+            std::vector<CableBroadphase::SectionPair> candidatePairs;
+            // Time spent in each phase by the islands solved on the worker,
+            // when profiling.
+            double phaseTimes[StepProfiler::kPhaseCount];
+        };
+
+        struct Cable
+        {
+            CableChain chain;
+            // Sections of the chain, for its contacts.
+            CableBroadphase broadphase;
+            MechanismId mechanism;
+            // Winch spooling; the winch is always the first point of the cable.
+            ConstraintId winchJoint;
+            double winchRadius;
+            double winchAngle;
+        };
+
+        // @internal helpers
+        void _updateMassProperties(PartId iPart);
+        void _addSample(PartId iPart, const Vec3& iLocal);
+        bool _canCollide(const Body& iBody1, const Body& iBody2) const;
+        Vec3 _getCablePointPosition(const CablePointDefinition& iPoint) const;
+
+        void _substep(double h);
+        void _updateIslands();
+        void _buildIslands();
+        size_t _findIslandRoot(size_t iElement);
+        void _mergeIslands(size_t iElement1, size_t iElement2);
+        size_t _getJointElement(const Joint& iJoint) const;
+        void _moveKinematicParts(double h);
+        void _solveIsland(Island& island, Workspace& workspace, double h);
+        void _integrate(const Island& iIsland, double h);
+        void _solveJoint(Joint& joint, double h);
+        void _solveContacts(Island& island, Workspace& workspace);
+        void _solveCableContacts(Island& island, Workspace& workspace);
+        bool _isSelfContactExcluded(const CableChain& iChain, size_t iSection1, size_t iSection2) const;
+        void _solveSectionContact(CableChain& chain1, size_t iSection1, CableChain& chain2, size_t iSection2, double iDistance);
+        Aabb _getGeometryBounds(const Body& iBody, const Geometry& iGeometry) const;
+        void _solveCables(const Island& iIsland, Workspace& workspace, double h);
+        void _solveCableImplicit(CableChain& chain, Workspace& workspace, double h);
+        void _updateVelocities(const Island& iIsland, double h);
+        void _updateWinches(const Island& iIsland);
+
+        // XPBD corrections between two parts, one of them may be static.
+        void _applyPositionalCorrection(PartId iPart1, PartId iPart2, const Vec3& iPoint1, const Vec3& iPoint2, const Vec3& iCorrection);
+        void _applyAngularCorrection(PartId iPart1, PartId iPart2, const Vec3& iRotation);
+        void _applyParticleCorrection(CableChain& chain, size_t iNode, PartId iPart, const Vec3& iPoint, const Vec3& iCorrection);
+        double _measureCoordinate(Joint& joint);
+        double _getGeneralizedInverseMass(const Body& iBody, const Vec3& iPoint, const Vec3& iNormal) const;
+        // Inverse mass matrix of a part at a point: the motion of the point
+        // for an impulse applied there.
+        Mat3 _getPointInverseMass(const Body& iBody, const Vec3& iPoint) const;
+        Vec3 _worldInvInertia(const Body& iBody, const Vec3& v) const;
+
+        // Penetration of a world point in a static geometry, returns false when outside.
+        bool _getPenetration(const Body& iBody, const Geometry& iGeometry, const Vec3& iPoint, double iRadius, Vec3& oNormal, double& oDepth) const;
+
+    private:
+        double mTime;
+        size_t mStepCount;
+        int mSubstepCount;
+        Vec3 mGravity;
+        StepProfiler* mProfiler;
+        ISubstepCallback* mSubstepCallback;
+
+        // Declared before the containers allocating in it, so that it is
+        // freed after them.
+        SceneArena mArena;
+
+        std::vector<std::string> mMechanisms;
+        std::vector<std::string> mAssemblyNames;
+        std::vector<MechanismId> mAssemblyMechanisms;
+        std::vector<bool> mAssemblySelfCollision;
+        std::vector<Body> mBodies;
+        std::vector<Joint> mJoints;
+        std::vector<Cable> mCables;
+
+        // Assemblies by mechanism, parts by assembly and cables by mechanism.
+        NameRegistry mAssemblyNameRegistry;
+        NameRegistry mPartNameRegistry;
+        NameRegistry mCableNameRegistry;
+
+        // Islands, rebuilt when parts, constraints or cables are created or
+        // when the pairs of cables that may touch change.
+        ThreadPool* mThreadPool;
+        std::vector<Island> mIslands;
+        bool mIslandsDirty;
+        size_t mIslandBuildCount;
+        // The static and animated parts, which belong to no island, and the
+        // box of their geometries in the substep.
+        std::vector<PartId> mKinematicParts;
+        std::vector<Aabb> mKinematicBounds;
+        // Pairs of cables whose broadphase bounds overlap, the islands were
+        // built with mIslandCablePairs; the other arrays are scratch.
+        std::vector< std::pair<CableId, CableId> > mIslandCablePairs;
+        std::vector< std::pair<CableId, CableId> > mTouchingCables;
+        std::vector<CableId> mSweptCables;
+        std::vector<PartId> mIslandParts;
+        std::vector<ConstraintId> mIslandJoints;
+        std::vector<CableId> mIslandCables;
+        // Union-find over the parts then the cables, the island of each
+        // root, and the island of each part, constraint and cable.
+        std::vector<size_t> mIslandParents;
+        std::vector<size_t> mIslandOfRoot;
+        std::vector<size_t> mIslandOfElement;
+        // One per worker of the pool, or one without pool.
+        std::vector<Workspace> mWorkspaces;
+    };
+}
+
+#endif // _NATIVE_SCENE_H
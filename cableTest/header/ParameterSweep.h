@@ -0,0 +1,113 @@
+#ifndef _PARAMETER_SWEEP_H
+#define _PARAMETER_SWEEP_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Forward Declaration
+class ThreadPool;
+namespace Sim
+{
+    class CableDefinitionLoader;
+}
+
+// Runs the crane lift of ExCableSystem on the native backend for every
+// point of a grid of parameters, and gathers the results in one table.
+//
+// Each point of the grid gets its own Sim::NativeScene, built, stepped and
+// destroyed by the worker of the ThreadPool running it, so the points run
+// concurrently without sharing any state. During the run the winch reels
+// the cable in at a constant speed, which lifts the load off the ground.
+class ParameterSweep
+{
+public:
+    // Values of each parameter; the grid is their cartesian product.
+    // Every axis holds the value of the tutorial by default, and a section
+    // length of 0 keeps the segments of the cable definition.
+    struct Grid
+    {
+        Grid();
+
+        size_t getPointCount() const;
+
+        std::vector<double> axialStiffness;
+        std::vector<double> axialDamping;
+        std::vector<double> maxSectionLength;
+        std::vector<double> loadMass;
+        std::vector<double> timeStep;
+    };
+
+    struct Point
+    {
+        double axialStiffness;
+        double axialDamping;
+        double maxSectionLength;
+        double loadMass;
+        double timeStep;
+    };
+
+    struct Result
+    {
+        Point point;
+        size_t stepCount;
+        // Largest section tension over the run.
+        double maxTension;
+        // Simulated time at which the cable broke, negative when it did not.
+        double breakTime;
+        double finalLength;
+        // Wall-clock duration of the steps in seconds.
+        double meanStepTime;
+        double p99StepTime;
+    };
+
+    // Constructor
+    // Every point runs for iSimulationTime seconds of simulated time.
+    //
+    ParameterSweep(const Grid& iGrid, double iSimulationTime);
+
+    // Speed of the winch motor during the run; negative reels the cable in.
+    void setWinchSpeed(double iSpeed) { mWinchSpeed = iSpeed; }
+
+    // Breakage tension of the cable; 0 keeps the cable definition.
+    void setMaxTension(double iTension) { mMaxTension = iTension; }
+
+    // Create the cable from a definition file instead of the tutorial one;
+    // the loader must outlive run().
+    void setCableLoader(const Sim::CableDefinitionLoader* iLoader) { mCableLoader = iLoader; }
+
+    // Parameters of the point at iIndex in [0, getPointCount()).
+    Point getPoint(size_t iIndex) const;
+    size_t getPointCount() const { return mGrid.getPointCount(); }
+
+    // Run all the points on iPool and wait for them.
+    //
+    void run(ThreadPool& iPool);
+
+    const std::vector<Result>& getResults() const { return mResults; }
+
+    // Write the results as CSV, one line per point. Returns false if the
+    // file cannot be written.
+    bool writeTable(const std::string& iFileName) const;
+
+    // Print the results on the standard output.
+    //
+    void printTable() const;
+
+private:
+    // @internal helpers
+    Result _runPoint(const Point& iPoint) const;
+    void _writeCsv(std::ostream& oStream) const;
+
+private:
+    Grid mGrid;
+    double mSimulationTime;
+    double mWinchSpeed;
+    double mMaxTension;
+    const Sim::CableDefinitionLoader* mCableLoader;
+
+    // One entry per point, in the order of getPoint().
+    std::vector<Result> mResults;
+};
+
+#endif // _PARAMETER_SWEEP_H
@@ -0,0 +1,70 @@
+#ifndef _PROFILER_EXTENSION_H
+#define _PROFILER_EXTENSION_H
+
+#include "StepProfiler.h"
+
+#include <VxSim/IDynamics.h>
+#include <VxSim/IExtension.h>
+#include <VxSim/VxFactoryKey.h>
+
+#include <VxData/Field.h>
+
+#include <Vx/VxParameter.h>
+
+#include <chrono>
+
+// Profiler extension class
+//
+// Splits each application->update() in phases with the dynamics callbacks:
+// - pre-update: from the start of the update to preStep(), the keyboard and
+//   the other extensions updated before the dynamics;
+// - constraint solve: from preStep() to postStep(), the Vortex dynamics step,
+//   which includes the collision detection and the CableSystems update since
+//   Vortex does not time them separately;
+// - graphics sync: from postStep() to the end of the update.
+// The native backend reports the collision and cable phases on their own.
+//
+// The times of the last step are published on the outputs, and every step
+// goes into the StepProfiler given with setProfiler().
+class ProfilerExtension : public VxSim::IExtension, public VxSim::IDynamics
+{
+public:
+    // Key used to register and create the extension.
+    static const VxSim::VxFactoryKey kFactoryKey;
+
+    // Destructor
+    virtual ~ProfilerExtension();
+
+    // Constructor
+    ProfilerExtension(VxSim::VxPluginExtension *iProxy);
+
+    // Called by the main loop around application->update().
+    //
+    void beginUpdate();
+    void endUpdate();
+
+    // Set the profiler receiving the steps; it is not owned by the extension.
+    //
+    void setProfiler(StepProfiler* iProfiler);
+
+    // IDynamics
+    virtual void preStep();
+    virtual void postStep();
+
+public:
+    // Outputs: time of each phase of the last step in seconds.
+    VxData::Field<Vx::VxReal> outputPreUpdateTime;
+    VxData::Field<Vx::VxReal> outputConstraintSolveTime;
+    VxData::Field<Vx::VxReal> outputGraphicsSyncTime;
+    VxData::Field<int> outputStepCount;
+
+private:
+    // Time since the last mark, and move the mark to now.
+    double _lap();
+
+    StepProfiler* mProfiler;
+
+    std::chrono::steady_clock::time_point mMark;
+};
+
+#endif // _PROFILER_EXTENSION_H
@@ -0,0 +1,46 @@
+#ifndef _RENDER_SNAPSHOT_H
+#define _RENDER_SNAPSHOT_H
+
+#include "NativeMath.h"
+
+#include <vector>
+
+namespace Sim
+{
+    class NativeScene;
+}
+
+// The state of a Sim::NativeScene needed to draw it: the transforms of the
+// parts, and the radius and node positions of the cables.
+//
+// The simulation thread captures a snapshot after a step and hands it to
+// the render thread through a TripleBuffer<RenderSnapshot>, so that the
+// render thread draws a consistent state at its own rate while the
+// simulation keeps stepping at its own. The nodes of all the cables are
+// stored in one array, the nodes of cable i starting at cableNodeStarts[i].
+struct RenderSnapshot
+{
+    // Constructor
+    //
+    RenderSnapshot();
+
+    // Copy the state of iScene. The arrays keep their capacity, so captures
+    // allocate only when the cables have more nodes than ever before.
+    //
+    void capture(const Sim::NativeScene& iScene);
+
+    size_t getCableCount() const { return cableNodeStarts.empty() ? 0 : cableNodeStarts.size() - 1; }
+    size_t getCableNodeCount(size_t iCable) const { return cableNodeStarts[iCable + 1] - cableNodeStarts[iCable]; }
+    const Sim::Vec3& getCableNode(size_t iCable, size_t iNode) const { return cableNodes[cableNodeStarts[iCable] + iNode]; }
+
+    size_t step;
+    double time;
+    std::vector<Sim::Vec3> partPositions;
+    std::vector<Sim::Quat> partOrientations;
+    std::vector<double> cableRadii;
+    // One more start than there are cables, the last one is the node count.
+    std::vector<size_t> cableNodeStarts;
+    std::vector<Sim::Vec3> cableNodes;
+};
+
+#endif // _RENDER_SNAPSHOT_H
@@ -0,0 +1,112 @@
+#ifndef _SCENE_ARENA_H
+#define _SCENE_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Sim
+{
+    // Memory of the small objects built with a scene, freed in one shot
+    // with it.
+    //
+    // Building a scene creates many small arrays that live as long as the
+    // scene: the geometries and contact samples of every part, the tables
+    // finding the objects by name. The arena hands them out of large blocks
+    // by moving a pointer, and frees the blocks all together when it is
+    // destroyed, instead of going through the heap for each array. The
+    // memory given back by an array that grows is not reused, it is counted
+    // as released until the arena is freed.
+    //
+    // An arena is not thread-safe: the scenes are built on one thread.
+    class SceneArena
+    {
+    public:
+        // Constructor
+        // The blocks are iBlockSize bytes, or the size of an allocation
+        // when it is larger.
+        //
+        explicit SceneArena(size_t iBlockSize = 16 * 1024);
+
+        // Destructor
+        // Frees the blocks; everything allocated in the arena is gone.
+        //
+        ~SceneArena();
+
+        void* allocate(size_t iSize, size_t iAlignment);
+        void deallocate(void* iPointer, size_t iSize);
+
+        // Bytes of the blocks, bytes handed out, and bytes given back.
+        size_t getReservedBytes() const { return mReservedBytes; }
+        size_t getAllocatedBytes() const { return mAllocatedBytes; }
+        size_t getReleasedBytes() const { return mReleasedBytes; }
+        size_t getBlockCount() const { return mBlocks.size(); }
+
+    private:
+        SceneArena(const SceneArena&);
+        SceneArena& operator=(const SceneArena&);
+
+    private:
+        size_t mBlockSize;
+        std::vector<char*> mBlocks;
+        // Free range of the last block.
+        char* mNext;
+        char* mEnd;
+
+        size_t mReservedBytes;
+        size_t mAllocatedBytes;
+        size_t mReleasedBytes;
+    };
+
+    // Standard allocator drawing from a SceneArena, for the containers of
+    // the scene. Without arena it allocates on the heap, so containers
+    // built before the scene gives them its arena still work.
+    template <class T>
+    class ArenaAllocator
+    {
+    public:
+        typedef T value_type;
+        // Assigning a container gives it the arena of the other one.
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        ArenaAllocator() : mArena(NULL) {}
+        explicit ArenaAllocator(SceneArena* iArena) : mArena(iArena) {}
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& iOther) : mArena(iOther.getArena()) {}
+
+        T* allocate(size_t iCount)
+        {
+            if ( NULL == mArena )
+            {
+                return static_cast<T*>(::operator new(iCount * sizeof(T)));
+            }
+            return static_cast<T*>(mArena->allocate(iCount * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* iPointer, size_t iCount)
+        {
+            if ( NULL == mArena )
+            {
+                ::operator delete(iPointer);
+                return;
+            }
+            mArena->deallocate(iPointer, iCount * sizeof(T));
+        }
+
+        SceneArena* getArena() const { return mArena; }
+
+    private:
+        SceneArena* mArena;
+    };
+
+    template <class T, class U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.getArena() == b.getArena(); }
+
+    template <class T, class U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.getArena() != b.getArena(); }
+}
+
+#endif // _SCENE_ARENA_H
@@ -0,0 +1,102 @@
+#ifndef _SCENE_EXPORTER_H
+#define _SCENE_EXPORTER_H
+
+#include "CableMeshBuilder.h"
+#include "RenderSnapshot.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Sim
+{
+    class NativeScene;
+}
+
+// Exports the animation of a Sim::NativeScene for the offline renderers, in
+// a binary file that is read without parsing: the geometry of the parts
+// once, then for every frame the transforms of the parts and the instances
+// of the cable sections (see CableMeshBuilder). All the integers are
+// little-endian and the floats are IEEE 754, written with the helpers of
+// TrajectoryFormat.h.
+//
+//   header  "CSCN", version (u32), part count (u32), and for each part its
+//           name, geometry count (u32) and geometries: the type (u32: 0 box,
+//           1 cylinder along z, 2 plane of normal z), the dimensions (3 f32:
+//           the size of the box, or the radius, height and 0 of the
+//           cylinder), the position (3 f32) and the orientation (w, x, y,
+//           z as 4 f32) in the part; then the cable count (u32), and for
+//           each cable its name and radius (f32). A name is its length (u32)
+//           followed by its characters.
+//   frames  one after the other: the step (u64), the time (f64), the
+//           position and orientation of each part (7 f32), then for each
+//           cable its section count (u32) and the instances of its
+//           sections (CableMeshBuilder::kInstanceSize f32 each).
+//   index   offset of each frame from the start of the file (u64 each),
+//   footer  frame count (u64), offset of the index (u64), "CSCI".
+//
+// SceneReader reads the files back. The frame buffer and the builder keep
+// their capacity, so exporting a frame allocates only when the cables have
+// more sections than ever before, or when there are more frames than
+// reserved for the index.
+class SceneExporter
+{
+public:
+    static const char kMagic[4];
+    static const char kIndexMagic[4];
+    static const unsigned int kVersion = 1;
+
+    // Constructor
+    //
+    SceneExporter();
+
+    // Destructor
+    // Closes the file if it is still open.
+    //
+    ~SceneExporter();
+
+    // Create the file and write the header with the parts and cables of
+    // iScene; they must not change while exporting. Returns false if the
+    // file cannot be created.
+    //
+    bool open(const std::string& iFileName, const Sim::NativeScene& iScene);
+
+    // Reserve room in the index for iFrameCount frames so that write()
+    // does not grow it inside the main loop.
+    //
+    void reserve(size_t iFrameCount);
+
+    bool isOpen() const { return mStream.is_open(); }
+
+    // Write the current state of iScene as the next frame.
+    //
+    void write(const Sim::NativeScene& iScene);
+
+    // Write the index and close the file. Returns false if any write
+    // failed.
+    //
+    bool close();
+
+    size_t getFrameCount() const { return mFrameOffsets.size(); }
+
+    // Bytes of the frames written so far.
+    unsigned long long getFrameBytes() const { return mOffset - mHeaderSize; }
+
+private:
+    SceneExporter(const SceneExporter&);
+    SceneExporter& operator=(const SceneExporter&);
+
+private:
+    RenderSnapshot mSnapshot;
+    CableMeshBuilder mBuilder;
+    std::vector<unsigned char> mFrame;
+
+    // Offset of each frame in the file, and of the next one.
+    std::vector<unsigned long long> mFrameOffsets;
+    unsigned long long mOffset;
+    unsigned long long mHeaderSize;
+
+    std::ofstream mStream;
+};
+
+#endif // _SCENE_EXPORTER_H
@@ -0,0 +1,96 @@
+#ifndef _SCENE_READER_H
+#define _SCENE_READER_H
+
+#include "NativeMath.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Random access to the frames of a file written by SceneExporter.
+//
+// open() reads the header with the geometry of the parts and the frame
+// index; readFrame() seeks to one frame and reads only that one.
+class SceneReader
+{
+public:
+    struct Geometry
+    {
+        // 0 box, 1 cylinder along z, 2 plane of normal z.
+        unsigned int type;
+        // Size of the box, or radius, height and 0 of the cylinder.
+        Sim::Vec3 dimensions;
+        Sim::Vec3 position;
+        Sim::Quat orientation;
+    };
+
+    struct PartState
+    {
+        Sim::Vec3 position;
+        Sim::Quat orientation;
+    };
+
+    struct CableState
+    {
+        // CableMeshBuilder::kInstanceSize floats per section.
+        std::vector<float> instances;
+    };
+
+    struct Frame
+    {
+        size_t step;
+        double time;
+        std::vector<PartState> parts;
+        std::vector<CableState> cables;
+    };
+
+    // Constructor
+    //
+    SceneReader();
+
+    // Read the header and the index of the file. Returns false and prints
+    // the reason when the file is missing, truncated or not an exported
+    // scene.
+    //
+    bool open(const std::string& iFileName);
+    void close();
+
+    size_t getFrameCount() const { return mFrameOffsets.size(); }
+    size_t getPartCount() const { return mPartNames.size(); }
+    const std::string& getPartName(size_t iPart) const { return mPartNames[iPart]; }
+    const std::vector<Geometry>& getPartGeometries(size_t iPart) const { return mPartGeometries[iPart]; }
+    size_t getCableCount() const { return mCableNames.size(); }
+    const std::string& getCableName(size_t iCable) const { return mCableNames[iCable]; }
+    double getCableRadius(size_t iCable) const { return mCableRadii[iCable]; }
+
+    // Read the frame at iFrame. Returns false when it is out of range or
+    // corrupted.
+    //
+    bool readFrame(size_t iFrame, Frame& oFrame);
+
+private:
+    // @internal helpers
+    bool _readIndex();
+    bool _readHeader();
+    bool _readBytes(unsigned long long iOffset, size_t iSize);
+
+    SceneReader(const SceneReader&);
+    SceneReader& operator=(const SceneReader&);
+
+private:
+    std::ifstream mStream;
+    unsigned long long mSize;
+    // Bytes read by _readBytes(), reused from one frame to the next.
+    std::vector<unsigned char> mBuffer;
+
+    std::vector<std::string> mPartNames;
+    std::vector<std::vector<Geometry> > mPartGeometries;
+    std::vector<std::string> mCableNames;
+    std::vector<double> mCableRadii;
+
+    // Offset of each frame, and of the index after the last one.
+    std::vector<unsigned long long> mFrameOffsets;
+    unsigned long long mIndexOffset;
+};
+
+#endif // _SCENE_READER_H
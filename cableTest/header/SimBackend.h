@@ -0,0 +1,247 @@
+#ifndef _SIM_BACKEND_H
+#define _SIM_BACKEND_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Forward Declaration
+class MyCrane;
+
+// Thin scene interface targeted by the scene builders (MyCrane, ExCableSystem
+// and the brick scene). It exposes only what the builders need: mechanisms,
+// assemblies, parts with box/cylinder/plane geometries, hinges, prismatics
+// and cable systems.
+//
+// Two implementations exist:
+// - Sim::VortexScene creates the Vortex objects and the CableSystems extensions.
+// - Sim::NativeScene is a self-contained reference implementation with no
+//   dependency on Vortex, used to run the scenes on Linux compute nodes.
+namespace Sim
+{
+    // Simple 3D vector used by the interface.
+    struct Vec3
+    {
+        Vec3() : x(0.0), y(0.0), z(0.0) {}
+        Vec3(double iX, double iY, double iZ) : x(iX), y(iY), z(iZ) {}
+
+        Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
+        Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
+        Vec3 operator-() const { return Vec3(-x, -y, -z); }
+        Vec3 operator*(double s) const { return Vec3(x * s, y * s, z * s); }
+        Vec3 operator/(double s) const { return Vec3(x / s, y / s, z / s); }
+        Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+        Vec3& operator-=(const Vec3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+        Vec3& operator*=(double s) { x *= s; y *= s; z *= s; return *this; }
+
+        double operator[](int i) const { return i == 0 ? x : (i == 1 ? y : z); }
+
+        double x, y, z;
+    };
+
+    inline Vec3 operator*(double s, const Vec3& v) { return v * s; }
+    inline double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline Vec3 cross(const Vec3& a, const Vec3& b) { return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+    inline double length(const Vec3& v) { return std::sqrt(dot(v, v)); }
+
+    // Position and orientation of a part or of a geometry relative to its part.
+    // The orientation is given as XYZ counter-clockwise rotating Euler angles,
+    // like Vx::VxEulerAngles::kXYZ_CounterClockwise_Rotating.
+    struct Pose
+    {
+        Pose() : position(), euler() {}
+        Pose(const Vec3& iPosition, const Vec3& iEuler = Vec3()) : position(iPosition), euler(iEuler) {}
+
+        Vec3 position;
+        Vec3 euler;
+    };
+
+    // Handles returned by the scene. They are indices local to the scene.
+    typedef int MechanismId;
+    typedef int AssemblyId;
+    typedef int PartId;
+    typedef int ConstraintId;
+    typedef int CableId;
+    static const int kInvalidId = -1;
+
+    // Same meaning as Vx::VxPart::eControlType.
+    enum PartControl
+    {
+        kPartStatic,
+        kPartDynamic,
+        kPartAnimated
+    };
+
+    // Same meaning as Vx::VxConstraint::eControlType for the single free
+    // coordinate of a hinge (angular) or a prismatic (linear).
+    enum ConstraintControl
+    {
+        kConstraintFree,
+        kConstraintMotorized
+    };
+
+    struct PartDefinition
+    {
+        PartDefinition() : name(), control(kPartDynamic), position(), mass(0.0) {}
+        PartDefinition(const std::string& iName, PartControl iControl, const Vec3& iPosition, double iMass = 0.0)
+            : name(iName), control(iControl), position(iPosition), mass(iMass) {}
+
+        std::string name;
+        PartControl control;
+        Vec3 position;
+        // When zero, the mass is computed from the collision geometries.
+        double mass;
+    };
+
+    // Same vocabulary as CableSystems::DynamicsICD::PointDefinitionType.
+    enum CablePointType
+    {
+        kCableAttachmentPoint,
+        kCableWinch,
+        kCablePulley,
+        kCableRing
+    };
+
+    struct CablePointDefinition
+    {
+        CablePointDefinition()
+            : type(kCableAttachmentPoint), part(kInvalidId), offset(), inverseWrapping(false), ringPrimaryAxis(1.0, 0.0, 0.0) {}
+        CablePointDefinition(CablePointType iType, PartId iPart, const Vec3& iOffset = Vec3())
+            : type(iType), part(iPart), offset(iOffset), inverseWrapping(false), ringPrimaryAxis(1.0, 0.0, 0.0) {}
+
+        CablePointType type;
+        PartId part;
+        // Offset in the part frame, used by the attachment points. The
+        // native backend also moves the point of winches and pulleys by it,
+        // along their axis, so that several cables can share them; Vortex
+        // passes through their center.
+        Vec3 offset;
+        // Pulleys only: invert the side on which the cable wraps.
+        bool inverseWrapping;
+        // Rings only: axis of the ring in the part frame.
+        Vec3 ringPrimaryAxis;
+    };
+
+    // Overridden parameters of one segment of the cable. The segments are
+    // numbered like in CableSystems: winches and pulleys get an arc segment,
+    // and there is one straight segment between two consecutive points.
+    // See CableDefinition::getSpanSegmentIndex().
+    struct CableSegmentDefinition
+    {
+        CableSegmentDefinition()
+            : index(0), flexible(false), maxSectionLength(1.0), minSectionLength(0.2), fixedLength(false), collisionGeometryType(-1)
+            , adaptive(false) {}
+
+        size_t index;
+        bool flexible;
+        double maxSectionLength;
+        double minSectionLength;
+        bool fixedLength;
+        // -1 when not overridden.
+        int collisionGeometryType;
+        // Used by the native backend only: the sections of a flexible segment
+        // are refined down to minSectionLength where the cable bends, touches
+        // something or changes tension, and coarsened up to maxSectionLength
+        // elsewhere (see CableChain).
+        bool adaptive;
+    };
+
+    struct CableParams
+    {
+        CableParams()
+            : axialStiffness(10000.0), axialDamping(20.0), collisionGeometryType(-1)
+            , enableBreakage(false), maxTension(0.0), linearDensity(1.0), radius(0.05), implicitAxial(false)
+            , deployableLength(0.0) {}
+
+        // Force per unit of strain.
+        double axialStiffness;
+        // Force per unit of strain rate.
+        double axialDamping;
+        // -1 when not overridden.
+        int collisionGeometryType;
+        bool enableBreakage;
+        double maxTension;
+        // Used by the native backend only; CableSystems uses its own defaults.
+        double linearDensity;
+        double radius;
+        // Used by the native backend only: solve all the sections of the
+        // cable together instead of one after the other, so that a stiff
+        // cable keeps its length with large steps (see CableChain::solve()).
+        bool implicitAxial;
+        // Used by the native backend only: the longest the cable gets when
+        // the winch pays out, to size its arrays once; the length at
+        // creation when shorter.
+        double deployableLength;
+    };
+
+    struct CableDefinition
+    {
+        // Return the index of the straight segment between iPointIndex and
+        // iPointIndex+1, following the CableSystems numbering.
+        size_t getSpanSegmentIndex(size_t iPointIndex) const;
+
+        // Return the overridden segment at iSegmentIndex or NULL.
+        const CableSegmentDefinition* findSegment(size_t iSegmentIndex) const;
+
+        std::string name;
+        std::vector<CablePointDefinition> points;
+        std::vector<CableSegmentDefinition> segments;
+        CableParams params;
+    };
+
+    // Called at the start of every substep by the backends that split the
+    // steps in substeps (NativeScene), so that motors can be driven at a
+    // higher rate than the steps. iTime is the time of the start of the
+    // substep and h its duration.
+    class ISubstepCallback
+    {
+    public:
+        virtual ~ISubstepCallback() {}
+
+        virtual void preSubstep(double iTime, double h) = 0;
+    };
+
+    // Scene interface used by the builders.
+    class IScene
+    {
+    public:
+        virtual ~IScene() {}
+
+        virtual MechanismId createMechanism(const std::string& iName) = 0;
+        virtual AssemblyId createAssembly(MechanismId iMechanism, const std::string& iName) = 0;
+        virtual PartId createPart(AssemblyId iAssembly, const PartDefinition& iDefinition) = 0;
+
+        // Geometries are added in the part frame.
+        virtual void addBox(PartId iPart, const Vec3& iDimensions, const Pose& iRelative = Pose()) = 0;
+        virtual void addCylinder(PartId iPart, double iRadius, double iHeight, const Pose& iRelative = Pose()) = 0;
+        virtual void addPlane(PartId iPart) = 0;
+
+        // Enable or disable the collisions between the parts of an assembly.
+        virtual void setSelfCollision(AssemblyId iAssembly, bool iEnabled) = 0;
+
+        // Constraints are created free; the position and axis are in world frame.
+        virtual ConstraintId createHinge(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis) = 0;
+        virtual ConstraintId createPrismatic(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis) = 0;
+        virtual void setConstraintControl(ConstraintId iConstraint, ConstraintControl iControl) = 0;
+        virtual void setMotorDesiredVelocity(ConstraintId iConstraint, double iVelocity) = 0;
+        virtual void setLimits(ConstraintId iConstraint, double iLower, double iUpper) = 0;
+
+        virtual CableId createCable(MechanismId iMechanism, const CableDefinition& iDefinition) = 0;
+
+        // Lookups by name, returning kInvalidId when not found. The names are
+        // hashed when the objects are created, the lookups do not depend on
+        // the size of the scene.
+        virtual AssemblyId findAssembly(MechanismId iMechanism, const std::string& iName) const = 0;
+        virtual PartId findPart(AssemblyId iAssembly, const std::string& iName) const = 0;
+        virtual CableId findCable(MechanismId iMechanism, const std::string& iName) const = 0;
+        virtual Vec3 getPartPosition(PartId iPart) const = 0;
+
+        // Presentation and input hooks; backends without graphics or keyboard ignore them.
+        virtual void addCableGraphics(MechanismId /*iMechanism*/, CableId /*iCable*/, const std::string& /*iName*/) {}
+        virtual void addDirectionalLight(const Vec3& /*iOrientation*/) {}
+        virtual void addCamera(const Pose& /*iPose*/) {}
+        virtual void addKeyboardControl(MechanismId /*iMechanism*/, MyCrane* /*iCrane*/) {}
+    };
+}
+
+#endif // _SIM_BACKEND_H
@@ -0,0 +1,122 @@
+#ifndef _SPSC_RING_H
+#define _SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Fixed-size single-producer, single-consumer ring of T.
+//
+// The slots are allocated by the constructor and reused: the producer fills
+// the slot returned by beginPush() in place and publishes it with
+// endPush(), the consumer reads the slot returned by beginPop() and gives it
+// back with endPop(). Neither side ever locks nor allocates, so that the
+// simulation thread can publish while another thread drains the ring. When
+// the ring is full the element is dropped and counted.
+//
+// The head is only written by the producer and the tail by the consumer;
+// each side publishes its index with a release store and reads the other
+// one with an acquire load, so a slot is never read while it is written.
+template <class T>
+class SpscRing
+{
+public:
+    // Constructor
+    // The capacity is rounded up to a power of two. Every slot starts as a
+    // copy of iValue, so elements holding arrays can get their memory now.
+    //
+    explicit SpscRing(size_t iCapacity, const T& iValue = T())
+        : mSlots()
+        , mMask(0)
+        , mHead(0)
+        , mTail(0)
+        , mDroppedCount(0)
+    {
+        size_t capacity = 1;
+        while ( capacity < iCapacity )
+        {
+            capacity <<= 1;
+        }
+        mSlots.assign(capacity, iValue);
+        mMask = capacity - 1;
+    }
+
+    size_t getCapacity() const { return mSlots.size(); }
+    size_t getDroppedCount() const { return mDroppedCount.load(std::memory_order_relaxed); }
+
+    // Producer side. Returns the free slot to fill, or NULL when the ring
+    // is full.
+    T* beginPush()
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        const size_t tail = mTail.load(std::memory_order_acquire);
+        if ( head - tail > mMask )
+        {
+            mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return NULL;
+        }
+        return &mSlots[head & mMask];
+    }
+
+    // Publish the slot returned by the last beginPush().
+    void endPush()
+    {
+        mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool push(const T& iValue)
+    {
+        T* slot = beginPush();
+        if ( NULL == slot )
+        {
+            return false;
+        }
+        *slot = iValue;
+        endPush();
+        return true;
+    }
+
+    // Consumer side. Returns the oldest slot, or NULL when the ring is
+    // empty.
+    const T* beginPop() const
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        const size_t head = mHead.load(std::memory_order_acquire);
+        if ( tail == head )
+        {
+            return NULL;
+        }
+        return &mSlots[tail & mMask];
+    }
+
+    // Give back the slot returned by the last beginPop().
+    void endPop()
+    {
+        mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& oValue)
+    {
+        const T* slot = beginPop();
+        if ( NULL == slot )
+        {
+            return false;
+        }
+        oValue = *slot;
+        endPop();
+        return true;
+    }
+
+private:
+    SpscRing(const SpscRing&);
+    SpscRing& operator=(const SpscRing&);
+
+private:
+    std::vector<T> mSlots;
+    size_t mMask;
+    std::atomic<size_t> mHead;
+    std::atomic<size_t> mTail;
+    std::atomic<size_t> mDroppedCount;
+};
+
+#endif // _SPSC_RING_H
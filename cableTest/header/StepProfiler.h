@@ -0,0 +1,99 @@
+#ifndef _STEP_PROFILER_H
+#define _STEP_PROFILER_H
+
+#include "SpscRing.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Splits the duration of each simulation step in phases.
+//
+// The simulation thread opens a step, adds the time spent in each phase and
+// closes the step; the closed steps go into a SpscRing. Recording never
+// allocates nor locks: when the ring is full the sample is dropped and
+// counted. Another thread can drain the ring with pop() while the
+// simulation runs, and writeCsv() drains what is left at the end of the
+// run.
+//
+// Running totals and maxima are kept for every step, so the summary covers
+// the whole run even if samples were dropped.
+class StepProfiler
+{
+public:
+    enum Phase
+    {
+        // Controllers and pre-update extensions (keyboard, replay).
+        kPhasePreUpdate,
+        kPhaseCollision,
+        kPhaseConstraintSolve,
+        kPhaseCableUpdate,
+        kPhaseGraphicsSync,
+        kPhaseCount
+    };
+
+    struct Sample
+    {
+        size_t step;
+        double phases[kPhaseCount];
+    };
+
+    // Adds the time spent in a scope to a phase of the open step. A NULL
+    // profiler makes the scope free, so the timing calls can stay in place.
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase(StepProfiler* iProfiler, Phase iPhase);
+        ~ScopedPhase();
+
+    private:
+        StepProfiler* mProfiler;
+        Phase mPhase;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    // Constructor
+    // The capacity of the ring is rounded up to a power of two.
+    //
+    explicit StepProfiler(size_t iCapacity = 4096);
+
+    // Producer side, called by the simulation thread.
+    void beginStep();
+    void addPhaseTime(Phase iPhase, double iSeconds);
+    void endStep();
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(Sample& oSample);
+
+    // Last closed step. Only valid on the simulation thread.
+    const Sample& getLastSample() const { return mLastSample; }
+
+    size_t getStepCount() const { return mStepCount; }
+    size_t getDroppedCount() const { return mRing.getDroppedCount(); }
+    double getTotalTime(Phase iPhase) const { return mTotals[iPhase]; }
+    double getMaxTime(Phase iPhase) const { return mMaxima[iPhase]; }
+
+    static const char* getPhaseName(Phase iPhase);
+
+    // Drain the ring into iFileName as CSV, one line per step, followed by
+    // the per-phase summary as comment lines.
+    //
+    // Returns false if the file cannot be written.
+    bool writeCsv(const std::string& iFileName);
+
+    // Print the per-phase summary on the standard output.
+    //
+    void printSummary() const;
+
+private:
+    SpscRing<Sample> mRing;
+
+    // Producer state
+    Sample mCurrent;
+    Sample mLastSample;
+    size_t mStepCount;
+    double mTotals[kPhaseCount];
+    double mMaxima[kPhaseCount];
+};
+
+#endif // _STEP_PROFILER_H
@@ -0,0 +1,61 @@
+#ifndef _STEP_STATISTICS_H
+#define _STEP_STATISTICS_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Collects the wall-clock duration of every simulation step of a run and
+// summarizes them so batch runs can be compared against each other.
+class StepStatistics
+{
+public:
+    // Summary of the recorded step durations, all times in seconds.
+    struct Summary
+    {
+        size_t stepCount;
+        double totalTime;
+        double mean;
+        double p50;
+        double p90;
+        double p99;
+        double max;
+    };
+
+    // Constructor
+    //
+    StepStatistics();
+
+    // Reserve room for iStepCount samples so recording never allocates
+    // inside the main loop.
+    //
+    void reserve(size_t iStepCount);
+
+    // Record the wall-clock duration of one step.
+    //
+    void addStep(double iSeconds);
+
+    size_t getStepCount() const { return mStepTimes.size(); }
+
+    // Compute the mean, percentiles and max of the recorded steps.
+    //
+    Summary computeSummary() const;
+
+    // Write the summary to iFileName. The format is CSV when the file name
+    // ends with ".csv", JSON otherwise.
+    //
+    // Returns false if the file cannot be written.
+    bool writeSummary(const std::string& iFileName, const std::string& iSceneName) const;
+
+    // Print the summary on the standard output.
+    //
+    void printSummary(const std::string& iSceneName) const;
+
+private:
+    bool writeJson(std::ostream& oStream, const std::string& iSceneName, const Summary& iSummary) const;
+    bool writeCsv(std::ostream& oStream, const std::string& iSceneName, const Summary& iSummary) const;
+
+    std::vector<double> mStepTimes;
+};
+
+#endif // _STEP_STATISTICS_H
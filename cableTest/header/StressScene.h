@@ -0,0 +1,109 @@
+#ifndef _STRESS_SCENE_H
+#define _STRESS_SCENE_H
+
+#include "SimBackend.h"
+
+#include <string>
+#include <vector>
+
+class MyCrane;
+
+// Procedural yard of cranes, to measure how the step time and the memory
+// scale with the size of the scene.
+//
+// Each crane is a MyCrane with its own rigging: craneCount cranes with
+// cablesPerCrane cables each, every cable going from the winch over
+// pulleyCount pulleys down to its own load. The first two pulleys are the
+// ones of the crane (the tip pulley, then the mid pulley); the others are
+// static idlers carrying the cables away from the tip at the height of the
+// tip. The loads are placed so that each cable is cableLength long. The
+// cables of a crane run side by side, each on its own point along the axis
+// of the winch and the pulleys, so that they do not start in contact.
+//
+// The cranes are laid out on a grid or at random in a square, without
+// overlapping. The layout only depends on the settings: the same seed
+// gives the same scene on every platform.
+class StressScene
+{
+public:
+    struct Settings
+    {
+        Settings();
+
+        size_t craneCount;
+        size_t cablesPerCrane;
+        // Length of each cable, in m; clamped to the distance from the
+        // winch to the last pulley plus 1 m.
+        double cableLength;
+        // Maximum length of the sections of the cables, in m.
+        double maxSectionLength;
+        // At least 1, the tip pulley.
+        size_t pulleyCount;
+        // "grid" or "random".
+        std::string layout;
+        // Distance between the origins of two cranes; 0 to fit the rigging.
+        double spacing;
+        unsigned int seed;
+
+        double loadMass;
+        double axialStiffness;
+        double axialDamping;
+        // Let the cables of the native backend touch each other.
+        bool cableCollision;
+        bool adaptiveSections;
+        bool implicitCables;
+    };
+
+    // Constructor
+    // The cranes, their rigging, the loads, the cables and a ground under
+    // the yard are created in iScene.
+    //
+    explicit StressScene(Sim::IScene& iScene, const Settings& iSettings = Settings());
+
+    // Destructor
+    //
+    ~StressScene();
+
+    size_t getCraneCount() const { return mCranes.size(); }
+    MyCrane* getCrane(size_t iCrane) { return mCranes[iCrane]; }
+
+    // All the cables, those of the first crane first.
+    const std::vector<Sim::CableId>& getCables() const { return mCables; }
+
+    // Size and layout of the scene, e.g. "8 cranes x 2 cables, grid".
+    std::string getDescription() const;
+
+private:
+    // @internal helpers
+    void _planRigging();
+    void _layOut();
+    void _createGround();
+    void _createRigging(size_t iCrane);
+
+    // Uniform in [0, 1), from the raw output of the generator so that the
+    // values do not depend on the standard library.
+    double _random();
+
+private:
+    Sim::IScene& mScene;
+    Settings mSettings;
+
+    std::vector<Sim::Vec3> mOrigins;
+    std::vector<MyCrane*> mCranes;
+    std::vector<Sim::CableId> mCables;
+
+    // The rigging is the same for every crane; the positions are relative
+    // to the origin of the crane, and the load is the one of a cable
+    // leaving from the middle of the winch.
+    size_t mCranePulleyCount;
+    std::vector<Sim::Vec3> mIdlers;
+    Sim::Vec3 mLoad;
+    // Footprint of a crane and its rigging, around its origin.
+    Sim::Vec3 mMin;
+    Sim::Vec3 mMax;
+
+    // State of the xorshift generator of the random layout.
+    unsigned long long mRandomState;
+};
+
+#endif // _STRESS_SCENE_H
@@ -0,0 +1,78 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running batches of independent tasks.
+//
+// run() deals the tasks of a batch over one queue per worker. A worker
+// takes the tasks of its own queue from the back and, once it is empty,
+// steals from the front of the other queues, so that workers which got
+// short tasks pick up the remaining ones of the others. The calling thread
+// is worker 0 and takes part in the batch.
+class ThreadPool
+{
+public:
+    // Task called with its index in the batch and the index of the worker
+    // running it, in [0, getThreadCount()).
+    typedef std::function<void (size_t iTask, size_t iWorker)> Task;
+
+    // Constructor
+    // When iThreadCount is 0, one worker per hardware thread is used.
+    //
+    explicit ThreadPool(size_t iThreadCount = 0);
+
+    // Destructor
+    // Stops and joins the workers.
+    //
+    ~ThreadPool();
+
+    size_t getThreadCount() const { return mQueues.size(); }
+
+    // Run iTask for each index in [0, iTaskCount) and return when all of
+    // them are done. The first exception thrown by a task is rethrown here,
+    // after the other tasks of the batch have finished.
+    //
+    void run(size_t iTaskCount, const Task& iTask);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    // @internal helpers
+    void _workerLoop(size_t iWorker);
+    void _work(size_t iWorker);
+    bool _pop(size_t iWorker, size_t& oTask);
+    bool _steal(size_t iWorker, size_t& oTask);
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+private:
+    std::vector< std::unique_ptr<Queue> > mQueues;
+    std::vector<std::thread> mThreads;
+
+    // Batch state, protected by mMutex.
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::condition_variable mDone;
+    const Task* mTask;
+    size_t mBatch;
+    size_t mPendingCount;
+    // Workers inside _work().
+    size_t mActiveCount;
+    std::exception_ptr mError;
+    bool mStop;
+};
+
+#endif // _THREAD_POOL_H
@@ -0,0 +1,186 @@
+#ifndef _TRAJECTORY_FORMAT_H
+#define _TRAJECTORY_FORMAT_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Layout of the trajectory files written by TrajectoryRecorder and read by
+// TrajectoryReader. All the integers are little-endian.
+//
+//   header  "CTRJ", version (u32), key frame interval (u32),
+//           position, orientation, velocity and tension quanta (f64 each),
+//           part count (u32) and names, cable count (u32) and names;
+//           a name is its length (u32) followed by its characters.
+//   frames  one after the other, see below.
+//   index   offset of each frame from the start of the file (u64 each),
+//   footer  frame count (u64), offset of the index (u64), "CTRI".
+//
+// A frame starts with the step index (varint) and the simulated time (f64),
+// followed by varints only: for each part the 13 quantized values of
+// the position, orientation (w, x, y, z), linear and angular velocities.
+// In key frames (every key frame interval frames, starting with frame 0)
+// the part values are absolute; in the other frames they are the difference
+// with the previous frame. Then, for each cable, the node count, the broken
+// flag, the quantized node positions, the first one absolute and the others
+// relative to the previous node, and the quantized section tensions.
+//
+// The signed values are zigzag encoded, so that small deltas of either sign
+// take one or two bytes.
+namespace TrajectoryFormat
+{
+    static const char kMagic[4] = { 'C', 'T', 'R', 'J' };
+    static const char kIndexMagic[4] = { 'C', 'T', 'R', 'I' };
+    static const unsigned int kVersion = 1;
+
+    // Number of values per part in a frame.
+    static const int kPartValueCount = 13;
+
+    // Size of the footer: frame count, index offset and magic.
+    static const size_t kFooterSize = 8 + 8 + 4;
+
+    inline void PutU32(std::vector<unsigned char>& oBuffer, unsigned int iValue)
+    {
+        for (int i=0; i<4; ++i)
+        {
+            oBuffer.push_back(static_cast<unsigned char>(iValue >> (8 * i)));
+        }
+    }
+
+    inline void PutU64(std::vector<unsigned char>& oBuffer, unsigned long long iValue)
+    {
+        for (int i=0; i<8; ++i)
+        {
+            oBuffer.push_back(static_cast<unsigned char>(iValue >> (8 * i)));
+        }
+    }
+
+    inline void PutF32(std::vector<unsigned char>& oBuffer, float iValue)
+    {
+        unsigned int bits;
+        memcpy(&bits, &iValue, sizeof(bits));
+        PutU32(oBuffer, bits);
+    }
+
+    inline void PutF64(std::vector<unsigned char>& oBuffer, double iValue)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &iValue, sizeof(bits));
+        PutU64(oBuffer, bits);
+    }
+
+    inline void PutString(std::vector<unsigned char>& oBuffer, const std::string& iValue)
+    {
+        PutU32(oBuffer, static_cast<unsigned int>(iValue.size()));
+        oBuffer.insert(oBuffer.end(), iValue.begin(), iValue.end());
+    }
+
+    inline void PutVarint(std::vector<unsigned char>& oBuffer, unsigned long long iValue)
+    {
+        while ( iValue >= 0x80 )
+        {
+            oBuffer.push_back(static_cast<unsigned char>(iValue | 0x80));
+            iValue >>= 7;
+        }
+        oBuffer.push_back(static_cast<unsigned char>(iValue));
+    }
+
+    inline void PutSigned(std::vector<unsigned char>& oBuffer, long long iValue)
+    {
+        PutVarint(oBuffer, (static_cast<unsigned long long>(iValue) << 1) ^ static_cast<unsigned long long>(iValue >> 63));
+    }
+
+    // Reading side: each function advances ioData and returns false when it
+    // would read past iEnd.
+    inline bool GetU32(const unsigned char*& ioData, const unsigned char* iEnd, unsigned int& oValue)
+    {
+        if ( iEnd - ioData < 4 )
+        {
+            return false;
+        }
+        oValue = 0;
+        for (int i=0; i<4; ++i)
+        {
+            oValue |= static_cast<unsigned int>(ioData[i]) << (8 * i);
+        }
+        ioData += 4;
+        return true;
+    }
+
+    inline bool GetU64(const unsigned char*& ioData, const unsigned char* iEnd, unsigned long long& oValue)
+    {
+        if ( iEnd - ioData < 8 )
+        {
+            return false;
+        }
+        oValue = 0;
+        for (int i=0; i<8; ++i)
+        {
+            oValue |= static_cast<unsigned long long>(ioData[i]) << (8 * i);
+        }
+        ioData += 8;
+        return true;
+    }
+
+    inline bool GetF32(const unsigned char*& ioData, const unsigned char* iEnd, float& oValue)
+    {
+        unsigned int bits;
+        if ( !GetU32(ioData, iEnd, bits) )
+        {
+            return false;
+        }
+        memcpy(&oValue, &bits, sizeof(bits));
+        return true;
+    }
+
+    inline bool GetF64(const unsigned char*& ioData, const unsigned char* iEnd, double& oValue)
+    {
+        unsigned long long bits;
+        if ( !GetU64(ioData, iEnd, bits) )
+        {
+            return false;
+        }
+        memcpy(&oValue, &bits, sizeof(bits));
+        return true;
+    }
+
+    inline bool GetString(const unsigned char*& ioData, const unsigned char* iEnd, std::string& oValue)
+    {
+        unsigned int size;
+        if ( !GetU32(ioData, iEnd, size) || static_cast<size_t>(iEnd - ioData) < size )
+        {
+            return false;
+        }
+        oValue.assign(reinterpret_cast<const char*>(ioData), size);
+        ioData += size;
+        return true;
+    }
+
+    inline bool GetVarint(const unsigned char*& ioData, const unsigned char* iEnd, unsigned long long& oValue)
+    {
+        oValue = 0;
+        for (int shift=0; ioData < iEnd && shift < 64; shift += 7)
+        {
+            const unsigned char byte = *ioData++;
+            oValue |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if ( 0 == (byte & 0x80) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool GetSigned(const unsigned char*& ioData, const unsigned char* iEnd, long long& oValue)
+    {
+        unsigned long long value;
+        if ( !GetVarint(ioData, iEnd, value) )
+        {
+            return false;
+        }
+        oValue = static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+        return true;
+    }
+}
+
+#endif // _TRAJECTORY_FORMAT_H
@@ -0,0 +1,95 @@
+#ifndef _TRAJECTORY_READER_H
+#define _TRAJECTORY_READER_H
+
+#include "NativeMath.h"
+
+#include <string>
+#include <vector>
+
+// Random access to the frames of a file written by TrajectoryRecorder.
+//
+// The file is memory-mapped; only the header and the frame index are read
+// by open(). readFrame() decodes from the last key frame before the
+// requested one, reading only the parts of the frames in between.
+class TrajectoryReader
+{
+public:
+    struct PartState
+    {
+        Sim::Vec3 position;
+        Sim::Quat orientation;
+        Sim::Vec3 linearVelocity;
+        Sim::Vec3 angularVelocity;
+    };
+
+    struct CableState
+    {
+        bool broken;
+        std::vector<Sim::Vec3> nodes;
+        std::vector<double> tensions;
+    };
+
+    struct Frame
+    {
+        size_t step;
+        double time;
+        std::vector<PartState> parts;
+        std::vector<CableState> cables;
+    };
+
+    // Constructor
+    //
+    TrajectoryReader();
+
+    // Destructor
+    //
+    ~TrajectoryReader();
+
+    // Map the file and read its header and index. Returns false and prints
+    // the reason when the file is missing, truncated or not a trajectory.
+    //
+    bool open(const std::string& iFileName);
+    void close();
+
+    size_t getFrameCount() const { return mFrameCount; }
+    size_t getPartCount() const { return mPartNames.size(); }
+    const std::string& getPartName(size_t iPart) const { return mPartNames[iPart]; }
+    size_t getCableCount() const { return mCableNames.size(); }
+    const std::string& getCableName(size_t iCable) const { return mCableNames[iCable]; }
+
+    // Decode the frame at iFrame. Returns false when it is out of range or
+    // corrupted.
+    //
+    bool readFrame(size_t iFrame, Frame& oFrame) const;
+
+private:
+    // @internal helpers
+    bool _readHeader();
+    const unsigned char* _getFrameData(size_t iFrame) const;
+    bool _readParts(const unsigned char*& ioData, bool iKeyFrame, std::vector<long long>& ioValues) const;
+
+    TrajectoryReader(const TrajectoryReader&);
+    TrajectoryReader& operator=(const TrajectoryReader&);
+
+private:
+    const unsigned char* mData;
+    size_t mSize;
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#endif
+
+    unsigned int mKeyFrameInterval;
+    double mPositionQuantum;
+    double mOrientationQuantum;
+    double mVelocityQuantum;
+    double mTensionQuantum;
+    std::vector<std::string> mPartNames;
+    std::vector<std::string> mCableNames;
+
+    size_t mFrameCount;
+    // Start of the frame index in the mapping.
+    const unsigned char* mIndex;
+};
+
+#endif // _TRAJECTORY_READER_H
@@ -0,0 +1,110 @@
+#ifndef _TRAJECTORY_RECORDER_H
+#define _TRAJECTORY_RECORDER_H
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Sim
+{
+    class NativeScene;
+}
+
+// Records the state of a Sim::NativeScene at every step in a compact binary
+// file (see TrajectoryFormat.h): part transforms and velocities, cable node
+// positions and section tensions.
+//
+// record() only quantizes and encodes the frame in memory; the encoded
+// frames are handed to a background thread in chunks and written there, so
+// that the file system does not stall the simulation. The frame index is
+// written by close(), which makes the file readable by TrajectoryReader.
+class TrajectoryRecorder
+{
+public:
+    // Quantization steps, in the units of the values.
+    struct Settings
+    {
+        Settings();
+
+        double positionQuantum;
+        double orientationQuantum;
+        double velocityQuantum;
+        double tensionQuantum;
+        // A key frame is written every keyFrameInterval frames, which
+        // bounds the number of frames decoded by a random access.
+        unsigned int keyFrameInterval;
+    };
+
+    // Constructor
+    //
+    TrajectoryRecorder();
+
+    // Destructor
+    // Closes the file if it is still open.
+    //
+    ~TrajectoryRecorder();
+
+    // Create the file and write the header with the parts and cables of
+    // iScene; they must not change while recording. Returns false if the
+    // file cannot be created.
+    //
+    bool open(const std::string& iFileName, const Sim::NativeScene& iScene, const Settings& iSettings = Settings());
+
+    bool isOpen() const { return mThread.joinable(); }
+
+    // Encode the current state of iScene as the next frame.
+    //
+    void record(const Sim::NativeScene& iScene);
+
+    // Write the pending frames and the index, and close the file. Returns
+    // false if any write failed.
+    //
+    bool close();
+
+    size_t getFrameCount() const { return mFrameOffsets.size(); }
+
+    // Bytes of the frames encoded so far.
+    unsigned long long getFrameBytes() const { return mOffset - mHeaderSize; }
+
+private:
+    // @internal helpers
+    void _encodeFrame(const Sim::NativeScene& iScene, bool iKeyFrame);
+    void _putPartValue(size_t iIndex, double iValue, double iQuantum, bool iKeyFrame);
+    void _flushChunk();
+    void _writerLoop();
+
+    TrajectoryRecorder(const TrajectoryRecorder&);
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&);
+
+private:
+    Settings mSettings;
+
+    // Offset of each frame in the file, and of the next one.
+    std::vector<unsigned long long> mFrameOffsets;
+    unsigned long long mOffset;
+    unsigned long long mHeaderSize;
+
+    // Quantized part values of the previous frame, for the deltas.
+    std::vector<long long> mPartValues;
+
+    // Frames being encoded; handed to the writer when full.
+    std::vector<unsigned char> mChunk;
+
+    // Shared with the writer thread, protected by mMutex.
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::deque< std::vector<unsigned char> > mPendingChunks;
+    // Written chunks, given back to be reused without allocating.
+    std::vector< std::vector<unsigned char> > mFreeChunks;
+    bool mClosing;
+    bool mWriteFailed;
+
+    std::ofstream mStream;
+    std::thread mThread;
+};
+
+#endif // _TRAJECTORY_RECORDER_H
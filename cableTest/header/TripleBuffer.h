@@ -0,0 +1,65 @@
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Hands the latest value of T from one writer thread to one reader thread
+// without locks and without either of them waiting for the other.
+//
+// The writer fills getWriteBuffer() and publishes it; the reader calls
+// acquire() when it wants the latest published value and reads it from
+// getReadBuffer() for as long as it needs. The third buffer sits between
+// them: publish() swaps the write buffer with it, acquire() swaps it with
+// the read buffer if something was published since. The writer can publish
+// at any rate, the values the reader does not acquire are overwritten.
+//
+// The buffers are reused, so a T holding vectors stops allocating once
+// they reached their largest size.
+template <class T>
+class TripleBuffer
+{
+public:
+    // Constructor
+    //
+    TripleBuffer()
+        : mMiddle(1)
+        , mWriteIndex(0)
+        , mReadIndex(2)
+    {
+    }
+
+    // Writer side.
+    T& getWriteBuffer() { return mBuffers[mWriteIndex]; }
+    void publish()
+    {
+        const unsigned int previous = mMiddle.exchange(mWriteIndex | sPublished, std::memory_order_acq_rel);
+        mWriteIndex = previous & sIndexMask;
+    }
+
+    // Reader side. Returns false, keeping the read buffer, when nothing was
+    // published since the last acquire().
+    bool acquire()
+    {
+        if ( 0 == (mMiddle.load(std::memory_order_relaxed) & sPublished) )
+        {
+            return false;
+        }
+        const unsigned int previous = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel);
+        mReadIndex = previous & sIndexMask;
+        return true;
+    }
+    const T& getReadBuffer() const { return mBuffers[mReadIndex]; }
+
+private:
+    static const unsigned int sIndexMask = 3;
+    // Set in the middle index when the middle buffer was not read yet.
+    static const unsigned int sPublished = 4;
+
+    T mBuffers[3];
+    std::atomic<unsigned int> mMiddle;
+    // Owned by the writer and the reader respectively.
+    unsigned int mWriteIndex;
+    unsigned int mReadIndex;
+};
+
+#endif // _TRIPLE_BUFFER_H
@@ -0,0 +1,112 @@
+#ifndef _VORTEX_SCENE_H
+#define _VORTEX_SCENE_H
+
+#include "NameRegistry.h"
+#include "SimBackend.h"
+
+#include <VxSim/VxScene.h>
+#include <VxSim/VxMechanism.h>
+
+#include <Vx/VxSmartPtr.h>
+
+#include <vector>
+
+namespace Vx
+{
+    class VxAssembly;
+    class VxConstraint;
+    class VxPart;
+}
+
+namespace VxSim
+{
+    class VxExtension;
+}
+
+class ControlLog;
+
+namespace Sim
+{
+    // Sim::IScene implementation creating Vortex objects.
+    //
+    // Every mechanism created through this interface is added to the
+    // VxSim::VxScene returned by getScene(). Cables are CableSystems dynamics
+    // extensions added to their mechanism.
+    class VortexScene : public IScene
+    {
+    public:
+        // Constructor
+        // When iWithGraphics is false, the presentation hooks do nothing.
+        //
+        explicit VortexScene(bool iWithGraphics = true);
+
+        // Destructor
+        //
+        virtual ~VortexScene();
+
+        // Called to get the Vortex scene
+        //
+        VxSim::VxScene* getScene() { return mScene.get(); }
+
+        // Access to the Vortex objects behind the handles.
+        VxSim::VxMechanism* getMechanism(MechanismId iMechanism) const;
+        Vx::VxAssembly* getAssembly(AssemblyId iAssembly) const;
+        Vx::VxPart* getPart(PartId iPart) const;
+        Vx::VxConstraint* getConstraint(ConstraintId iConstraint) const;
+        VxSim::VxExtension* getCableExtension(CableId iCable) const;
+
+        // Log in which the keyboard controls created afterwards record the
+        // speed changes; NULL to not record. The log is not owned by the scene.
+        void setControlLog(ControlLog* iLog) { mControlLog = iLog; }
+
+        // IScene
+        virtual MechanismId createMechanism(const std::string& iName);
+        virtual AssemblyId createAssembly(MechanismId iMechanism, const std::string& iName);
+        virtual PartId createPart(AssemblyId iAssembly, const PartDefinition& iDefinition);
+        virtual void addBox(PartId iPart, const Vec3& iDimensions, const Pose& iRelative = Pose());
+        virtual void addCylinder(PartId iPart, double iRadius, double iHeight, const Pose& iRelative = Pose());
+        virtual void addPlane(PartId iPart);
+        virtual void setSelfCollision(AssemblyId iAssembly, bool iEnabled);
+        virtual ConstraintId createHinge(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis);
+        virtual ConstraintId createPrismatic(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis);
+        virtual void setConstraintControl(ConstraintId iConstraint, ConstraintControl iControl);
+        virtual void setMotorDesiredVelocity(ConstraintId iConstraint, double iVelocity);
+        virtual void setLimits(ConstraintId iConstraint, double iLower, double iUpper);
+        virtual CableId createCable(MechanismId iMechanism, const CableDefinition& iDefinition);
+        virtual AssemblyId findAssembly(MechanismId iMechanism, const std::string& iName) const;
+        virtual PartId findPart(AssemblyId iAssembly, const std::string& iName) const;
+        virtual CableId findCable(MechanismId iMechanism, const std::string& iName) const;
+        virtual Vec3 getPartPosition(PartId iPart) const;
+        virtual void addCableGraphics(MechanismId iMechanism, CableId iCable, const std::string& iName);
+        virtual void addDirectionalLight(const Vec3& iOrientation);
+        virtual void addCamera(const Pose& iPose);
+        virtual void addKeyboardControl(MechanismId iMechanism, MyCrane* iCrane);
+
+    private:
+        // @internal helpers
+        void _fillCableDefinition(VxSim::VxExtension* iCableExtension, const CableDefinition& iDefinition);
+
+    private:
+        bool mWithGraphics;
+        ControlLog* mControlLog;
+
+        Vx::VxSmartPtr<VxSim::VxScene> mScene;
+
+        // The handles are indices in these arrays.
+        std::vector< Vx::VxSmartPtr<VxSim::VxMechanism> > mMechanisms;
+        std::vector<Vx::VxAssembly*> mAssemblies;
+        std::vector<Vx::VxPart*> mParts;
+        std::vector<Vx::VxConstraint*> mConstraints;
+        // The coordinate index of the free coordinate of each constraint.
+        std::vector<int> mConstraintCoordinates;
+        std::vector<VxSim::VxExtension*> mCables;
+
+        // The names given at creation, so that the lookups neither scan the
+        // mechanisms with Vx::Find nor compare the pointers of every handle.
+        NameRegistry mAssemblyNameRegistry;
+        NameRegistry mPartNameRegistry;
+        NameRegistry mCableNameRegistry;
+    };
+}
+
+#endif // _VORTEX_SCENE_H
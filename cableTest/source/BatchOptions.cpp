@@ -0,0 +1,242 @@
+#include "BatchOptions.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+BatchOptions::BatchOptions()
+    : headless(false)
+    , sceneName("bricks")
+    , stepCount(0)
+    , simulationTime(0.0)
+    , timeStep(1.0 / 60.0)
+    , realTime(false)
+    , maxCatchUpSteps(4)
+    , substepCount(1)
+    , statsFileName()
+    , profileFileName()
+    , cableFileName()
+    , craneCount(4)
+    , cablesPerCrane(1)
+    , cableLength(40.0)
+    , sectionLength(0.0)
+    , pulleyCount(2)
+    , layout("grid")
+    , seed(1)
+    , adaptiveSections(false)
+    , implicitCables(false)
+    , threadCount(1)
+    , memoryReport(false)
+    , recordFileName()
+    , exportFileName()
+    , telemetryFileName()
+    , renderRate(0.0)
+    , recordControlsFileName()
+    , replayControlsFileName()
+    , motionFileName()
+    , saveCheckpointFileName()
+    , loadCheckpointFileName()
+{
+}
+
+bool BatchOptions::parse(int argc, const char* argv[])
+{
+    for (int i=1; i<argc; ++i)
+    {
+        const char* option = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if ( 0 == strcmp(option, "--headless") )
+        {
+            headless = true;
+        }
+        else if ( 0 == strcmp(option, "--scene") && hasValue )
+        {
+            sceneName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--steps") && hasValue )
+        {
+            stepCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--sim-time") && hasValue )
+        {
+            simulationTime = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--time-step") && hasValue )
+        {
+            timeStep = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--real-time") )
+        {
+            realTime = true;
+        }
+        else if ( 0 == strcmp(option, "--max-catch-up") && hasValue )
+        {
+            maxCatchUpSteps = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--substeps") && hasValue )
+        {
+            substepCount = atoi(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--stats") && hasValue )
+        {
+            statsFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--profile") && hasValue )
+        {
+            profileFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--cable") && hasValue )
+        {
+            cableFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--cranes") && hasValue )
+        {
+            craneCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--cables-per-crane") && hasValue )
+        {
+            cablesPerCrane = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--cable-length") && hasValue )
+        {
+            cableLength = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--section-length") && hasValue )
+        {
+            sectionLength = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--pulleys") && hasValue )
+        {
+            pulleyCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--layout") && hasValue )
+        {
+            layout = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--seed") && hasValue )
+        {
+            seed = static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--adaptive-sections") )
+        {
+            adaptiveSections = true;
+        }
+        else if ( 0 == strcmp(option, "--implicit-cables") )
+        {
+            implicitCables = true;
+        }
+        else if ( 0 == strcmp(option, "--threads") && hasValue )
+        {
+            threadCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--memory-report") )
+        {
+            memoryReport = true;
+        }
+        else if ( 0 == strcmp(option, "--record") && hasValue )
+        {
+            recordFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--export") && hasValue )
+        {
+            exportFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--telemetry") && hasValue )
+        {
+            telemetryFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--render-rate") && hasValue )
+        {
+            renderRate = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--record-controls") && hasValue )
+        {
+            recordControlsFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--replay-controls") && hasValue )
+        {
+            replayControlsFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--motion") && hasValue )
+        {
+            motionFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--save-checkpoint") && hasValue )
+        {
+            saveCheckpointFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--load-checkpoint") && hasValue )
+        {
+            loadCheckpointFileName = argv[++i];
+        }
+        else
+        {
+            std::cout << "Unknown or incomplete option " << option << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if ( (!replayControlsFileName.empty() || !motionFileName.empty()) && sceneName != "crane" )
+    {
+        std::cout << "The controls can only be replayed on the crane scene" << std::endl;
+        return false;
+    }
+
+    if ( layout != "grid" && layout != "random" )
+    {
+        std::cout << "The layout must be grid or random" << std::endl;
+        return false;
+    }
+
+    if ( craneCount < 1 || cablesPerCrane < 1 || pulleyCount < 1 )
+    {
+        std::cout << "The crane, cable per crane and pulley counts must be positive" << std::endl;
+        return false;
+    }
+
+    if ( timeStep <= 0.0 )
+    {
+        std::cout << "The time step must be positive" << std::endl;
+        return false;
+    }
+
+    if ( substepCount < 1 || maxCatchUpSteps < 1 )
+    {
+        std::cout << "The substep and catch up step counts must be positive" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+size_t BatchOptions::getMaxStepCount() const
+{
+    if ( stepCount > 0 )
+    {
+        return stepCount;
+    }
+
+    if ( simulationTime > 0.0 )
+    {
+        return static_cast<size_t>(ceil(simulationTime / timeStep));
+    }
+
+    return 0;
+}
+
+void BatchOptions::printUsage(const char* iProgramName) const
+{
+    std::cout << "Usage: " << iProgramName << " [--headless] [--scene bricks|crane|stress]"
+              << " [--steps n | --sim-time t [--time-step dt]] [--real-time [--max-catch-up n]]"
+              << " [--substeps n] [--stats file.json|file.csv]"
+              << " [--profile file.csv] [--cable file] [--adaptive-sections]"
+              << " [--cranes n] [--cables-per-crane n] [--cable-length l] [--section-length l]"
+              << " [--pulleys n] [--layout grid|random] [--seed n]"
+              << " [--implicit-cables] [--threads n] [--memory-report] [--record file]"
+              << " [--export file] [--telemetry file.csv] [--render-rate hz]"
+              << " [--record-controls file] [--replay-controls file] [--motion file]"
+              << " [--save-checkpoint file] [--load-checkpoint file]" << std::endl;
+}
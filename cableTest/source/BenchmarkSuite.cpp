@@ -0,0 +1,619 @@
+#include "BenchmarkSuite.h"
+#include "BrickScene.h"
+#include "ExCableSystem.h"
+#include "NativeScene.h"
+#include "StepStatistics.h"
+#include "StressScene.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using Sim::Vec3;
+
+static const double sTimeStep = 1.0 / 60.0;
+
+// Forget the peak resident set size of the process, so that the next
+// reading is the one of the case about to run. Only Linux can reset it;
+// elsewhere the peak is the one of the whole process so far.
+static void ResetPeakRss()
+{
+#if defined(__linux__)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+static double GetPeakRssKiB()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) )
+    {
+        return counters.PeakWorkingSetSize / 1024.0;
+    }
+    return -1.0;
+#else
+#if defined(__linux__)
+    // VmHWM follows the reset of ResetPeakRss(), ru_maxrss does not.
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while ( std::getline(status, line) )
+    {
+        if ( 0 == line.compare(0, 6, "VmHWM:") )
+        {
+            return atof(line.c_str() + 6);
+        }
+    }
+#endif
+    struct rusage usage;
+    if ( 0 != getrusage(RUSAGE_SELF, &usage) )
+    {
+        return -1.0;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024.0;
+#else
+    return static_cast<double>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Add a plane, like cableTestNative does.
+static void AddGroundPlane(Sim::NativeScene& ioScene)
+{
+    Sim::MechanismId mechanism = ioScene.createMechanism("groundMechanism");
+    Sim::AssemblyId assembly = ioScene.createAssembly(mechanism, "groundAssembly");
+    Sim::PartId plane = ioScene.createPart(assembly, Sim::PartDefinition("ground", Sim::kPartStatic, Vec3()));
+    ioScene.addPlane(plane);
+}
+
+static void BuildCrane(Sim::NativeScene& ioScene)
+{
+    AddGroundPlane(ioScene);
+    ExCableSystem cableSystem(ioScene);
+}
+
+static void BuildBricks(Sim::NativeScene& ioScene)
+{
+    CreateBrickScene(ioScene);
+}
+
+// A load dropping on a stiff breakable cable: the first bounce breaks it.
+static void BuildStiffBreakable(Sim::NativeScene& ioScene)
+{
+    Sim::MechanismId mechanism = ioScene.createMechanism("breakableMechanism");
+    Sim::AssemblyId assembly = ioScene.createAssembly(mechanism, "breakableAssembly");
+    Sim::PartId anchor = ioScene.createPart(assembly, Sim::PartDefinition("anchor", Sim::kPartAnimated, Vec3(0.0, 0.0, 20.0)));
+    ioScene.addBox(anchor, Vec3(1.0, 1.0, 1.0));
+    Sim::PartId load = ioScene.createPart(assembly, Sim::PartDefinition("load", Sim::kPartDynamic, Vec3(0.0, 0.0, 10.0), 300.0));
+    ioScene.addBox(load, Vec3(1.0, 1.0, 1.0));
+
+    Sim::CableDefinition definition;
+    definition.name = "breakableCable";
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, anchor, Vec3(0.0, 0.0, -0.5)));
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, load, Vec3(0.0, 0.0, 0.5)));
+    Sim::CableSegmentDefinition segment;
+    segment.index = definition.getSpanSegmentIndex(0);
+    segment.flexible = true;
+    segment.maxSectionLength = 1.0;
+    definition.segments.push_back(segment);
+    definition.params.axialStiffness = 100000.0;
+    definition.params.axialDamping = 200.0;
+    definition.params.enableBreakage = true;
+    definition.params.maxTension = 5000.0;
+    ioScene.createCable(mechanism, definition);
+}
+
+// A cable of iSectionCount sections of 0.5 m stretched between two anchors
+// exactly its length apart: it starts taut and only sags by stretching.
+static void BuildCable(Sim::NativeScene& ioScene, size_t iSectionCount)
+{
+    const double length = 0.5 * iSectionCount;
+
+    Sim::MechanismId mechanism = ioScene.createMechanism("cableMechanism");
+    Sim::AssemblyId assembly = ioScene.createAssembly(mechanism, "cableAssembly");
+    Sim::PartId start = ioScene.createPart(assembly, Sim::PartDefinition("start", Sim::kPartAnimated, Vec3(0.0, 0.0, 20.0)));
+    Sim::PartId end = ioScene.createPart(assembly, Sim::PartDefinition("end", Sim::kPartAnimated, Vec3(length, 0.0, 20.0)));
+
+    Sim::CableDefinition definition;
+    definition.name = "cable";
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, start));
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, end));
+    Sim::CableSegmentDefinition segment;
+    segment.index = definition.getSpanSegmentIndex(0);
+    segment.flexible = true;
+    segment.maxSectionLength = 0.5;
+    segment.minSectionLength = 0.1;
+    definition.segments.push_back(segment);
+    ioScene.createCable(mechanism, definition);
+}
+
+static void BuildCable10(Sim::NativeScene& ioScene)
+{
+    BuildCable(ioScene, 10);
+}
+
+static void BuildCable100(Sim::NativeScene& ioScene)
+{
+    BuildCable(ioScene, 100);
+}
+
+static void BuildCable1000(Sim::NativeScene& ioScene)
+{
+    BuildCable(ioScene, 1000);
+}
+
+static void BuildCranes(Sim::NativeScene& ioScene, size_t iCraneCount)
+{
+    AddGroundPlane(ioScene);
+    StressScene::Settings settings;
+    settings.craneCount = iCraneCount;
+    StressScene stressScene(ioScene, settings);
+}
+
+static void BuildCranes4(Sim::NativeScene& ioScene)
+{
+    BuildCranes(ioScene, 4);
+}
+
+static void BuildCranes16(Sim::NativeScene& ioScene)
+{
+    BuildCranes(ioScene, 16);
+}
+
+// Minimal reader of the JSON written by the suite: objects, arrays,
+// strings without escapes other than \" and \\, numbers, true, false, null.
+namespace
+{
+    struct JsonValue
+    {
+        enum Type { kNull, kNumber, kString, kObject, kArray };
+
+        JsonValue() : type(kNull), number(0.0) {}
+
+        const JsonValue* find(const std::string& iKey) const
+        {
+            for (size_t i=0; i<members.size(); ++i)
+            {
+                if ( members[i].first == iKey )
+                {
+                    return &members[i].second;
+                }
+            }
+            return NULL;
+        }
+
+        Type type;
+        double number;
+        std::string text;
+        std::vector< std::pair<std::string, JsonValue> > members;
+        std::vector<JsonValue> items;
+    };
+
+    class JsonReader
+    {
+    public:
+        explicit JsonReader(const std::string& iText) : mText(iText), mPosition(0) {}
+
+        bool read(JsonValue& oValue)
+        {
+            return _readValue(oValue) && (_skipSpaces(), mPosition == mText.size());
+        }
+
+    private:
+        void _skipSpaces()
+        {
+            while ( mPosition < mText.size() && isspace(static_cast<unsigned char>(mText[mPosition])) )
+            {
+                ++mPosition;
+            }
+        }
+
+        bool _accept(char iCharacter)
+        {
+            _skipSpaces();
+            if ( mPosition < mText.size() && mText[mPosition] == iCharacter )
+            {
+                ++mPosition;
+                return true;
+            }
+            return false;
+        }
+
+        bool _readString(std::string& oText)
+        {
+            if ( !_accept('"') )
+            {
+                return false;
+            }
+            oText.clear();
+            while ( mPosition < mText.size() && mText[mPosition] != '"' )
+            {
+                if ( mText[mPosition] == '\\' && mPosition + 1 < mText.size() )
+                {
+                    ++mPosition;
+                }
+                oText += mText[mPosition++];
+            }
+            return _accept('"');
+        }
+
+        bool _readValue(JsonValue& oValue)
+        {
+            _skipSpaces();
+            if ( mPosition >= mText.size() )
+            {
+                return false;
+            }
+
+            const char next = mText[mPosition];
+            if ( next == '{' )
+            {
+                ++mPosition;
+                oValue.type = JsonValue::kObject;
+                if ( _accept('}') )
+                {
+                    return true;
+                }
+                do
+                {
+                    std::pair<std::string, JsonValue> member;
+                    if ( !_readString(member.first) || !_accept(':') || !_readValue(member.second) )
+                    {
+                        return false;
+                    }
+                    oValue.members.push_back(member);
+                } while ( _accept(',') );
+                return _accept('}');
+            }
+            if ( next == '[' )
+            {
+                ++mPosition;
+                oValue.type = JsonValue::kArray;
+                if ( _accept(']') )
+                {
+                    return true;
+                }
+                do
+                {
+                    oValue.items.push_back(JsonValue());
+                    if ( !_readValue(oValue.items.back()) )
+                    {
+                        return false;
+                    }
+                } while ( _accept(',') );
+                return _accept(']');
+            }
+            if ( next == '"' )
+            {
+                oValue.type = JsonValue::kString;
+                return _readString(oValue.text);
+            }
+
+            // Numbers and the literals; true counts as 1.
+            const size_t start = mPosition;
+            while ( mPosition < mText.size() && (isalnum(static_cast<unsigned char>(mText[mPosition])) || strchr("+-.", mText[mPosition])) )
+            {
+                ++mPosition;
+            }
+            const std::string token = mText.substr(start, mPosition - start);
+            if ( token == "null" || token == "false" || token == "true" )
+            {
+                oValue.type = token == "null" ? JsonValue::kNull : JsonValue::kNumber;
+                oValue.number = token == "true" ? 1.0 : 0.0;
+                return true;
+            }
+            char* end = NULL;
+            oValue.type = JsonValue::kNumber;
+            oValue.number = strtod(token.c_str(), &end);
+            return !token.empty() && *end == '\0';
+        }
+
+    private:
+        const std::string& mText;
+        size_t mPosition;
+    };
+}
+
+BenchmarkSuite::Thresholds::Thresholds()
+    : p50Ratio(1.25)
+    , p99Ratio(2.0)
+    , timeSlackMs(0.05)
+    , allocationsPerStep(0.5)
+    , peakRssRatio(1.25)
+{
+}
+
+BenchmarkSuite::BenchmarkSuite()
+    : mCases()
+    , mAllocationCounter(NULL)
+    , mThresholds()
+    , mResults()
+    , mBaseline()
+{
+    const Case cases[] =
+    {
+        { "crane", "ExCableSystem crane holding its load", BuildCrane, 600 },
+        { "bricks", "Two-brick cable pair of the brick scene", BuildBricks, 600 },
+        { "stiff_breakable", "Load breaking a stiff cable on its first bounce", BuildStiffBreakable, 600 },
+        { "cable_10", "Cable of 10 sections taut between two anchors", BuildCable10, 600 },
+        { "cable_100", "Cable of 100 sections taut between two anchors", BuildCable100, 300 },
+        { "cable_1000", "Cable of 1000 sections taut between two anchors", BuildCable1000, 120 },
+        { "cranes_4", "Stress scene of 4 cranes", BuildCranes4, 300 },
+        { "cranes_16", "Stress scene of 16 cranes", BuildCranes16, 60 }
+    };
+    mCases.assign(cases, cases + sizeof(cases) / sizeof(cases[0]));
+}
+
+bool BenchmarkSuite::run(const std::vector<std::string>& iNames, size_t iStepCount)
+{
+    std::vector<const Case*> selected;
+    for (size_t i=0; i<iNames.size(); ++i)
+    {
+        const Case* found = NULL;
+        for (size_t c=0; c<mCases.size() && NULL == found; ++c)
+        {
+            found = mCases[c].name == iNames[i] ? &mCases[c] : NULL;
+        }
+        if ( NULL == found )
+        {
+            std::cout << "Unknown benchmark case " << iNames[i] << std::endl;
+            return false;
+        }
+        selected.push_back(found);
+    }
+    if ( iNames.empty() )
+    {
+        for (size_t c=0; c<mCases.size(); ++c)
+        {
+            selected.push_back(&mCases[c]);
+        }
+    }
+
+    mResults.clear();
+    for (size_t i=0; i<selected.size(); ++i)
+    {
+        mResults.push_back(_runCase(*selected[i], iStepCount > 0 ? iStepCount : selected[i]->stepCount));
+    }
+
+    return true;
+}
+
+BenchmarkSuite::Result BenchmarkSuite::_runCase(const Case& iCase, size_t iStepCount) const
+{
+    ResetPeakRss();
+
+    Result result;
+    result.name = iCase.name;
+    result.stepCount = iStepCount;
+    result.allocationsPerStep = -1.0;
+
+    StepStatistics statistics;
+    statistics.reserve(iStepCount);
+    {
+        Sim::NativeScene scene;
+        iCase.builder(scene);
+
+        const size_t allocationCount = mAllocationCounter ? mAllocationCounter() : 0;
+        for (size_t i=0; i<iStepCount; ++i)
+        {
+            const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+            scene.step(sTimeStep);
+            const std::chrono::steady_clock::time_point stepEnd = std::chrono::steady_clock::now();
+            statistics.addStep(std::chrono::duration<double>(stepEnd - stepStart).count());
+        }
+        if ( mAllocationCounter && iStepCount > 0 )
+        {
+            result.allocationsPerStep = static_cast<double>(mAllocationCounter() - allocationCount) / iStepCount;
+        }
+
+        // Read before the scene frees its memory.
+        result.peakRssKiB = GetPeakRssKiB();
+    }
+
+    const StepStatistics::Summary summary = statistics.computeSummary();
+    result.mean = summary.mean;
+    result.p50 = summary.p50;
+    result.p90 = summary.p90;
+    result.p99 = summary.p99;
+    result.max = summary.max;
+    result.status = "new";
+    return result;
+}
+
+bool BenchmarkSuite::loadBaseline(const std::string& iFileName)
+{
+    std::ifstream file(iFileName.c_str());
+    if ( !file )
+    {
+        std::cout << "Cannot open the baseline " << iFileName << std::endl;
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+
+    const std::string content = text.str();
+    JsonValue root;
+    JsonReader reader(content);
+    const JsonValue* cases = NULL;
+    if ( !reader.read(root) || NULL == (cases = root.find("cases")) || JsonValue::kArray != cases->type )
+    {
+        std::cout << "The baseline " << iFileName << " is not a benchmark results file" << std::endl;
+        return false;
+    }
+
+    mBaseline.clear();
+    for (size_t i=0; i<cases->items.size(); ++i)
+    {
+        const JsonValue& item = cases->items[i];
+        const JsonValue* name = item.find("name");
+        if ( NULL == name || JsonValue::kString != name->type )
+        {
+            continue;
+        }
+        std::map<std::string, double>& values = mBaseline[name->text];
+        for (size_t m=0; m<item.members.size(); ++m)
+        {
+            if ( JsonValue::kNumber == item.members[m].second.type )
+            {
+                values[item.members[m].first] = item.members[m].second.number;
+            }
+        }
+    }
+
+    // The thresholds of the baseline replace the defaults.
+    const JsonValue* thresholds = root.find("thresholds");
+    if ( NULL != thresholds )
+    {
+        const char* keys[] = { "p50_ratio", "p99_ratio", "time_slack_ms", "allocations_per_step", "peak_rss_ratio" };
+        double* values[] = { &mThresholds.p50Ratio, &mThresholds.p99Ratio, &mThresholds.timeSlackMs, &mThresholds.allocationsPerStep, &mThresholds.peakRssRatio };
+        for (size_t k=0; k<sizeof(keys) / sizeof(keys[0]); ++k)
+        {
+            const JsonValue* value = thresholds->find(keys[k]);
+            if ( NULL != value && JsonValue::kNumber == value->type )
+            {
+                *values[k] = value->number;
+            }
+        }
+    }
+
+    return true;
+}
+
+// A value regresses when it is above its baseline value times the ratio
+// plus the slack; the allocations, that do not depend on the machine, only
+// get the slack.
+bool BenchmarkSuite::compare()
+{
+    bool passed = true;
+    for (size_t i=0; i<mResults.size(); ++i)
+    {
+        Result& result = mResults[i];
+        result.regressions.clear();
+        std::map< std::string, std::map<std::string, double> >::const_iterator baseline = mBaseline.find(result.name);
+        if ( baseline == mBaseline.end() )
+        {
+            result.status = "new";
+            continue;
+        }
+
+        struct Check
+        {
+            const char* key;
+            double value;
+            double ratio;
+            double slack;
+        };
+        const Check checks[] =
+        {
+            { "p50_ms", result.p50 * 1e3, mThresholds.p50Ratio, mThresholds.timeSlackMs },
+            { "p99_ms", result.p99 * 1e3, mThresholds.p99Ratio, mThresholds.timeSlackMs },
+            { "allocations_per_step", result.allocationsPerStep, 1.0, mThresholds.allocationsPerStep },
+            { "peak_rss_kib", result.peakRssKiB, mThresholds.peakRssRatio, 0.0 }
+        };
+        for (size_t c=0; c<sizeof(checks) / sizeof(checks[0]); ++c)
+        {
+            std::map<std::string, double>::const_iterator reference = baseline->second.find(checks[c].key);
+            if ( reference == baseline->second.end() || reference->second < 0.0 || checks[c].value < 0.0 )
+            {
+                continue;
+            }
+
+            const double limit = reference->second * checks[c].ratio + checks[c].slack;
+            if ( checks[c].value > limit )
+            {
+                std::ostringstream regression;
+                regression << checks[c].key << " " << checks[c].value << " > " << limit;
+                result.regressions.push_back(regression.str());
+            }
+        }
+
+        result.status = result.regressions.empty() ? "pass" : "fail";
+        passed = passed && result.regressions.empty();
+    }
+
+    return passed;
+}
+
+bool BenchmarkSuite::writeJson(const std::string& iFileName) const
+{
+    std::ofstream file(iFileName.c_str());
+    if ( !file )
+    {
+        std::cout << "Cannot open the benchmark results file " << iFileName << std::endl;
+        return false;
+    }
+
+    _writeJson(file);
+    return !file.fail();
+}
+
+void BenchmarkSuite::_writeJson(std::ostream& oStream) const
+{
+    oStream << std::setprecision(9);
+    oStream << "{\n";
+    oStream << "  \"thresholds\": {\n";
+    oStream << "    \"p50_ratio\": " << mThresholds.p50Ratio << ",\n";
+    oStream << "    \"p99_ratio\": " << mThresholds.p99Ratio << ",\n";
+    oStream << "    \"time_slack_ms\": " << mThresholds.timeSlackMs << ",\n";
+    oStream << "    \"allocations_per_step\": " << mThresholds.allocationsPerStep << ",\n";
+    oStream << "    \"peak_rss_ratio\": " << mThresholds.peakRssRatio << "\n";
+    oStream << "  },\n";
+    oStream << "  \"cases\": [\n";
+    for (size_t i=0; i<mResults.size(); ++i)
+    {
+        const Result& result = mResults[i];
+        oStream << "    {\n";
+        oStream << "      \"name\": \"" << result.name << "\",\n";
+        oStream << "      \"steps\": " << result.stepCount << ",\n";
+        oStream << "      \"mean_ms\": " << result.mean * 1e3 << ",\n";
+        oStream << "      \"p50_ms\": " << result.p50 * 1e3 << ",\n";
+        oStream << "      \"p90_ms\": " << result.p90 * 1e3 << ",\n";
+        oStream << "      \"p99_ms\": " << result.p99 * 1e3 << ",\n";
+        oStream << "      \"max_ms\": " << result.max * 1e3 << ",\n";
+        oStream << "      \"allocations_per_step\": " << result.allocationsPerStep << ",\n";
+        oStream << "      \"peak_rss_kib\": " << result.peakRssKiB << ",\n";
+        oStream << "      \"status\": \"" << result.status << "\",\n";
+        oStream << "      \"regressions\": [";
+        for (size_t r=0; r<result.regressions.size(); ++r)
+        {
+            oStream << (r > 0 ? ", " : "") << "\"" << result.regressions[r] << "\"";
+        }
+        oStream << "]\n";
+        oStream << "    }" << (i + 1 < mResults.size() ? "," : "") << "\n";
+    }
+    oStream << "  ]\n";
+    oStream << "}\n";
+}
+
+void BenchmarkSuite::printResults() const
+{
+    for (size_t i=0; i<mResults.size(); ++i)
+    {
+        const Result& result = mResults[i];
+        std::cout << std::left << std::setw(16) << result.name << std::right
+                  << " p50 = " << std::setw(9) << result.p50 * 1e3 << " ms"
+                  << ", p90 = " << std::setw(9) << result.p90 * 1e3 << " ms"
+                  << ", p99 = " << std::setw(9) << result.p99 * 1e3 << " ms"
+                  << ", " << result.allocationsPerStep << " allocations/step"
+                  << ", peak RSS = " << result.peakRssKiB / 1024.0 << " MiB"
+                  << "  [" << result.status << "]" << std::endl;
+        for (size_t r=0; r<result.regressions.size(); ++r)
+        {
+            std::cout << "    regression: " << result.regressions[r] << std::endl;
+        }
+    }
+}
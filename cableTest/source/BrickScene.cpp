@@ -0,0 +1,69 @@
+#include "BrickScene.h"
+
+using Sim::Vec3;
+
+// Create a cable with a single flexible segment between two attachment points.
+static Sim::CableDefinition CreateBrickCableDefinition(const std::string& name, Sim::PartId start, Sim::PartId end)
+{
+    Sim::CableDefinition definition;
+    definition.name = name;
+
+	const Vec3 offset(0.5,0,0); // Needed to attach on the top of the load and not at the center of mass.
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, start, offset));
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, end, offset));
+
+    Sim::CableSegmentDefinition lastSegmentDefinition;
+    lastSegmentDefinition.index = definition.getSpanSegmentIndex(0);
+    lastSegmentDefinition.flexible = true;
+    lastSegmentDefinition.maxSectionLength = 11.0;
+    lastSegmentDefinition.minSectionLength = 0.2;
+	lastSegmentDefinition.fixedLength = true;
+    definition.segments.push_back(lastSegmentDefinition);
+
+	definition.params.collisionGeometryType = 2;
+
+    return definition;
+}
+
+Sim::MechanismId CreateBrickScene(Sim::IScene& iScene, bool iImplicitCables)
+{
+	/** Alex's test **/
+    Sim::MechanismId mechanism = iScene.createMechanism("cableTestMechanism");
+	Sim::AssemblyId assembly = iScene.createAssembly(mechanism, "cableTestAssembly");
+
+	Sim::PartId bPart = iScene.createPart(assembly, Sim::PartDefinition("testBrick", Sim::kPartAnimated, Vec3(0, 20.0, 3.0)));
+	iScene.addBox(bPart, Vec3(0.5, 10.0, 0.5));
+
+	Sim::PartId brick2 = iScene.createPart(assembly, Sim::PartDefinition("brick_1", Sim::kPartDynamic, Vec3(5.0, 20.0, 10.0)));
+	iScene.addBox(brick2, Vec3(1.0, 1.0, 1.0));
+
+	Sim::PartId brick3 = iScene.createPart(assembly, Sim::PartDefinition("brick_3", Sim::kPartAnimated, Vec3(0.0, 30.0, 5.0)));
+	iScene.addBox(brick3, Vec3(1.0, 1.0, 1.0));
+
+	Sim::PartId brick4 = iScene.createPart(assembly, Sim::PartDefinition("brick_4", Sim::kPartAnimated, Vec3(0.0, 10.0, 5.0)));
+	iScene.addBox(brick4, Vec3(1.0, 1.0, 1.0));
+
+	Sim::PartId brick = iScene.createPart(assembly, Sim::PartDefinition("brick_2", Sim::kPartDynamic, Vec3(-5.0, 20.0, 10.0)));
+	iScene.addBox(brick, Vec3(1.0, 1.0, 1.0));
+
+	Sim::CableDefinition definition = CreateBrickCableDefinition("testCableExtension", brick, brick2);
+    definition.params.axialStiffness = 100.0;
+    definition.params.axialDamping = 20.0;
+    definition.params.implicitAxial = iImplicitCables;
+	Sim::CableId cable = iScene.createCable(mechanism, definition);
+
+	Sim::CableDefinition definition2 = CreateBrickCableDefinition("testCableExtension2", brick3, brick4);
+    definition2.params.axialStiffness = 100000.0;
+    definition2.params.axialDamping = 200.0;
+	definition2.params.enableBreakage = true;
+	definition2.params.maxTension = 1000.0;
+    definition2.params.implicitAxial = iImplicitCables;
+	Sim::CableId cable2 = iScene.createCable(mechanism, definition2);
+
+   // The cable system is displayed with a graphic extension since it is not
+   // in Vortex by default, unlike the collision geometries.
+   iScene.addCableGraphics(mechanism, cable, "cableTestGraphics");
+   iScene.addCableGraphics(mechanism, cable2, "cableTestGraphics2");
+
+    return mechanism;
+}
@@ -0,0 +1,237 @@
+#include "CableBroadphase.h"
+#include "CableChain.h"
+
+namespace Sim
+{
+    CableBroadphase::CableBroadphase()
+        : mSectionCount(0)
+        , mLeafCount(0)
+        , mLayoutRevision(static_cast<size_t>(-1))
+        , mRefitCount(0)
+        , mBoxes()
+        , mEmpty()
+        , mStack()
+        , mPairStack()
+    {
+    }
+
+    bool CableBroadphase::update(const CableChain& iChain, double iRadius, double iMargin)
+    {
+        if ( iChain.getLayoutRevision() != mLayoutRevision || iChain.getSectionCount() != mSectionCount )
+        {
+            _rebuild(iChain, iRadius, iMargin);
+            return true;
+        }
+
+        mRefitCount = 0;
+        for (size_t i=0; i<mSectionCount; ++i)
+        {
+            // A section that broke empties its box.
+            const Aabb box = _getSectionBox(iChain, i, iRadius);
+            Aabb& fat = mBoxes[mLeafCount + i];
+            if ( box.isEmpty() ? fat.isEmpty() : fat.contains(box) )
+            {
+                continue;
+            }
+
+            fat = box;
+            if ( !box.isEmpty() )
+            {
+                fat.inflate(iMargin);
+            }
+            ++mRefitCount;
+
+            // Refit the branch up to the first box that does not change.
+            for (size_t k=(mLeafCount + i) / 2; k>0; k/=2)
+            {
+                Aabb parent = mBoxes[2 * k];
+                parent.add(mBoxes[2 * k + 1]);
+                if ( parent == mBoxes[k] )
+                {
+                    break;
+                }
+                mBoxes[k] = parent;
+            }
+        }
+
+        return mRefitCount > 0;
+    }
+
+    void CableBroadphase::query(const Aabb& iBox, std::vector<size_t>& oSections)
+    {
+        if ( 0 == mSectionCount )
+        {
+            return;
+        }
+
+        // The right child is pushed first, so the sections come out in order.
+        mStack.clear();
+        mStack.push_back(1);
+        while ( !mStack.empty() )
+        {
+            const size_t k = mStack.back();
+            mStack.pop_back();
+            if ( !mBoxes[k].overlaps(iBox) )
+            {
+                continue;
+            }
+
+            if ( _isLeaf(k) )
+            {
+                oSections.push_back(k - mLeafCount);
+            }
+            else
+            {
+                mStack.push_back(2 * k + 1);
+                mStack.push_back(2 * k);
+            }
+        }
+    }
+
+    // The tree is complete, so the two nodes of a pair are always at the same
+    // depth: both are leaves or neither is.
+    void CableBroadphase::findSelfPairs(std::vector<SectionPair>& oPairs)
+    {
+        if ( 0 == mSectionCount )
+        {
+            return;
+        }
+
+        mPairStack.clear();
+        mPairStack.push_back(SectionPair(1, 1));
+        while ( !mPairStack.empty() )
+        {
+            const SectionPair pair = mPairStack.back();
+            mPairStack.pop_back();
+            const size_t a = pair.first;
+            const size_t b = pair.second;
+
+            if ( a == b )
+            {
+                if ( !_isLeaf(a) && !mBoxes[a].isEmpty() )
+                {
+                    mPairStack.push_back(SectionPair(2 * a, 2 * a));
+                    mPairStack.push_back(SectionPair(2 * a + 1, 2 * a + 1));
+                    mPairStack.push_back(SectionPair(2 * a, 2 * a + 1));
+                }
+                continue;
+            }
+
+            if ( !mBoxes[a].overlaps(mBoxes[b]) )
+            {
+                continue;
+            }
+
+            if ( _isLeaf(a) )
+            {
+                // a is left of b; the neighbours share a node.
+                const size_t i = a - mLeafCount;
+                const size_t j = b - mLeafCount;
+                if ( j > i + 1 )
+                {
+                    oPairs.push_back(SectionPair(i, j));
+                }
+                continue;
+            }
+
+            mPairStack.push_back(SectionPair(2 * a, 2 * b));
+            mPairStack.push_back(SectionPair(2 * a, 2 * b + 1));
+            mPairStack.push_back(SectionPair(2 * a + 1, 2 * b));
+            mPairStack.push_back(SectionPair(2 * a + 1, 2 * b + 1));
+        }
+    }
+
+    // The trees may have different depths: the node that is not a leaf yet
+    // is split, or both when neither is.
+    void CableBroadphase::findPairs(const CableBroadphase& iOther, std::vector<SectionPair>& oPairs)
+    {
+        if ( 0 == mSectionCount || 0 == iOther.mSectionCount )
+        {
+            return;
+        }
+
+        mPairStack.clear();
+        mPairStack.push_back(SectionPair(1, 1));
+        while ( !mPairStack.empty() )
+        {
+            const SectionPair pair = mPairStack.back();
+            mPairStack.pop_back();
+            const size_t a = pair.first;
+            const size_t b = pair.second;
+            if ( !mBoxes[a].overlaps(iOther.mBoxes[b]) )
+            {
+                continue;
+            }
+
+            const bool leafA = _isLeaf(a);
+            const bool leafB = iOther._isLeaf(b);
+            if ( leafA && leafB )
+            {
+                oPairs.push_back(SectionPair(a - mLeafCount, b - iOther.mLeafCount));
+            }
+            else if ( leafA )
+            {
+                mPairStack.push_back(SectionPair(a, 2 * b));
+                mPairStack.push_back(SectionPair(a, 2 * b + 1));
+            }
+            else if ( leafB )
+            {
+                mPairStack.push_back(SectionPair(2 * a, b));
+                mPairStack.push_back(SectionPair(2 * a + 1, b));
+            }
+            else
+            {
+                mPairStack.push_back(SectionPair(2 * a, 2 * b));
+                mPairStack.push_back(SectionPair(2 * a, 2 * b + 1));
+                mPairStack.push_back(SectionPair(2 * a + 1, 2 * b));
+                mPairStack.push_back(SectionPair(2 * a + 1, 2 * b + 1));
+            }
+        }
+    }
+
+    size_t CableBroadphase::getMemoryUsage() const
+    {
+        return mBoxes.capacity() * sizeof(Aabb) + mStack.capacity() * sizeof(size_t) + mPairStack.capacity() * sizeof(SectionPair);
+    }
+
+    void CableBroadphase::_rebuild(const CableChain& iChain, double iRadius, double iMargin)
+    {
+        mSectionCount = iChain.getSectionCount();
+        mLayoutRevision = iChain.getLayoutRevision();
+        mLeafCount = 1;
+        while ( mLeafCount < mSectionCount )
+        {
+            mLeafCount *= 2;
+        }
+
+        mBoxes.assign(2 * mLeafCount, Aabb());
+        for (size_t i=0; i<mSectionCount; ++i)
+        {
+            Aabb& fat = mBoxes[mLeafCount + i];
+            fat = _getSectionBox(iChain, i, iRadius);
+            if ( !fat.isEmpty() )
+            {
+                fat.inflate(iMargin);
+            }
+        }
+        for (size_t k=mLeafCount-1; k>0; --k)
+        {
+            mBoxes[k] = mBoxes[2 * k];
+            mBoxes[k].add(mBoxes[2 * k + 1]);
+        }
+        mRefitCount = mSectionCount;
+    }
+
+    Aabb CableBroadphase::_getSectionBox(const CableChain& iChain, size_t iSection, double iRadius) const
+    {
+        Aabb box;
+        if ( iChain.isSectionBroken(iSection) )
+        {
+            return box;
+        }
+        box.add(iChain.getNodePosition(iSection));
+        box.add(iChain.getNodePosition(iSection + 1));
+        box.inflate(iRadius);
+        return box;
+    }
+}
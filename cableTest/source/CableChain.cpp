@@ -0,0 +1,898 @@
+#include "CableChain.h"
+#include "TrajectoryFormat.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Two neighbour sections merge when together they are shorter than this
+// ratio of the maximum section length. It is below 1 so that the merged
+// section is not split again right away.
+static const double sMergeRatio = 0.75;
+
+// Refinement of the adaptive sections, see CableChain::_needsDetail(). A free
+// node needs detail when the cable turns by more than 10 degrees at the node
+// or the tension changes by more than 10% across it; the sections around it
+// merge again only once the turn is below 3 degrees and the change below 2%.
+static const double sSplitBendCosine = 0.98480775301220802;  // cos(10 deg)
+static const double sMergeBendCosine = 0.99862953475457383;  // cos(3 deg)
+static const double sSplitTensionJump = 0.1;
+static const double sMergeTensionJump = 0.02;
+
+// The halves of an adaptive split are at least this ratio of the minimum
+// length, so that they do not slide below it and merge right back.
+static const double sSplitMargin = 1.25;
+
+// Length error, in ratio of the rest length, below which the chain is
+// solved and the implicit solve does no further iteration: 0.1 mm on a 1 m
+// section.
+static const double sImplicitTolerance = 1e-4;
+
+// Strain added to the tension of reference of the tension changes, so that
+// the noise of a slack cable is not taken for a tension gradient.
+static const double sTensionJumpFloorStrain = 1e-2;
+
+// Number of sections of a span of iSpanLength; the segments that are not
+// flexible keep a single section.
+static size_t GetSpanSectionCount(const Sim::CableSegmentDefinition* iSegment, double iSpanLength)
+{
+    if ( NULL == iSegment || !iSegment->flexible )
+    {
+        return 1;
+    }
+
+    size_t sectionCount = static_cast<size_t>(std::ceil(iSpanLength / iSegment->maxSectionLength));
+    if ( sectionCount > 1 && iSpanLength / sectionCount < iSegment->minSectionLength )
+    {
+        sectionCount = static_cast<size_t>(iSpanLength / iSegment->minSectionLength);
+    }
+    return std::max<size_t>(sectionCount, 1);
+}
+
+// Reallocate iArray with room for iCapacity elements.
+template <class T>
+static void SetCapacity(std::vector<T>& iArray, size_t iCapacity)
+{
+    std::vector<T> resized;
+    resized.reserve(iCapacity);
+    resized.assign(iArray.begin(), iArray.end());
+    iArray.swap(resized);
+}
+
+template <class T>
+static void SetCapacity(Sim::ChainArray<T>& iArray, size_t iCapacity)
+{
+    iArray.setCapacity(iCapacity);
+}
+
+template <class T>
+static size_t GetMemoryUsage(const std::vector<T>& iArray)
+{
+    return iArray.capacity() * sizeof(T);
+}
+
+template <class T>
+static size_t GetMemoryUsage(const Sim::ChainArray<T>& iArray)
+{
+    return iArray.getMemoryUsage();
+}
+
+static void PutArray(std::vector<unsigned char>& oBuffer, const Sim::ChainArray<double>& iArray)
+{
+    for (size_t i=0; i<iArray.size(); ++i)
+    {
+        TrajectoryFormat::PutF64(oBuffer, iArray[i]);
+    }
+}
+
+static bool GetArray(const unsigned char*& ioData, const unsigned char* iEnd, size_t iCount, Sim::ChainArray<double>& oArray)
+{
+    oArray.resize(iCount);
+    for (size_t i=0; i<iCount; ++i)
+    {
+        if ( !TrajectoryFormat::GetF64(ioData, iEnd, oArray[i]) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace Sim
+{
+    CableChain::CableChain()
+        : mDefinition()
+        , mCollide(false)
+        , mBroken(false)
+        , mBreaks()
+        , mRestoredBreakCount(0)
+        , mLayoutRevision(0)
+        , mDeployableNodeCount(0)
+    {
+    }
+
+    void CableChain::build(const CableDefinition& iDefinition, const std::vector<Vec3>& iPointPositions)
+    {
+        mDefinition = iDefinition;
+        mBroken = false;
+        mBreaks.clear();
+        mRestoredBreakCount = 0;
+        ++mLayoutRevision;
+        mCollide = iDefinition.params.collisionGeometryType >= 0;
+        for (size_t i=0; i<iDefinition.segments.size(); ++i)
+        {
+            mCollide = mCollide || iDefinition.segments[i].collisionGeometryType >= 0;
+        }
+
+        // Size the arrays once for all the nodes instead of growing them
+        // node by node, and for the sections the winch adds to the first
+        // span when it pays out the deployable length.
+        size_t nodeCount = iDefinition.points.size();
+        double restLength = 0.0;
+        for (size_t i=0; i+1<iDefinition.points.size(); ++i)
+        {
+            const CableSegmentDefinition* segment = iDefinition.findSegment(iDefinition.getSpanSegmentIndex(i));
+            const double spanLength = length(iPointPositions[i + 1] - iPointPositions[i]);
+            nodeCount += GetSpanSectionCount(segment, spanLength) - 1;
+            restLength += spanLength;
+        }
+        if ( iDefinition.points.size() > 1 && iDefinition.params.deployableLength > restLength )
+        {
+            const CableSegmentDefinition* segment = iDefinition.findSegment(iDefinition.getSpanSegmentIndex(0));
+            const double spanLength = length(iPointPositions[1] - iPointPositions[0]);
+            nodeCount += GetSpanSectionCount(segment, spanLength + iDefinition.params.deployableLength - restLength) - GetSpanSectionCount(segment, spanLength);
+        }
+        mDeployableNodeCount = nodeCount;
+        _fitCapacity(nodeCount);
+
+        for (size_t i=0; i<iDefinition.points.size(); ++i)
+        {
+            const CablePointDefinition& point = iDefinition.points[i];
+            _addNode(iPointPositions[i], point.part, kCableRing != point.type ? point.offset : Vec3());
+
+            if ( i + 1 == iDefinition.points.size() )
+            {
+                break;
+            }
+
+            const Vec3& start = iPointPositions[i];
+            const Vec3& end = iPointPositions[i + 1];
+            const double spanLength = length(end - start);
+            const CableSegmentDefinition* segment = iDefinition.findSegment(iDefinition.getSpanSegmentIndex(i));
+            const size_t sectionCount = GetSpanSectionCount(segment, spanLength);
+
+            for (size_t s=0; s<sectionCount; ++s)
+            {
+                _addSection(spanLength / sectionCount, segment);
+                // The end node is added with the next point.
+                if ( s + 1 < sectionCount )
+                {
+                    _addNode(start + (end - start) * (static_cast<double>(s + 1) / sectionCount), kInvalidId, Vec3());
+                }
+            }
+        }
+
+        _updateNodeMasses();
+        _fitCapacity(mX.size());
+    }
+
+    void CableChain::predict(double h, const Vec3& iGravity)
+    {
+        if ( mX.empty() )
+        {
+            return;
+        }
+        CableKernels::predict(_getKernelChain(), h, iGravity.x, iGravity.y, iGravity.z);
+    }
+
+    // The cable slides through the pulleys and rings: rest length moves from
+    // the span with the lower tension to the span with the higher tension on
+    // each side of a pass-through node, like over a frictionless sheave.
+    // The tensions are the ones of the previous substep.
+    //
+    // The length passes through the node like the cable over the sheave:
+    // only the two sections at the node get and lose length, the others keep
+    // theirs. A span winched in or out then splits or merges its sections at
+    // the node one at a time, rather than all of them at once when they all
+    // scale together.
+    void CableChain::slide()
+    {
+        const double stiffness = mDefinition.params.axialStiffness;
+
+        // The first node is the winch or an attachment, the last one an
+        // attachment; only the pinned nodes between them slide.
+        for (size_t middle=1; middle<mRestLength.size(); ++middle)
+        {
+            if ( kInvalidId == mNodePart[middle] || isSectionBroken(middle - 1) || isSectionBroken(middle) )
+            {
+                continue;
+            }
+
+            // Half of the length that equalizes the tensions of the two
+            // sections at the node, as two springs in series; all of it with
+            // the implicit solve, which has fewer substeps to slide in. The
+            // solve then passes the change on to the rest of the spans.
+            const double restBefore = mRestLength[middle - 1];
+            const double restAfter = mRestLength[middle];
+            const double transfer = (mDefinition.params.implicitAxial ? 1.0 : 0.5) * (mTension[middle - 1] - mTension[middle]) / (stiffness / restBefore + stiffness / restAfter);
+            const double clamped = std::max(std::min(transfer, 0.5 * restAfter), -0.5 * restBefore);
+            mRestLength[middle - 1] += clamped;
+            mRestLength[middle] -= clamped;
+            _updateNodeMass(middle - 1);
+            _updateNodeMass(middle);
+            _updateNodeMass(middle + 1);
+        }
+
+        _updateSections();
+    }
+
+    // Red-black Gauss-Seidel: the even sections, then the odd ones; or
+    // all of them at once in implicit mode.
+    bool CableChain::solve(double h, const double* iPinnedInvMass, int iIteration)
+    {
+        if ( mRestLength.empty() )
+        {
+            return false;
+        }
+
+        const CableParams& params = mDefinition.params;
+        if ( params.implicitAxial )
+        {
+            // A pinned node moves with its part, with the matrix given by
+            // the owner.
+            CableKernels::Chain chain = _getKernelChain();
+            mLumpedInvMass.assign(mInvMass.begin(), mInvMass.end());
+            mPinnedNodes.clear();
+            for (size_t i=0; NULL != iPinnedInvMass && i<mNodePart.size(); ++i)
+            {
+                if ( kInvalidId != mNodePart[i] )
+                {
+                    mLumpedInvMass[i] = 0.0;
+                    mPinnedNodes.push_back(i);
+                }
+            }
+            chain.invMass = &mLumpedInvMass[0];
+            chain.pinnedCount = mPinnedNodes.size();
+            chain.pinnedNodes = mPinnedNodes.empty() ? NULL : &mPinnedNodes[0];
+            chain.pinnedInvMass = iPinnedInvMass;
+            if ( !CableKernels::solveSectionsImplicit(chain, h, params.axialStiffness, params.axialDamping, iIteration > 0, sImplicitTolerance) )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            const CableKernels::Chain chain = _getKernelChain();
+            CableKernels::solveSections(chain, 0, h, params.axialStiffness, params.axialDamping);
+            CableKernels::solveSections(chain, 1, h, params.axialStiffness, params.axialDamping);
+        }
+
+        if ( params.enableBreakage )
+        {
+            for (size_t i=0; i<mTension.size(); ++i)
+            {
+                if ( mTension[i] > params.maxTension )
+                {
+                    const SectionBreak sectionBreak = { i, mTension[i] };
+                    mBreaks.push_back(sectionBreak);
+                    mIntact[i] = 0.0;
+                    mTension[i] = 0.0;
+                    mBroken = true;
+                }
+            }
+        }
+        return true;
+    }
+
+    void CableChain::updateVelocities(double h)
+    {
+        if ( mX.empty() )
+        {
+            return;
+        }
+        CableKernels::updateVelocities(_getKernelChain(), h);
+    }
+
+    Vec3 CableChain::getNodeImpulse(size_t iNode) const
+    {
+        Vec3 impulse;
+        if ( iNode > 0 )
+        {
+            impulse += Vec3(mCorrectionX[iNode - 1], mCorrectionY[iNode - 1], mCorrectionZ[iNode - 1]);
+        }
+        if ( iNode < mRestLength.size() )
+        {
+            impulse -= Vec3(mCorrectionX[iNode], mCorrectionY[iNode], mCorrectionZ[iNode]);
+        }
+        return impulse;
+    }
+
+    void CableChain::spool(double iLength)
+    {
+        if ( !mRestLength.empty() )
+        {
+            mRestLength[0] = std::max(mRestLength[0] + iLength, 1e-3);
+            _updateNodeMass(0);
+            _updateNodeMass(1);
+        }
+    }
+
+    double CableChain::getLength() const
+    {
+        double cableLength = 0.0;
+        for (size_t i=0; i<mRestLength.size(); ++i)
+        {
+            cableLength += length(getNodePosition(i + 1) - getNodePosition(i));
+        }
+        return cableLength;
+    }
+
+    double CableChain::getRestLength() const
+    {
+        double restLength = 0.0;
+        for (size_t i=0; i<mRestLength.size(); ++i)
+        {
+            restLength += mRestLength[i];
+        }
+        return restLength;
+    }
+
+    // The arrays are written one after the other: the node count and the
+    // section count (u32), the positions, previous positions and velocities
+    // and inverse masses of the nodes, the part (u32, 0xffffffff for free
+    // nodes), offset and contact flag (u32) of each node, then the rest
+    // length, intact flag, tension, flexible and adaptive flags (u32 each),
+    // maximum and minimum lengths of the sections, and last the break count
+    // (u32) and the section (u32) and tension of each break, in order.
+    void CableChain::saveState(std::vector<unsigned char>& oBuffer) const
+    {
+        TrajectoryFormat::PutU32(oBuffer, mBroken ? 1 : 0);
+        TrajectoryFormat::PutU32(oBuffer, static_cast<unsigned int>(mX.size()));
+        TrajectoryFormat::PutU32(oBuffer, static_cast<unsigned int>(mRestLength.size()));
+
+        PutArray(oBuffer, mX);
+        PutArray(oBuffer, mY);
+        PutArray(oBuffer, mZ);
+        PutArray(oBuffer, mPreviousX);
+        PutArray(oBuffer, mPreviousY);
+        PutArray(oBuffer, mPreviousZ);
+        PutArray(oBuffer, mVx);
+        PutArray(oBuffer, mVy);
+        PutArray(oBuffer, mVz);
+        PutArray(oBuffer, mInvMass);
+        for (size_t i=0; i<mNodePart.size(); ++i)
+        {
+            TrajectoryFormat::PutU32(oBuffer, static_cast<unsigned int>(mNodePart[i]));
+            TrajectoryFormat::PutF64(oBuffer, mNodeOffset[i].x);
+            TrajectoryFormat::PutF64(oBuffer, mNodeOffset[i].y);
+            TrajectoryFormat::PutF64(oBuffer, mNodeOffset[i].z);
+            TrajectoryFormat::PutU32(oBuffer, mContact[i]);
+        }
+
+        PutArray(oBuffer, mRestLength);
+        PutArray(oBuffer, mIntact);
+        PutArray(oBuffer, mTension);
+        for (size_t i=0; i<mFlexible.size(); ++i)
+        {
+            TrajectoryFormat::PutU32(oBuffer, mFlexible[i]);
+            TrajectoryFormat::PutU32(oBuffer, mAdaptive[i]);
+        }
+        PutArray(oBuffer, mMaxLength);
+        PutArray(oBuffer, mMinLength);
+
+        TrajectoryFormat::PutU32(oBuffer, static_cast<unsigned int>(mBreaks.size()));
+        for (size_t i=0; i<mBreaks.size(); ++i)
+        {
+            TrajectoryFormat::PutU32(oBuffer, static_cast<unsigned int>(mBreaks[i].section));
+            TrajectoryFormat::PutF64(oBuffer, mBreaks[i].tension);
+        }
+    }
+
+    bool CableChain::loadState(const unsigned char*& ioData, const unsigned char* iEnd)
+    {
+        const unsigned char* data = ioData;
+        unsigned int broken, nodeCount, sectionCount;
+        if ( !TrajectoryFormat::GetU32(data, iEnd, broken)
+             || !TrajectoryFormat::GetU32(data, iEnd, nodeCount)
+             || !TrajectoryFormat::GetU32(data, iEnd, sectionCount)
+             || sectionCount + (nodeCount > 0 ? 1 : 0) != nodeCount
+             || static_cast<size_t>(iEnd - data) < nodeCount * sizeof(double) )
+        {
+            return false;
+        }
+
+        // Everything is read in new arrays, swapped in once the data is valid.
+        CableChain loaded;
+        loaded.mNodePart.resize(nodeCount);
+        loaded.mNodeOffset.resize(nodeCount);
+        loaded.mContact.resize(nodeCount);
+        loaded.mFlexible.resize(sectionCount);
+        loaded.mAdaptive.resize(sectionCount);
+
+        bool valid = GetArray(data, iEnd, nodeCount, loaded.mX)
+            && GetArray(data, iEnd, nodeCount, loaded.mY)
+            && GetArray(data, iEnd, nodeCount, loaded.mZ)
+            && GetArray(data, iEnd, nodeCount, loaded.mPreviousX)
+            && GetArray(data, iEnd, nodeCount, loaded.mPreviousY)
+            && GetArray(data, iEnd, nodeCount, loaded.mPreviousZ)
+            && GetArray(data, iEnd, nodeCount, loaded.mVx)
+            && GetArray(data, iEnd, nodeCount, loaded.mVy)
+            && GetArray(data, iEnd, nodeCount, loaded.mVz)
+            && GetArray(data, iEnd, nodeCount, loaded.mInvMass);
+
+        size_t point = 0;
+        for (size_t i=0; valid && i<nodeCount; ++i)
+        {
+            unsigned int part = 0;
+            unsigned int contact = 0;
+            Vec3& offset = loaded.mNodeOffset[i];
+            valid = TrajectoryFormat::GetU32(data, iEnd, part)
+                && TrajectoryFormat::GetF64(data, iEnd, offset.x)
+                && TrajectoryFormat::GetF64(data, iEnd, offset.y)
+                && TrajectoryFormat::GetF64(data, iEnd, offset.z)
+                && TrajectoryFormat::GetU32(data, iEnd, contact);
+            loaded.mNodePart[i] = static_cast<PartId>(part);
+            loaded.mContact[i] = contact ? 1 : 0;
+
+            // The pinned nodes are the points of the definition, in order.
+            if ( valid && kInvalidId != loaded.mNodePart[i] )
+            {
+                valid = point < mDefinition.points.size() && mDefinition.points[point].part == loaded.mNodePart[i];
+                ++point;
+            }
+        }
+        valid = valid && point == mDefinition.points.size();
+
+        valid = valid && GetArray(data, iEnd, sectionCount, loaded.mRestLength)
+            && GetArray(data, iEnd, sectionCount, loaded.mIntact)
+            && GetArray(data, iEnd, sectionCount, loaded.mTension);
+        for (size_t i=0; valid && i<sectionCount; ++i)
+        {
+            unsigned int flexible = 0;
+            unsigned int adaptive = 0;
+            valid = TrajectoryFormat::GetU32(data, iEnd, flexible) && TrajectoryFormat::GetU32(data, iEnd, adaptive);
+            loaded.mFlexible[i] = flexible ? 1 : 0;
+            loaded.mAdaptive[i] = adaptive ? 1 : 0;
+        }
+        valid = valid && GetArray(data, iEnd, sectionCount, loaded.mMaxLength)
+            && GetArray(data, iEnd, sectionCount, loaded.mMinLength);
+
+        // Each break is on a broken section.
+        unsigned int breakCount = 0;
+        valid = valid && TrajectoryFormat::GetU32(data, iEnd, breakCount) && breakCount <= sectionCount;
+        for (size_t i=0; valid && i<breakCount; ++i)
+        {
+            unsigned int section = 0;
+            SectionBreak sectionBreak;
+            valid = TrajectoryFormat::GetU32(data, iEnd, section)
+                && TrajectoryFormat::GetF64(data, iEnd, sectionBreak.tension)
+                && section < sectionCount && loaded.mIntact[section] == 0.0;
+            sectionBreak.section = section;
+            loaded.mBreaks.push_back(sectionBreak);
+        }
+
+        if ( !valid )
+        {
+            return false;
+        }
+
+        mBroken = 0 != broken;
+        mBreaks.swap(loaded.mBreaks);
+        mRestoredBreakCount = mBreaks.size();
+        ++mLayoutRevision;
+        mX.swap(loaded.mX);
+        mY.swap(loaded.mY);
+        mZ.swap(loaded.mZ);
+        mPreviousX.swap(loaded.mPreviousX);
+        mPreviousY.swap(loaded.mPreviousY);
+        mPreviousZ.swap(loaded.mPreviousZ);
+        mVx.swap(loaded.mVx);
+        mVy.swap(loaded.mVy);
+        mVz.swap(loaded.mVz);
+        mInvMass.swap(loaded.mInvMass);
+        mNodePart.swap(loaded.mNodePart);
+        mNodeOffset.swap(loaded.mNodeOffset);
+        mContact.swap(loaded.mContact);
+        mRestLength.swap(loaded.mRestLength);
+        mIntact.swap(loaded.mIntact);
+        mTension.swap(loaded.mTension);
+        mFlexible.swap(loaded.mFlexible);
+        mAdaptive.swap(loaded.mAdaptive);
+        mMaxLength.swap(loaded.mMaxLength);
+        mMinLength.swap(loaded.mMinLength);
+        _fitCapacity(mX.size());
+
+        ioData = data;
+        return true;
+    }
+
+    void CableChain::_addNode(const Vec3& iPosition, PartId iPart, const Vec3& iOffset)
+    {
+        mX.push_back(iPosition.x);
+        mY.push_back(iPosition.y);
+        mZ.push_back(iPosition.z);
+        mPreviousX.push_back(iPosition.x);
+        mPreviousY.push_back(iPosition.y);
+        mPreviousZ.push_back(iPosition.z);
+        mVx.push_back(0.0);
+        mVy.push_back(0.0);
+        mVz.push_back(0.0);
+        mInvMass.push_back(0.0);
+        mNodePart.push_back(iPart);
+        mNodeOffset.push_back(iOffset);
+        mContact.push_back(0);
+    }
+
+    void CableChain::_addSection(double iRestLength, const CableSegmentDefinition* iSegment)
+    {
+        const bool flexible = NULL != iSegment && iSegment->flexible;
+        mRestLength.push_back(iRestLength);
+        mIntact.push_back(1.0);
+        mTension.push_back(0.0);
+        mFlexible.push_back(flexible ? 1 : 0);
+        mMaxLength.push_back(flexible ? iSegment->maxSectionLength : 0.0);
+        mMinLength.push_back(flexible ? iSegment->minSectionLength : 0.0);
+        mAdaptive.push_back(flexible && iSegment->adaptive ? 1 : 0);
+    }
+
+    // Insert a free node at iNode, in the middle of its neighbours. The
+    // sections from iNode on move one up.
+    void CableChain::_insertNode(size_t iNode)
+    {
+        const size_t before = iNode - 1;
+        ++mLayoutRevision;
+        for (size_t i=0; i<mBreaks.size(); ++i)
+        {
+            if ( mBreaks[i].section >= iNode )
+            {
+                ++mBreaks[i].section;
+            }
+        }
+        mX.insert(iNode, 0.5 * (mX[before] + mX[iNode]));
+        mY.insert(iNode, 0.5 * (mY[before] + mY[iNode]));
+        mZ.insert(iNode, 0.5 * (mZ[before] + mZ[iNode]));
+        mPreviousX.insert(iNode, 0.5 * (mPreviousX[before] + mPreviousX[iNode]));
+        mPreviousY.insert(iNode, 0.5 * (mPreviousY[before] + mPreviousY[iNode]));
+        mPreviousZ.insert(iNode, 0.5 * (mPreviousZ[before] + mPreviousZ[iNode]));
+        mVx.insert(iNode, 0.5 * (mVx[before] + mVx[iNode]));
+        mVy.insert(iNode, 0.5 * (mVy[before] + mVy[iNode]));
+        mVz.insert(iNode, 0.5 * (mVz[before] + mVz[iNode]));
+        mInvMass.insert(iNode, 0.0);
+        mNodePart.insert(iNode, kInvalidId);
+        mNodeOffset.insert(iNode, Vec3());
+        mContact.insert(iNode, 0);
+    }
+
+    // The sections from iNode on move one down; the section erased with the
+    // node is never a broken one.
+    void CableChain::_eraseNode(size_t iNode)
+    {
+        ++mLayoutRevision;
+        for (size_t i=0; i<mBreaks.size(); ++i)
+        {
+            if ( mBreaks[i].section >= iNode )
+            {
+                --mBreaks[i].section;
+            }
+        }
+        mX.erase(iNode);
+        mY.erase(iNode);
+        mZ.erase(iNode);
+        mPreviousX.erase(iNode);
+        mPreviousY.erase(iNode);
+        mPreviousZ.erase(iNode);
+        mVx.erase(iNode);
+        mVy.erase(iNode);
+        mVz.erase(iNode);
+        mInvMass.erase(iNode);
+        mNodePart.erase(iNode);
+        mNodeOffset.erase(iNode);
+        mContact.erase(iNode);
+    }
+
+    // Split the flexible sections that became too long and merge the ones
+    // that became too short with their neighbour in the same span, the
+    // previous one for the last section of a span. Two
+    // sections also merge when together they are well below the maximum
+    // length, so a reeled in cable gets its coarse sections back.
+    //
+    // Adaptive sections are also split in two when one of their nodes needs
+    // detail, as long as the halves stay above the minimum length, and
+    // two adaptive sections merge only when the cable is smooth at their
+    // three nodes.
+    void CableChain::_updateSections()
+    {
+        bool changed = false;
+        for (size_t i=0; i<mRestLength.size(); ++i)
+        {
+            if ( !mFlexible[i] || isSectionBroken(i) )
+            {
+                continue;
+            }
+
+            const bool canMerge = i + 1 < mRestLength.size() && mFlexible[i + 1] && !isSectionBroken(i + 1) && kInvalidId == mNodePart[i + 1];
+            const bool adaptive = mAdaptive[i] && (!canMerge || mAdaptive[i + 1]);
+            // The sections at a pinned node get and lose the length that
+            // slides through it: they only merge below the minimum length,
+            // the widest hysteresis against the sway of the slide.
+            const bool atNode = kInvalidId != mNodePart[i] || (i + 2 < mX.size() && kInvalidId != mNodePart[i + 2]);
+            const bool coarse = !atNode && mRestLength[i] + (canMerge ? mRestLength[i + 1] : 0.0) < sMergeRatio * mMaxLength[i];
+
+            if ( mRestLength[i] > mMaxLength[i]
+                 || (adaptive && 0.5 * mRestLength[i] >= sSplitMargin * mMinLength[i] && (_needsDetail(i) || _needsDetail(i + 1))) )
+            {
+                _splitSection(i);
+                changed = true;
+            }
+            else if ( canMerge
+                      && (mRestLength[i] < mMinLength[i] || mRestLength[i + 1] < mMinLength[i + 1]
+                          || (coarse && (!adaptive || (_isSmooth(i) && _isSmooth(i + 1) && _isSmooth(i + 2))))) )
+            {
+                _mergeSections(i);
+                changed = true;
+            }
+        }
+
+        // The contacts are flagged again by the next contact solve.
+        std::fill(mContact.begin(), mContact.end(), 0);
+
+        if ( changed )
+        {
+            _updateNodeMasses();
+            _fitCapacity(mX.size());
+        }
+    }
+
+    // Only the interior free nodes are considered: the cable always turns at the
+    // pinned ones, and the tension changes through the pulleys.
+    bool CableChain::_needsDetail(size_t iNode) const
+    {
+        if ( 0 == iNode || iNode + 1 >= mX.size() || kInvalidId != mNodePart[iNode] )
+        {
+            return false;
+        }
+        return _isContactEdge(iNode) || _getBendCosine(iNode) < sSplitBendCosine || _getTensionJump(iNode) > sSplitTensionJump;
+    }
+
+    bool CableChain::_isSmooth(size_t iNode) const
+    {
+        if ( 0 == iNode || iNode + 1 >= mX.size() || kInvalidId != mNodePart[iNode] )
+        {
+            return true;
+        }
+        return !_isContactEdge(iNode) && _getBendCosine(iNode) > sMergeBendCosine && _getTensionJump(iNode) < sMergeTensionJump;
+    }
+
+    // The cable needs detail where it touches down or lifts off, not along
+    // the length lying on something.
+    bool CableChain::_isContactEdge(size_t iNode) const
+    {
+        return mContact[iNode] != mContact[iNode - 1] || mContact[iNode] != mContact[iNode + 1];
+    }
+
+    // Cosine of the angle between the sections on each side of an interior node.
+    double CableChain::_getBendCosine(size_t iNode) const
+    {
+        const Vec3 before = getNodePosition(iNode) - getNodePosition(iNode - 1);
+        const Vec3 after = getNodePosition(iNode + 1) - getNodePosition(iNode);
+        const double lengths = length(before) * length(after);
+        return lengths > 0.0 ? dot(before, after) / lengths : 1.0;
+    }
+
+    // Relative change of tension across an interior node. The tensions of
+    // two sections are averaged on each side: the red-black solve leaves the
+    // even and odd sections of a span with slightly different tensions.
+    double CableChain::_getTensionJump(size_t iNode) const
+    {
+        const double before = iNode >= 2 ? 0.5 * (mTension[iNode - 2] + mTension[iNode - 1]) : mTension[iNode - 1];
+        const double after = iNode + 1 < mTension.size() ? 0.5 * (mTension[iNode] + mTension[iNode + 1]) : mTension[iNode];
+        const double reference = std::max(before, after) + sTensionJumpFloorStrain * mDefinition.params.axialStiffness;
+        return std::fabs(before - after) / reference;
+    }
+
+    // Split iSection in two halves with a new node in the middle.
+    void CableChain::_splitSection(size_t iSection)
+    {
+        _fitCapacity(mX.size() + 1);
+        _insertNode(iSection + 1);
+
+        mRestLength[iSection] *= 0.5;
+        mRestLength.insert(iSection + 1, mRestLength[iSection]);
+        mIntact.insert(iSection + 1, mIntact[iSection]);
+        mTension.insert(iSection + 1, mTension[iSection]);
+        mFlexible.insert(iSection + 1, mFlexible[iSection]);
+        mMaxLength.insert(iSection + 1, mMaxLength[iSection]);
+        mMinLength.insert(iSection + 1, mMinLength[iSection]);
+        mAdaptive.insert(iSection + 1, mAdaptive[iSection]);
+    }
+
+    // Merge iSection with the next section, removing the node between them.
+    //
+    // The mass of the removed node goes to its neighbours, each getting the
+    // half of the section that is added to it, and its momentum with it, so
+    // the chain keeps its mass and momentum. In the middle of a substep the
+    // velocity of a node is its displacement from the previous position, so
+    // the displacements are averaged as well as the velocities.
+    void CableChain::_mergeSections(size_t iSection)
+    {
+        const size_t first = iSection;
+        const size_t removed = iSection + 1;
+        const size_t last = iSection + 2;
+        const double firstLength = (first > 0 ? mRestLength[first - 1] : 0.0) + mRestLength[iSection];
+        const double lastLength = mRestLength[iSection + 1] + (last < mRestLength.size() ? mRestLength[last] : 0.0);
+        _absorbNode(first, removed, firstLength, mRestLength[iSection + 1]);
+        _absorbNode(last, removed, lastLength, mRestLength[iSection]);
+
+        mRestLength[iSection] += mRestLength[iSection + 1];
+        mTension[iSection] = std::max(mTension[iSection], mTension[iSection + 1]);
+
+        mRestLength.erase(iSection + 1);
+        mIntact.erase(iSection + 1);
+        mTension.erase(iSection + 1);
+        mFlexible.erase(iSection + 1);
+        mMaxLength.erase(iSection + 1);
+        mMinLength.erase(iSection + 1);
+        mAdaptive.erase(iSection + 1);
+
+        _eraseNode(iSection + 1);
+    }
+
+    // Add to iNode the momentum of iRemoved carried by iShare of section
+    // length, iNodeLength being the length of section carried by iNode
+    // (twice their masses per unit density). Pinned nodes follow their part
+    // and pass the momentum to it through the pin.
+    void CableChain::_absorbNode(size_t iNode, size_t iRemoved, double iNodeLength, double iShare)
+    {
+        if ( kInvalidId != mNodePart[iNode] )
+        {
+            return;
+        }
+
+        const double weight = iShare / (iNodeLength + iShare);
+        const Vec3 displacement = getNodePosition(iNode) - getNodePreviousPosition(iNode);
+        const Vec3 removedDisplacement = getNodePosition(iRemoved) - getNodePreviousPosition(iRemoved);
+        const Vec3 previous = getNodePosition(iNode) - (displacement + (removedDisplacement - displacement) * weight);
+        mPreviousX[iNode] = previous.x;
+        mPreviousY[iNode] = previous.y;
+        mPreviousZ[iNode] = previous.z;
+        mVx[iNode] += (mVx[iRemoved] - mVx[iNode]) * weight;
+        mVy[iNode] += (mVy[iRemoved] - mVy[iNode]) * weight;
+        mVz[iNode] += (mVz[iRemoved] - mVz[iNode]) * weight;
+    }
+
+    void CableChain::_updateNodeMasses()
+    {
+        for (size_t i=0; i<mInvMass.size(); ++i)
+        {
+            _updateNodeMass(i);
+        }
+    }
+
+    // Each node carries half of the mass of its adjacent sections.
+    void CableChain::_updateNodeMass(size_t iNode)
+    {
+        const double linearDensity = mDefinition.params.linearDensity;
+        double mass = 0.0;
+        if ( iNode > 0 )
+        {
+            mass += 0.5 * linearDensity * mRestLength[iNode - 1];
+        }
+        if ( iNode < mRestLength.size() )
+        {
+            mass += 0.5 * linearDensity * mRestLength[iNode];
+        }
+        mInvMass[iNode] = 1.0 / std::max(mass, 1e-3);
+    }
+
+    // The arrays have room for the deployable length and half of it again,
+    // for the sections refined while deployed. They grow by half when
+    // iNodeCount nodes do not fit, and give the memory above that room back
+    // when less than a quarter of it is used.
+    void CableChain::_fitCapacity(size_t iNodeCount)
+    {
+        const size_t capacity = mX.capacity();
+        const size_t deployableCapacity = mDeployableNodeCount + mDeployableNodeCount / 2 + 1;
+        if ( iNodeCount <= capacity && capacity >= deployableCapacity && (iNodeCount >= capacity / 4 || capacity == deployableCapacity) )
+        {
+            return;
+        }
+
+        const size_t nodeCapacity = std::max(iNodeCount + iNodeCount / 2 + 1, deployableCapacity);
+        const size_t sectionCapacity = nodeCapacity - 1;
+
+        SetCapacity(mX, nodeCapacity);
+        SetCapacity(mY, nodeCapacity);
+        SetCapacity(mZ, nodeCapacity);
+        SetCapacity(mPreviousX, nodeCapacity);
+        SetCapacity(mPreviousY, nodeCapacity);
+        SetCapacity(mPreviousZ, nodeCapacity);
+        SetCapacity(mVx, nodeCapacity);
+        SetCapacity(mVy, nodeCapacity);
+        SetCapacity(mVz, nodeCapacity);
+        SetCapacity(mInvMass, nodeCapacity);
+        SetCapacity(mNodePart, nodeCapacity);
+        SetCapacity(mNodeOffset, nodeCapacity);
+        SetCapacity(mContact, nodeCapacity);
+
+        SetCapacity(mRestLength, sectionCapacity);
+        SetCapacity(mIntact, sectionCapacity);
+        SetCapacity(mTension, sectionCapacity);
+        SetCapacity(mFlexible, sectionCapacity);
+        SetCapacity(mMaxLength, sectionCapacity);
+        SetCapacity(mMinLength, sectionCapacity);
+        SetCapacity(mAdaptive, sectionCapacity);
+        SetCapacity(mCorrectionX, sectionCapacity);
+        SetCapacity(mCorrectionY, sectionCapacity);
+        SetCapacity(mCorrectionZ, sectionCapacity);
+        if ( mDefinition.params.implicitAxial )
+        {
+            SetCapacity(mActive, sectionCapacity);
+            SetCapacity(mBias, sectionCapacity);
+            SetCapacity(mUpper, sectionCapacity);
+            SetCapacity(mLambda, sectionCapacity);
+            SetCapacity(mDiagonal, sectionCapacity);
+            SetCapacity(mCoupling, sectionCapacity);
+            SetCapacity(mLumpedInvMass, nodeCapacity);
+            SetCapacity(mPinnedNodes, nodeCapacity);
+        }
+    }
+
+    size_t CableChain::getMemoryUsage() const
+    {
+        return GetMemoryUsage(mX) + GetMemoryUsage(mY) + GetMemoryUsage(mZ)
+            + GetMemoryUsage(mPreviousX) + GetMemoryUsage(mPreviousY) + GetMemoryUsage(mPreviousZ)
+            + GetMemoryUsage(mVx) + GetMemoryUsage(mVy) + GetMemoryUsage(mVz)
+            + GetMemoryUsage(mInvMass) + GetMemoryUsage(mNodePart) + GetMemoryUsage(mNodeOffset) + GetMemoryUsage(mContact)
+            + GetMemoryUsage(mRestLength) + GetMemoryUsage(mIntact) + GetMemoryUsage(mTension)
+            + GetMemoryUsage(mFlexible) + GetMemoryUsage(mMaxLength) + GetMemoryUsage(mMinLength) + GetMemoryUsage(mAdaptive)
+            + GetMemoryUsage(mCorrectionX) + GetMemoryUsage(mCorrectionY) + GetMemoryUsage(mCorrectionZ)
+            + GetMemoryUsage(mActive) + GetMemoryUsage(mBias) + GetMemoryUsage(mUpper) + GetMemoryUsage(mLambda)
+            + GetMemoryUsage(mDiagonal) + GetMemoryUsage(mCoupling)
+            + GetMemoryUsage(mLumpedInvMass) + GetMemoryUsage(mPinnedNodes) + GetMemoryUsage(mBreaks);
+    }
+
+    CableKernels::Chain CableChain::_getKernelChain()
+    {
+        mCorrectionX.resize(mRestLength.size());
+        mCorrectionY.resize(mRestLength.size());
+        mCorrectionZ.resize(mRestLength.size());
+        if ( mDefinition.params.implicitAxial )
+        {
+            mActive.resize(mRestLength.size());
+            mBias.resize(mRestLength.size());
+            mUpper.resize(mRestLength.size());
+            mLambda.resize(mRestLength.size());
+            mDiagonal.resize(mRestLength.size());
+            mCoupling.resize(mRestLength.size());
+        }
+
+        CableKernels::Chain chain;
+        chain.nodeCount = mX.size();
+        chain.x = &mX[0];
+        chain.y = &mY[0];
+        chain.z = &mZ[0];
+        chain.previousX = &mPreviousX[0];
+        chain.previousY = &mPreviousY[0];
+        chain.previousZ = &mPreviousZ[0];
+        chain.vx = &mVx[0];
+        chain.vy = &mVy[0];
+        chain.vz = &mVz[0];
+        chain.invMass = &mInvMass[0];
+        chain.sectionCount = mRestLength.size();
+        chain.restLength = mRestLength.empty() ? NULL : &mRestLength[0];
+        chain.intact = mIntact.empty() ? NULL : &mIntact[0];
+        chain.tension = mTension.empty() ? NULL : &mTension[0];
+        chain.correctionX = mCorrectionX.empty() ? NULL : &mCorrectionX[0];
+        chain.correctionY = mCorrectionY.empty() ? NULL : &mCorrectionY[0];
+        chain.correctionZ = mCorrectionZ.empty() ? NULL : &mCorrectionZ[0];
+        chain.active = mActive.empty() ? NULL : &mActive[0];
+        chain.bias = mBias.empty() ? NULL : &mBias[0];
+        chain.upper = mUpper.empty() ? NULL : &mUpper[0];
+        chain.lambda = mLambda.empty() ? NULL : &mLambda[0];
+        chain.diagonal = mDiagonal.empty() ? NULL : &mDiagonal[0];
+        chain.coupling = mCoupling.empty() ? NULL : &mCoupling[0];
+        chain.pinnedCount = 0;
+        chain.pinnedNodes = NULL;
+        chain.pinnedInvMass = NULL;
+        return chain;
+    }
+}
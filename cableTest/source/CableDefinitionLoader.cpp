@@ -0,0 +1,303 @@
+#include "CableDefinitionLoader.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Sim
+{
+    CableDefinitionLoader::CableDefinitionLoader()
+        : mDefinition()
+        , mAssemblyNames()
+        , mPartNames()
+        , mSpanSegments()
+    {
+    }
+
+    bool CableDefinitionLoader::load(const std::string& iFileName)
+    {
+        std::ifstream stream(iFileName.c_str());
+        if ( !stream )
+        {
+            std::cout << "Cannot read the cable definition " << iFileName << std::endl;
+            return false;
+        }
+
+        return parse(stream, iFileName);
+    }
+
+    bool CableDefinitionLoader::parse(std::istream& iStream, const std::string& iSourceName)
+    {
+        *this = CableDefinitionLoader();
+
+        std::string line;
+        for (size_t lineNumber=1; std::getline(iStream, line); ++lineNumber)
+        {
+            const size_t comment = line.find('#');
+            if ( comment != std::string::npos )
+            {
+                line.erase(comment);
+            }
+
+            std::istringstream lineStream(line);
+            std::string keyword;
+            if ( !(lineStream >> keyword) )
+            {
+                continue;
+            }
+
+            if ( !_parseLine(lineStream, keyword) )
+            {
+                std::cout << iSourceName << ":" << lineNumber << ": invalid entry \"" << line << "\"" << std::endl;
+                return false;
+            }
+        }
+
+        for (size_t i=0; i<mSpanSegments.size(); ++i)
+        {
+            CableSegmentDefinition& segment = mDefinition.segments[mSpanSegments[i]];
+            if ( segment.index + 1 >= mDefinition.points.size() )
+            {
+                std::cout << iSourceName << ": span " << segment.index << " has no end point" << std::endl;
+                return false;
+            }
+            segment.index = mDefinition.getSpanSegmentIndex(segment.index);
+        }
+        mSpanSegments.clear();
+
+        if ( mDefinition.points.size() < 2 )
+        {
+            std::cout << iSourceName << ": a cable needs at least two points" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool CableDefinitionLoader::_parseLine(std::istream& iLine, const std::string& iKeyword)
+    {
+        CableParams& params = mDefinition.params;
+
+        if ( iKeyword == "name" )
+        {
+            std::getline(iLine >> std::ws, mDefinition.name);
+            return !mDefinition.name.empty();
+        }
+        else if ( iKeyword == "point" )
+        {
+            return _parsePoint(iLine);
+        }
+        else if ( iKeyword == "span" || iKeyword == "segment" )
+        {
+            size_t index = 0;
+            if ( !(iLine >> index) )
+            {
+                return false;
+            }
+            if ( iKeyword == "span" )
+            {
+                mSpanSegments.push_back(mDefinition.segments.size());
+            }
+            return _parseSegment(iLine, index);
+        }
+        else if ( iKeyword == "stiffness" )
+        {
+            return static_cast<bool>(iLine >> params.axialStiffness);
+        }
+        else if ( iKeyword == "damping" )
+        {
+            return static_cast<bool>(iLine >> params.axialDamping);
+        }
+        else if ( iKeyword == "collision" )
+        {
+            return static_cast<bool>(iLine >> params.collisionGeometryType);
+        }
+        else if ( iKeyword == "max-tension" )
+        {
+            params.enableBreakage = true;
+            return static_cast<bool>(iLine >> params.maxTension);
+        }
+        else if ( iKeyword == "density" )
+        {
+            return static_cast<bool>(iLine >> params.linearDensity);
+        }
+        else if ( iKeyword == "radius" )
+        {
+            return static_cast<bool>(iLine >> params.radius);
+        }
+        else if ( iKeyword == "deployable-length" )
+        {
+            return static_cast<bool>(iLine >> params.deployableLength);
+        }
+        else if ( iKeyword == "implicit" )
+        {
+            params.implicitAxial = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    // point <type> <assembly> <part> [inverse] [axis x y z] [offset x y z]
+    bool CableDefinitionLoader::_parsePoint(std::istream& iLine)
+    {
+        std::string type;
+        std::string assemblyName;
+        std::string partName;
+        if ( !(iLine >> type >> assemblyName >> partName) )
+        {
+            return false;
+        }
+
+        CablePointDefinition point;
+        if ( type == "winch" )
+        {
+            point.type = kCableWinch;
+        }
+        else if ( type == "pulley" )
+        {
+            point.type = kCablePulley;
+        }
+        else if ( type == "ring" )
+        {
+            point.type = kCableRing;
+        }
+        else if ( type == "attachment" )
+        {
+            point.type = kCableAttachmentPoint;
+        }
+        else
+        {
+            return false;
+        }
+
+        std::string option;
+        while ( iLine >> option )
+        {
+            if ( option == "inverse" )
+            {
+                point.inverseWrapping = true;
+            }
+            else if ( option == "axis" )
+            {
+                if ( !(iLine >> point.ringPrimaryAxis.x >> point.ringPrimaryAxis.y >> point.ringPrimaryAxis.z) )
+                {
+                    return false;
+                }
+            }
+            else if ( option == "offset" )
+            {
+                if ( !(iLine >> point.offset.x >> point.offset.y >> point.offset.z) )
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        mDefinition.points.push_back(point);
+        mAssemblyNames.push_back(assemblyName);
+        mPartNames.push_back(partName);
+        return true;
+    }
+
+    // [flexible] [adaptive] [fixed] [max l] [min l] [collision type]
+    bool CableDefinitionLoader::_parseSegment(std::istream& iLine, size_t iIndex)
+    {
+        CableSegmentDefinition segment;
+        segment.index = iIndex;
+
+        std::string option;
+        while ( iLine >> option )
+        {
+            bool valid = true;
+            if ( option == "flexible" )
+            {
+                segment.flexible = true;
+            }
+            else if ( option == "adaptive" )
+            {
+                segment.adaptive = true;
+            }
+            else if ( option == "fixed" )
+            {
+                segment.fixedLength = true;
+            }
+            else if ( option == "max" )
+            {
+                valid = static_cast<bool>(iLine >> segment.maxSectionLength);
+            }
+            else if ( option == "min" )
+            {
+                valid = static_cast<bool>(iLine >> segment.minSectionLength);
+            }
+            else if ( option == "collision" )
+            {
+                valid = static_cast<bool>(iLine >> segment.collisionGeometryType);
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if ( !valid )
+            {
+                return false;
+            }
+        }
+
+        if ( segment.minSectionLength <= 0.0 || segment.maxSectionLength < segment.minSectionLength )
+        {
+            return false;
+        }
+
+        mDefinition.segments.push_back(segment);
+        return true;
+    }
+
+    bool CableDefinitionLoader::resolve(const IScene& iScene, const std::vector<MechanismId>& iMechanisms, CableDefinition& oDefinition) const
+    {
+        oDefinition = mDefinition;
+
+        // Most points share their assembly: look each name up once.
+        std::vector<std::string> assemblyNames;
+        std::vector<AssemblyId> assemblies;
+        for (size_t i=0; i<oDefinition.points.size(); ++i)
+        {
+            size_t assemblyIndex = 0;
+            while ( assemblyIndex < assemblyNames.size() && assemblyNames[assemblyIndex] != mAssemblyNames[i] )
+            {
+                ++assemblyIndex;
+            }
+
+            if ( assemblyIndex == assemblyNames.size() )
+            {
+                AssemblyId assembly = kInvalidId;
+                for (size_t j=0; j<iMechanisms.size() && kInvalidId == assembly; ++j)
+                {
+                    assembly = iScene.findAssembly(iMechanisms[j], mAssemblyNames[i]);
+                }
+                if ( kInvalidId == assembly )
+                {
+                    std::cout << "Cable " << oDefinition.name << ": assembly " << mAssemblyNames[i] << " not found" << std::endl;
+                    return false;
+                }
+
+                assemblyNames.push_back(mAssemblyNames[i]);
+                assemblies.push_back(assembly);
+            }
+
+            oDefinition.points[i].part = iScene.findPart(assemblies[assemblyIndex], mPartNames[i]);
+            if ( kInvalidId == oDefinition.points[i].part )
+            {
+                std::cout << "Cable " << oDefinition.name << ": part " << mPartNames[i] << " not found in " << mAssemblyNames[i] << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,561 @@
+#include "CableKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(CABLE_KERNELS_AVX2)
+#include <immintrin.h>
+#elif defined(CABLE_KERNELS_SSE2)
+#include <emmintrin.h>
+#endif
+
+// The kernels are written once against a small set of vector operations.
+// Each instruction set provides them in a traits class; the scalar traits
+// also handle the elements left over at the end of the vector loops.
+namespace
+{
+    struct ScalarOps
+    {
+        typedef double V;
+        typedef bool M;
+        static const size_t kWidth = 1;
+
+        static V load(const double* p) { return *p; }
+        static void store(double* p, V v) { *p = v; }
+        static V set1(double s) { return s; }
+        static V add(V a, V b) { return a + b; }
+        static V sub(V a, V b) { return a - b; }
+        static V mul(V a, V b) { return a * b; }
+        static V div(V a, V b) { return a / b; }
+        static V sqrt(V a) { return std::sqrt(a); }
+        static V max(V a, V b) { return std::max(a, b); }
+        static M greater(V a, V b) { return a > b; }
+        static M both(M a, M b) { return a && b; }
+        static V select(M m, V a) { return m ? a : 0.0; }
+        static V blend(M m, V a, V b) { return m ? a : b; }
+        static M parity(size_t iIndex, int iParity) { return static_cast<int>(iIndex & 1) == iParity; }
+    };
+
+#if defined(CABLE_KERNELS_AVX2)
+    struct VectorOps
+    {
+        typedef __m256d V;
+        typedef __m256d M;
+        static const size_t kWidth = 4;
+
+        static V load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+        static V set1(double s) { return _mm256_set1_pd(s); }
+        static V add(V a, V b) { return _mm256_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+        static V div(V a, V b) { return _mm256_div_pd(a, b); }
+        static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+        static V max(V a, V b) { return _mm256_max_pd(a, b); }
+        static M greater(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static M both(M a, M b) { return _mm256_and_pd(a, b); }
+        static V select(M m, V a) { return _mm256_and_pd(m, a); }
+        static V blend(M m, V a, V b) { return _mm256_blendv_pd(b, a, m); }
+        // The vector loops start on even indices.
+        static M parity(size_t /*iIndex*/, int iParity)
+        {
+            const double on = 1.0;
+            const double off = 0.0;
+            const V lanes = 0 == iParity ? _mm256_set_pd(off, on, off, on) : _mm256_set_pd(on, off, on, off);
+            return greater(lanes, set1(0.5));
+        }
+    };
+#elif defined(CABLE_KERNELS_SSE2)
+    struct VectorOps
+    {
+        typedef __m128d V;
+        typedef __m128d M;
+        static const size_t kWidth = 2;
+
+        static V load(const double* p) { return _mm_loadu_pd(p); }
+        static void store(double* p, V v) { _mm_storeu_pd(p, v); }
+        static V set1(double s) { return _mm_set1_pd(s); }
+        static V add(V a, V b) { return _mm_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+        static V div(V a, V b) { return _mm_div_pd(a, b); }
+        static V sqrt(V a) { return _mm_sqrt_pd(a); }
+        static V max(V a, V b) { return _mm_max_pd(a, b); }
+        static M greater(V a, V b) { return _mm_cmpgt_pd(a, b); }
+        static M both(M a, M b) { return _mm_and_pd(a, b); }
+        static V select(M m, V a) { return _mm_and_pd(m, a); }
+        static V blend(M m, V a, V b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+        // The vector loops start on even indices.
+        static M parity(size_t /*iIndex*/, int iParity)
+        {
+            const V lanes = 0 == iParity ? _mm_set_pd(0.0, 1.0) : _mm_set_pd(1.0, 0.0);
+            return greater(lanes, set1(0.5));
+        }
+    };
+#else
+    typedef ScalarOps VectorOps;
+#endif
+
+    template <class Ops>
+    void PredictRange(const Sim::CableKernels::Chain& c, size_t iBegin, size_t iEnd, double h, double gx, double gy, double gz)
+    {
+        typedef typename Ops::V V;
+        const V vh = Ops::set1(h);
+        const V dvx = Ops::set1(gx * h);
+        const V dvy = Ops::set1(gy * h);
+        const V dvz = Ops::set1(gz * h);
+        for (size_t i=iBegin; i+Ops::kWidth<=iEnd; i+=Ops::kWidth)
+        {
+            const V x = Ops::load(c.x + i);
+            const V y = Ops::load(c.y + i);
+            const V z = Ops::load(c.z + i);
+            Ops::store(c.previousX + i, x);
+            Ops::store(c.previousY + i, y);
+            Ops::store(c.previousZ + i, z);
+
+            const V vx = Ops::add(Ops::load(c.vx + i), dvx);
+            const V vy = Ops::add(Ops::load(c.vy + i), dvy);
+            const V vz = Ops::add(Ops::load(c.vz + i), dvz);
+            Ops::store(c.vx + i, vx);
+            Ops::store(c.vy + i, vy);
+            Ops::store(c.vz + i, vz);
+
+            Ops::store(c.x + i, Ops::add(x, Ops::mul(vx, vh)));
+            Ops::store(c.y + i, Ops::add(y, Ops::mul(vy, vh)));
+            Ops::store(c.z + i, Ops::add(z, Ops::mul(vz, vh)));
+        }
+    }
+
+    template <class Ops>
+    void UpdateVelocitiesRange(const Sim::CableKernels::Chain& c, size_t iBegin, size_t iEnd, double h)
+    {
+        typedef typename Ops::V V;
+        const V invH = Ops::set1(1.0 / h);
+        for (size_t i=iBegin; i+Ops::kWidth<=iEnd; i+=Ops::kWidth)
+        {
+            Ops::store(c.vx + i, Ops::mul(Ops::sub(Ops::load(c.x + i), Ops::load(c.previousX + i)), invH));
+            Ops::store(c.vy + i, Ops::mul(Ops::sub(Ops::load(c.y + i), Ops::load(c.previousY + i)), invH));
+            Ops::store(c.vz + i, Ops::mul(Ops::sub(Ops::load(c.z + i), Ops::load(c.previousZ + i)), invH));
+        }
+    }
+
+    // Compute the correction of the sections of the given parity; the
+    // correction of the other sections is zero.
+    template <class Ops>
+    void ComputeCorrectionsRange(const Sim::CableKernels::Chain& c, size_t iBegin, size_t iEnd, int iParity, double h, double iStiffness, double iDamping)
+    {
+        typedef typename Ops::V V;
+        typedef typename Ops::M M;
+        const V zero = Ops::set1(0.0);
+        const V one = Ops::set1(1.0);
+        const V half = Ops::set1(0.5);
+        const V tiny = Ops::set1(1e-12);
+        const V invH2 = Ops::set1(1.0 / (h * h));
+        const V complianceScale = Ops::set1(1.0 / (iStiffness * h * h));
+        const V gamma = Ops::set1(iDamping / (iStiffness * h));
+        const V onePlusGamma = Ops::add(one, gamma);
+
+        for (size_t i=iBegin; i+Ops::kWidth<=iEnd; i+=Ops::kWidth)
+        {
+            const V x0 = Ops::load(c.x + i);
+            const V y0 = Ops::load(c.y + i);
+            const V z0 = Ops::load(c.z + i);
+            const V x1 = Ops::load(c.x + i + 1);
+            const V y1 = Ops::load(c.y + i + 1);
+            const V z1 = Ops::load(c.z + i + 1);
+
+            const V dx = Ops::sub(x1, x0);
+            const V dy = Ops::sub(y1, y0);
+            const V dz = Ops::sub(z1, z0);
+            const V distance = Ops::sqrt(Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz)));
+            const V invDistance = Ops::div(one, Ops::max(distance, tiny));
+            const V nx = Ops::mul(dx, invDistance);
+            const V ny = Ops::mul(dy, invDistance);
+            const V nz = Ops::mul(dz, invDistance);
+
+            const V rest = Ops::load(c.restLength + i);
+            const V stretch = Ops::sub(distance, rest);
+            const V w = Ops::add(Ops::load(c.invMass + i), Ops::load(c.invMass + i + 1));
+
+            // A cable only pulls.
+            M active = Ops::both(Ops::parity(i, iParity), Ops::greater(Ops::load(c.intact + i), half));
+            active = Ops::both(active, Ops::greater(stretch, zero));
+            active = Ops::both(active, Ops::greater(distance, tiny));
+
+            // Relative motion of the nodes along the section during the substep.
+            const V mx = Ops::sub(Ops::sub(x1, Ops::load(c.previousX + i + 1)), Ops::sub(x0, Ops::load(c.previousX + i)));
+            const V my = Ops::sub(Ops::sub(y1, Ops::load(c.previousY + i + 1)), Ops::sub(y0, Ops::load(c.previousY + i)));
+            const V mz = Ops::sub(Ops::sub(z1, Ops::load(c.previousZ + i + 1)), Ops::sub(z0, Ops::load(c.previousZ + i)));
+            const V relativeMotion = Ops::add(Ops::add(Ops::mul(nx, mx), Ops::mul(ny, my)), Ops::mul(nz, mz));
+
+            const V alpha = Ops::mul(rest, complianceScale);
+            const V numerator = Ops::sub(Ops::sub(zero, stretch), Ops::mul(gamma, relativeMotion));
+            const V denominator = Ops::max(Ops::add(Ops::mul(onePlusGamma, w), alpha), tiny);
+            const V deltaLambda = Ops::select(active, Ops::div(numerator, denominator));
+
+            Ops::store(c.correctionX + i, Ops::mul(nx, deltaLambda));
+            Ops::store(c.correctionY + i, Ops::mul(ny, deltaLambda));
+            Ops::store(c.correctionZ + i, Ops::mul(nz, deltaLambda));
+
+            const V tension = Ops::mul(Ops::sub(zero, deltaLambda), invH2);
+            Ops::store(c.tension + i, Ops::blend(Ops::parity(i, iParity), tension, Ops::load(c.tension + i)));
+        }
+    }
+
+    // Node j receives the correction of section j-1 and the opposite of the
+    // correction of section j.
+    template <class Ops>
+    void ApplyCorrectionsRange(const Sim::CableKernels::Chain& c, size_t iBegin, size_t iEnd)
+    {
+        typedef typename Ops::V V;
+        for (size_t j=iBegin; j+Ops::kWidth<=iEnd; j+=Ops::kWidth)
+        {
+            const V w = Ops::load(c.invMass + j);
+            const V cx = Ops::sub(Ops::load(c.correctionX + j - 1), Ops::load(c.correctionX + j));
+            const V cy = Ops::sub(Ops::load(c.correctionY + j - 1), Ops::load(c.correctionY + j));
+            const V cz = Ops::sub(Ops::load(c.correctionZ + j - 1), Ops::load(c.correctionZ + j));
+            Ops::store(c.x + j, Ops::add(Ops::load(c.x + j), Ops::mul(w, cx)));
+            Ops::store(c.y + j, Ops::add(Ops::load(c.y + j), Ops::mul(w, cy)));
+            Ops::store(c.z + j, Ops::add(Ops::load(c.z + j), Ops::mul(w, cz)));
+        }
+    }
+
+    // Index of the first element not handled by the vector loop.
+    size_t VectorEnd(size_t iBegin, size_t iEnd)
+    {
+        if ( iEnd <= iBegin )
+        {
+            return iBegin;
+        }
+        return iBegin + (iEnd - iBegin) / VectorOps::kWidth * VectorOps::kWidth;
+    }
+
+    template <class Ops>
+    void SectionFramesRange(const Sim::CableKernels::SectionFrames& f, size_t iBegin, size_t iEnd)
+    {
+        typedef typename Ops::V V;
+        typedef typename Ops::M M;
+        const V zero = Ops::set1(0.0);
+        const V half = Ops::set1(0.5);
+        const V one = Ops::set1(1.0);
+        const V tiny = Ops::set1(1e-12);
+        for (size_t i=iBegin; i+Ops::kWidth<=iEnd; i+=Ops::kWidth)
+        {
+            const V x0 = Ops::load(f.x + i);
+            const V y0 = Ops::load(f.y + i);
+            const V z0 = Ops::load(f.z + i);
+            const V x1 = Ops::load(f.x + i + 1);
+            const V y1 = Ops::load(f.y + i + 1);
+            const V z1 = Ops::load(f.z + i + 1);
+            Ops::store(f.centerX + i, Ops::mul(Ops::add(x0, x1), half));
+            Ops::store(f.centerY + i, Ops::mul(Ops::add(y0, y1), half));
+            Ops::store(f.centerZ + i, Ops::mul(Ops::add(z0, z1), half));
+
+            const V dx = Ops::sub(x1, x0);
+            const V dy = Ops::sub(y1, y0);
+            const V dz = Ops::sub(z1, z0);
+            const V length = Ops::sqrt(Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz)));
+            Ops::store(f.length + i, length);
+
+            const V inverse = Ops::div(one, Ops::max(length, tiny));
+            const V ux = Ops::mul(dx, inverse);
+            const V uy = Ops::mul(dy, inverse);
+            const V uz = Ops::mul(dz, inverse);
+
+            // Up: (1 + uz, -uy, ux, 0). Down: (-uy, 1 - uz, 0, ux).
+            const M up = Ops::greater(uz, zero);
+            const V w = Ops::blend(up, Ops::add(one, uz), Ops::sub(zero, uy));
+            const V qx = Ops::blend(up, Ops::sub(zero, uy), Ops::sub(one, uz));
+            const V qy = Ops::select(up, ux);
+            const V qz = Ops::blend(up, zero, ux);
+            const V scale = Ops::div(one, Ops::sqrt(Ops::add(Ops::add(Ops::mul(w, w), Ops::mul(qx, qx)), Ops::add(Ops::mul(qy, qy), Ops::mul(qz, qz)))));
+            Ops::store(f.qw + i, Ops::mul(w, scale));
+            Ops::store(f.qx + i, Ops::mul(qx, scale));
+            Ops::store(f.qy + i, Ops::mul(qy, scale));
+            Ops::store(f.qz + i, Ops::mul(qz, scale));
+        }
+    }
+
+    // Move the nodes by the corrections of the sections around them.
+    void ApplyCorrections(const Sim::CableKernels::Chain& chain)
+    {
+        // The end nodes have a single section.
+        const size_t last = chain.nodeCount - 1;
+        chain.x[0] -= chain.invMass[0] * chain.correctionX[0];
+        chain.y[0] -= chain.invMass[0] * chain.correctionY[0];
+        chain.z[0] -= chain.invMass[0] * chain.correctionZ[0];
+
+        const size_t applySplit = VectorEnd(1, last);
+        ApplyCorrectionsRange<VectorOps>(chain, 1, applySplit);
+        ApplyCorrectionsRange<ScalarOps>(chain, applySplit, last);
+
+        chain.x[last] += chain.invMass[last] * chain.correctionX[last - 1];
+        chain.y[last] += chain.invMass[last] * chain.correctionY[last - 1];
+        chain.z[last] += chain.invMass[last] * chain.correctionZ[last - 1];
+    }
+}
+
+namespace Sim
+{
+    namespace CableKernels
+    {
+        const char* getInstructionSet()
+        {
+#if defined(CABLE_KERNELS_AVX2)
+            return "avx2";
+#elif defined(CABLE_KERNELS_SSE2)
+            return "sse2";
+#else
+            return "scalar";
+#endif
+        }
+
+        void predict(const Chain& chain, double h, double gx, double gy, double gz)
+        {
+            const size_t split = VectorEnd(0, chain.nodeCount);
+            PredictRange<VectorOps>(chain, 0, split, h, gx, gy, gz);
+            PredictRange<ScalarOps>(chain, split, chain.nodeCount, h, gx, gy, gz);
+        }
+
+        void solveSections(const Chain& chain, int iParity, double h, double iStiffness, double iDamping)
+        {
+            if ( 0 == chain.sectionCount )
+            {
+                return;
+            }
+
+            const size_t split = VectorEnd(0, chain.sectionCount);
+            ComputeCorrectionsRange<VectorOps>(chain, 0, split, iParity, h, iStiffness, iDamping);
+            ComputeCorrectionsRange<ScalarOps>(chain, split, chain.sectionCount, iParity, h, iStiffness, iDamping);
+            ApplyCorrections(chain);
+        }
+
+        // The system is the one of XPBD with all the sections together:
+        //   ((1 + gamma) J W J^T + alpha) dLambda = -C - alpha lambda - gamma J dx
+        // where row i of J moves node i by -n_i and node i+1 by n_i, and W
+        // has a 3x3 block per node, a scalar one for the free nodes. So
+        // sections i and i+1 are only coupled by the block of node i+1: the
+        // system stays tridiagonal, one multiplier per section. The
+        // rows of the sections out of the solve are replaced by their fixed
+        // correction; the other rows keep the matrix symmetric positive
+        // definite, and the Thomas algorithm needs no pivoting.
+        bool solveSectionsImplicit(const Chain& chain, double h, double iStiffness, double iDamping, bool iAccumulate, double iTolerance)
+        {
+            const size_t n = chain.sectionCount;
+            if ( 0 == n )
+            {
+                return false;
+            }
+
+            const double tiny = 1e-12;
+            const double h2 = h * h;
+            const double complianceScale = 1.0 / (iStiffness * h2);
+            const double gamma = iDamping / (iStiffness * h);
+
+            // Directions in the corrections, diagonal of the free nodes, and
+            // right hand side. The right hand side of a tensioned section is
+            // its error; the slack ones are only off when they got longer
+            // than their rest length.
+            bool converged = iAccumulate;
+            for (size_t i=0; i<n; ++i)
+            {
+                const double dx = chain.x[i + 1] - chain.x[i];
+                const double dy = chain.y[i + 1] - chain.y[i];
+                const double dz = chain.z[i + 1] - chain.z[i];
+                const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+                const double invDistance = 1.0 / std::max(distance, tiny);
+                const double nx = dx * invDistance;
+                const double ny = dy * invDistance;
+                const double nz = dz * invDistance;
+                chain.correctionX[i] = nx;
+                chain.correctionY[i] = ny;
+                chain.correctionZ[i] = nz;
+                chain.diagonal[i] = chain.invMass[i] + chain.invMass[i + 1];
+
+                const double mx = (chain.x[i + 1] - chain.previousX[i + 1]) - (chain.x[i] - chain.previousX[i]);
+                const double my = (chain.y[i + 1] - chain.previousY[i + 1]) - (chain.y[i] - chain.previousY[i]);
+                const double mz = (chain.z[i + 1] - chain.previousZ[i + 1]) - (chain.z[i] - chain.previousZ[i]);
+                const double stretch = distance - chain.restLength[i];
+                const double lambda = iAccumulate ? -chain.tension[i] * h2 : 0.0;
+
+                // All the intact sections start in the solve, even the ones
+                // at their rest length: the ones holding a falling load only
+                // get stretched by the corrections of the others. The solve
+                // then releases the sections that would push.
+                chain.active[i] = chain.intact[i] > 0.5 && distance > tiny ? 1.0 : 0.0;
+                chain.bias[i] = -stretch - chain.restLength[i] * complianceScale * lambda - gamma * (nx * mx + ny * my + nz * mz);
+                // The correction of the fixed sections.
+                chain.lambda[i] = 0.0;
+
+                const double error = lambda < 0.0 ? std::fabs(chain.bias[i]) : -chain.bias[i];
+                if ( chain.active[i] > 0.5 && error > iTolerance * chain.restLength[i] )
+                {
+                    converged = false;
+                }
+            }
+
+            if ( converged )
+            {
+                for (size_t i=0; i<n; ++i)
+                {
+                    chain.correctionX[i] = 0.0;
+                    chain.correctionY[i] = 0.0;
+                    chain.correctionZ[i] = 0.0;
+                }
+                return false;
+            }
+
+            // Coupling of the sections through their shared node, then the
+            // terms of the pinned nodes.
+            for (size_t i=0; i+1<n; ++i)
+            {
+                chain.coupling[i] = chain.invMass[i + 1] * (chain.correctionX[i] * chain.correctionX[i + 1]
+                    + chain.correctionY[i] * chain.correctionY[i + 1]
+                    + chain.correctionZ[i] * chain.correctionZ[i + 1]);
+            }
+            for (size_t k=0; k<chain.pinnedCount; ++k)
+            {
+                const size_t j = chain.pinnedNodes[k];
+                const double* w = chain.pinnedInvMass + 6 * j;
+                double wx = 0.0;
+                double wy = 0.0;
+                double wz = 0.0;
+                if ( j < n )
+                {
+                    // W n_j
+                    const double nx = chain.correctionX[j];
+                    const double ny = chain.correctionY[j];
+                    const double nz = chain.correctionZ[j];
+                    wx = w[0] * nx + w[1] * ny + w[2] * nz;
+                    wy = w[1] * nx + w[3] * ny + w[4] * nz;
+                    wz = w[2] * nx + w[4] * ny + w[5] * nz;
+                    chain.diagonal[j] += nx * wx + ny * wy + nz * wz;
+                }
+                if ( j > 0 )
+                {
+                    const double nx = chain.correctionX[j - 1];
+                    const double ny = chain.correctionY[j - 1];
+                    const double nz = chain.correctionZ[j - 1];
+                    chain.diagonal[j - 1] += nx * (w[0] * nx + w[1] * ny + w[2] * nz)
+                        + ny * (w[1] * nx + w[3] * ny + w[4] * nz)
+                        + nz * (w[2] * nx + w[4] * ny + w[5] * nz);
+                    if ( j < n )
+                    {
+                        chain.coupling[j - 1] += nx * wx + ny * wy + nz * wz;
+                    }
+                }
+            }
+
+            // The solve is repeated with the sections that would push fixed
+            // to their released multiplier, a few times at most: they are
+            // rare, and the last ones are clamped.
+            for (int pass=0; pass<4; ++pass)
+            {
+                // Forward elimination: upper holds the eliminated upper
+                // diagonal and lambda the eliminated right hand side. The
+                // fixed rows have no other coefficient than their diagonal,
+                // so their lambda is their correction through the passes.
+                double previousUpper = 0.0;
+                double previousLambda = 0.0;
+                for (size_t i=0; i<n; ++i)
+                {
+                    double diagonal = 1.0;
+                    double rhs = chain.lambda[i];
+                    double lower = 0.0;
+                    double upper = 0.0;
+                    if ( chain.active[i] > 0.5 )
+                    {
+                        const double alpha = chain.restLength[i] * complianceScale;
+                        diagonal = std::max((1.0 + gamma) * chain.diagonal[i] + alpha, tiny);
+                        rhs = chain.bias[i];
+                        if ( i > 0 )
+                        {
+                            lower = -(1.0 + gamma) * chain.coupling[i - 1];
+                        }
+                        if ( i + 1 < n )
+                        {
+                            upper = -(1.0 + gamma) * chain.coupling[i];
+                        }
+                    }
+
+                    const double pivot = diagonal - lower * previousUpper;
+                    previousUpper = upper / pivot;
+                    previousLambda = (rhs - lower * previousLambda) / pivot;
+                    chain.upper[i] = previousUpper;
+                    chain.lambda[i] = previousLambda;
+                }
+
+                // Back substitution.
+                for (size_t i=n-1; i>0; --i)
+                {
+                    chain.lambda[i - 1] -= chain.upper[i - 1] * chain.lambda[i];
+                }
+
+                bool pushing = false;
+                for (size_t i=0; i<n; ++i)
+                {
+                    const double lambda = iAccumulate ? -chain.tension[i] * h2 : 0.0;
+                    if ( chain.active[i] > 0.5 && lambda + chain.lambda[i] > 0.0 )
+                    {
+                        chain.active[i] = 0.0;
+                        chain.lambda[i] = -lambda;
+                        pushing = true;
+                    }
+                }
+                if ( !pushing )
+                {
+                    break;
+                }
+            }
+
+            for (size_t i=0; i<n; ++i)
+            {
+                const double lambda = iAccumulate ? -chain.tension[i] * h2 : 0.0;
+                const double deltaLambda = std::min(chain.lambda[i], -lambda);
+                chain.correctionX[i] *= deltaLambda;
+                chain.correctionY[i] *= deltaLambda;
+                chain.correctionZ[i] *= deltaLambda;
+                chain.tension[i] = -(lambda + deltaLambda) / h2;
+            }
+            ApplyCorrections(chain);
+            for (size_t k=0; k<chain.pinnedCount; ++k)
+            {
+                const size_t j = chain.pinnedNodes[k];
+                const double* w = chain.pinnedInvMass + 6 * j;
+                double px = 0.0;
+                double py = 0.0;
+                double pz = 0.0;
+                if ( j > 0 )
+                {
+                    px += chain.correctionX[j - 1];
+                    py += chain.correctionY[j - 1];
+                    pz += chain.correctionZ[j - 1];
+                }
+                if ( j < n )
+                {
+                    px -= chain.correctionX[j];
+                    py -= chain.correctionY[j];
+                    pz -= chain.correctionZ[j];
+                }
+                chain.x[j] += w[0] * px + w[1] * py + w[2] * pz;
+                chain.y[j] += w[1] * px + w[3] * py + w[4] * pz;
+                chain.z[j] += w[2] * px + w[4] * py + w[5] * pz;
+            }
+            return true;
+        }
+
+        void updateVelocities(const Chain& chain, double h)
+        {
+            const size_t split = VectorEnd(0, chain.nodeCount);
+            UpdateVelocitiesRange<VectorOps>(chain, 0, split, h);
+            UpdateVelocitiesRange<ScalarOps>(chain, split, chain.nodeCount, h);
+        }
+
+        void computeSectionFrames(const SectionFrames& frames)
+        {
+            const size_t split = VectorEnd(0, frames.sectionCount);
+            SectionFramesRange<VectorOps>(frames, 0, split);
+            SectionFramesRange<ScalarOps>(frames, split, frames.sectionCount);
+        }
+    }
+}
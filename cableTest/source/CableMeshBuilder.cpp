@@ -0,0 +1,228 @@
+#include "CableMeshBuilder.h"
+#include "CableKernels.h"
+#include "RenderSnapshot.h"
+
+#include <cmath>
+
+// A tangent or a ring axis shorter than this is taken as degenerate.
+static const double sDegenerateLength = 1e-9;
+
+// Unit vector normal to iTangent, along the axis least aligned with it.
+static Sim::Vec3 AnyNormal(const Sim::Vec3& iTangent)
+{
+    const double ax = std::fabs(iTangent.x);
+    const double ay = std::fabs(iTangent.y);
+    const double az = std::fabs(iTangent.z);
+    Sim::Vec3 axis(0.0, 0.0, 1.0);
+    if ( ax <= ay && ax <= az )
+    {
+        axis = Sim::Vec3(1.0, 0.0, 0.0);
+    }
+    else if ( ay <= az )
+    {
+        axis = Sim::Vec3(0.0, 1.0, 0.0);
+    }
+    const Sim::Vec3 normal = axis - iTangent * Sim::dot(axis, iTangent);
+    return normal * (1.0 / Sim::length(normal));
+}
+
+CableMeshBuilder::CableMeshBuilder(size_t iSideCount)
+    : mSideCount(iSideCount < 3 ? 3 : iSideCount)
+    , mSideCosines()
+    , mSideSines()
+    , mX()
+    , mY()
+    , mZ()
+    , mCenterX()
+    , mCenterY()
+    , mCenterZ()
+    , mQw()
+    , mQx()
+    , mQy()
+    , mQz()
+    , mLength()
+    , mInstanceStarts()
+    , mInstances()
+    , mPositions()
+    , mNormals()
+    , mIndices()
+    , mIndexedNodeStarts()
+    , mIndexRevision(0)
+{
+    const double pi = 3.14159265358979323846;
+    mSideCosines.resize(mSideCount);
+    mSideSines.resize(mSideCount);
+    for (size_t k=0; k<mSideCount; ++k)
+    {
+        const double angle = 2.0 * pi * static_cast<double>(k) / static_cast<double>(mSideCount);
+        mSideCosines[k] = cos(angle);
+        mSideSines[k] = sin(angle);
+    }
+}
+
+void CableMeshBuilder::buildInstances(const RenderSnapshot& iSnapshot)
+{
+    const size_t cableCount = iSnapshot.getCableCount();
+    const size_t nodeCount = iSnapshot.cableNodes.size();
+    mInstanceStarts.resize(cableCount + 1);
+    mInstances.clear();
+    if ( nodeCount < 2 )
+    {
+        for (size_t c=0; c<=cableCount; ++c)
+        {
+            mInstanceStarts[c] = 0;
+        }
+        return;
+    }
+
+    // The nodes of all the cables go through the kernel at once.
+    mX.resize(nodeCount);
+    mY.resize(nodeCount);
+    mZ.resize(nodeCount);
+    for (size_t i=0; i<nodeCount; ++i)
+    {
+        const Sim::Vec3& node = iSnapshot.cableNodes[i];
+        mX[i] = node.x;
+        mY[i] = node.y;
+        mZ[i] = node.z;
+    }
+
+    const size_t sectionCount = nodeCount - 1;
+    mCenterX.resize(sectionCount);
+    mCenterY.resize(sectionCount);
+    mCenterZ.resize(sectionCount);
+    mQw.resize(sectionCount);
+    mQx.resize(sectionCount);
+    mQy.resize(sectionCount);
+    mQz.resize(sectionCount);
+    mLength.resize(sectionCount);
+
+    Sim::CableKernels::SectionFrames frames;
+    frames.sectionCount = sectionCount;
+    frames.x = &mX[0];
+    frames.y = &mY[0];
+    frames.z = &mZ[0];
+    frames.centerX = &mCenterX[0];
+    frames.centerY = &mCenterY[0];
+    frames.centerZ = &mCenterZ[0];
+    frames.qw = &mQw[0];
+    frames.qx = &mQx[0];
+    frames.qy = &mQy[0];
+    frames.qz = &mQz[0];
+    frames.length = &mLength[0];
+    Sim::CableKernels::computeSectionFrames(frames);
+
+    size_t instanceCount = 0;
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        mInstanceStarts[c] = instanceCount;
+        const size_t cableNodeCount = iSnapshot.getCableNodeCount(c);
+        instanceCount += cableNodeCount > 1 ? cableNodeCount - 1 : 0;
+    }
+    mInstanceStarts[cableCount] = instanceCount;
+
+    mInstances.resize(instanceCount * kInstanceSize);
+    float* instance = instanceCount > 0 ? &mInstances[0] : NULL;
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        const size_t begin = iSnapshot.cableNodeStarts[c];
+        const size_t end = iSnapshot.cableNodeStarts[c + 1];
+        for (size_t i=begin; i+1<end; ++i)
+        {
+            instance[0] = static_cast<float>(mCenterX[i]);
+            instance[1] = static_cast<float>(mCenterY[i]);
+            instance[2] = static_cast<float>(mCenterZ[i]);
+            instance[3] = static_cast<float>(mQw[i]);
+            instance[4] = static_cast<float>(mQx[i]);
+            instance[5] = static_cast<float>(mQy[i]);
+            instance[6] = static_cast<float>(mQz[i]);
+            instance[7] = static_cast<float>(mLength[i]);
+            instance += kInstanceSize;
+        }
+    }
+}
+
+void CableMeshBuilder::buildTubes(const RenderSnapshot& iSnapshot)
+{
+    const size_t cableCount = iSnapshot.getCableCount();
+    const size_t vertexCount = iSnapshot.cableNodes.size() * mSideCount;
+    mPositions.resize(3 * vertexCount);
+    mNormals.resize(3 * vertexCount);
+
+    float* position = vertexCount > 0 ? &mPositions[0] : NULL;
+    float* normal = vertexCount > 0 ? &mNormals[0] : NULL;
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        const size_t nodeCount = iSnapshot.getCableNodeCount(c);
+        const double radius = iSnapshot.cableRadii[c];
+        Sim::Vec3 tangent(0.0, 0.0, 1.0);
+        Sim::Vec3 axis = AnyNormal(tangent);
+        for (size_t i=0; i<nodeCount; ++i)
+        {
+            // Central differences inside the cable, one-sided at its ends.
+            const Sim::Vec3 delta = iSnapshot.getCableNode(c, i + 1 < nodeCount ? i + 1 : i) - iSnapshot.getCableNode(c, i > 0 ? i - 1 : i);
+            const double deltaLength = Sim::length(delta);
+            if ( deltaLength > sDegenerateLength )
+            {
+                tangent = delta * (1.0 / deltaLength);
+            }
+
+            // Carry the ring axis of the previous node onto the plane
+            // normal to the new tangent.
+            axis = axis - tangent * Sim::dot(axis, tangent);
+            const double axisLength = Sim::length(axis);
+            axis = axisLength > sDegenerateLength ? axis * (1.0 / axisLength) : AnyNormal(tangent);
+            const Sim::Vec3 side = Sim::cross(tangent, axis);
+
+            const Sim::Vec3& center = iSnapshot.getCableNode(c, i);
+            for (size_t k=0; k<mSideCount; ++k)
+            {
+                const Sim::Vec3 direction = axis * mSideCosines[k] + side * mSideSines[k];
+                position[0] = static_cast<float>(center.x + radius * direction.x);
+                position[1] = static_cast<float>(center.y + radius * direction.y);
+                position[2] = static_cast<float>(center.z + radius * direction.z);
+                normal[0] = static_cast<float>(direction.x);
+                normal[1] = static_cast<float>(direction.y);
+                normal[2] = static_cast<float>(direction.z);
+                position += 3;
+                normal += 3;
+            }
+        }
+    }
+
+    if ( mIndexedNodeStarts != iSnapshot.cableNodeStarts )
+    {
+        _buildIndices(iSnapshot);
+    }
+}
+
+void CableMeshBuilder::_buildIndices(const RenderSnapshot& iSnapshot)
+{
+    mIndexedNodeStarts = iSnapshot.cableNodeStarts;
+    ++mIndexRevision;
+
+    // Two triangles per side of each section, turning counterclockwise
+    // around the cable seen from its end so that they face outwards.
+    mIndices.clear();
+    const unsigned int sideCount = static_cast<unsigned int>(mSideCount);
+    for (size_t c=0; c<iSnapshot.getCableCount(); ++c)
+    {
+        const size_t begin = iSnapshot.cableNodeStarts[c];
+        const size_t end = iSnapshot.cableNodeStarts[c + 1];
+        for (size_t i=begin; i+1<end; ++i)
+        {
+            const unsigned int ring = static_cast<unsigned int>(i) * sideCount;
+            for (unsigned int k=0; k<sideCount; ++k)
+            {
+                const unsigned int a = ring + k;
+                const unsigned int b = ring + (k + 1) % sideCount;
+                mIndices.push_back(a);
+                mIndices.push_back(b);
+                mIndices.push_back(b + sideCount);
+                mIndices.push_back(a);
+                mIndices.push_back(b + sideCount);
+                mIndices.push_back(a + sideCount);
+            }
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#include "CableTelemetry.h"
+#include "NativeScene.h"
+
+CableTelemetry::Settings::Settings()
+    : maxSectionCount(256)
+    , capacity(1024)
+{
+}
+
+// Every slot of the ring gets its sections from this frame, publish() only
+// overwrites them.
+static CableTelemetry::Frame MakeEmptyFrame(size_t iMaxSectionCount)
+{
+    CableTelemetry::Frame frame;
+    frame.step = 0;
+    frame.time = 0.0;
+    frame.cable = Sim::kInvalidId;
+    frame.broken = false;
+    frame.sectionCount = 0;
+    frame.maxTension = 0.0;
+    frame.maxTensionSection = 0;
+    frame.sections.resize(iMaxSectionCount);
+    return frame;
+}
+
+CableTelemetry::CableTelemetry(const Settings& iSettings)
+    : mFrames(iSettings.capacity, MakeEmptyFrame(iSettings.maxSectionCount))
+    , mBreaks(iSettings.capacity)
+    , mTruncatedCount(0)
+    , mPublishedCount(0)
+    , mReportedBreakCounts()
+{
+}
+
+void CableTelemetry::publish(const Sim::NativeScene& iScene)
+{
+    const size_t cableCount = iScene.getCableCount();
+    if ( mReportedBreakCounts.size() < cableCount )
+    {
+        // Only on the first call, or if cables were added. The breaks
+        // restored from a checkpoint were reported by the run that saved it.
+        const size_t firstCable = mReportedBreakCounts.size();
+        mReportedBreakCounts.resize(cableCount, 0);
+        for (size_t c=firstCable; c<cableCount; ++c)
+        {
+            mReportedBreakCounts[c] = iScene.getCable(static_cast<Sim::CableId>(c)).getRestoredBreakCount();
+        }
+    }
+
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        const Sim::CableId cable = static_cast<Sim::CableId>(c);
+        const Sim::CableChain& chain = iScene.getCable(cable);
+        const size_t sectionCount = chain.getSectionCount();
+
+        // The chain keeps its breaks in order with their section renumbered
+        // as the layout changes, so the new ones are those after the
+        // reported ones. A chain restored from a checkpoint since may have
+        // fewer.
+        if ( chain.getBreakCount() < mReportedBreakCounts[c] )
+        {
+            mReportedBreakCounts[c] = chain.getBreakCount();
+        }
+        for (size_t i=mReportedBreakCounts[c]; i<chain.getBreakCount(); ++i)
+        {
+            const Sim::CableChain::SectionBreak& sectionBreak = chain.getBreak(i);
+            Break event;
+            event.step = iScene.getStepCount();
+            event.time = iScene.getTime();
+            event.cable = cable;
+            event.section = sectionBreak.section;
+            event.tension = sectionBreak.tension;
+            mBreaks.push(event);
+        }
+        mReportedBreakCounts[c] = chain.getBreakCount();
+
+        Frame* slot = mFrames.beginPush();
+        if ( NULL == slot )
+        {
+            continue;
+        }
+
+        Frame& frame = *slot;
+        frame.step = iScene.getStepCount();
+        frame.time = iScene.getTime();
+        frame.cable = cable;
+        frame.broken = chain.isBroken();
+        frame.sectionCount = sectionCount;
+        frame.maxTension = 0.0;
+        frame.maxTensionSection = 0;
+
+        const size_t storedCount = sectionCount < frame.sections.capacity() ? sectionCount : frame.sections.capacity();
+        if ( storedCount < sectionCount )
+        {
+            mTruncatedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Within the capacity reserved by the constructor.
+        frame.sections.resize(storedCount);
+        Sim::Vec3 start = sectionCount > 0 ? chain.getNodePosition(0) : Sim::Vec3();
+        for (size_t i=0; i<sectionCount; ++i)
+        {
+            const Sim::Vec3 end = chain.getNodePosition(i + 1);
+            const double tension = chain.getSectionTension(i);
+            if ( tension > frame.maxTension )
+            {
+                frame.maxTension = tension;
+                frame.maxTensionSection = i;
+            }
+
+            if ( i < storedCount )
+            {
+                const double restLength = chain.getSectionRestLength(i);
+                Section& section = frame.sections[i];
+                section.tension = static_cast<float>(tension);
+                section.strain = static_cast<float>((Sim::length(end - start) - restLength) / restLength);
+                section.broken = chain.isSectionBroken(i);
+            }
+            start = end;
+        }
+
+        mFrames.endPush();
+    }
+
+    ++mPublishedCount;
+}
+
+bool CableTelemetry::pop(Frame& oFrame)
+{
+    const Frame* slot = mFrames.beginPop();
+    if ( NULL == slot )
+    {
+        return false;
+    }
+
+    const Frame& frame = *slot;
+    oFrame.step = frame.step;
+    oFrame.time = frame.time;
+    oFrame.cable = frame.cable;
+    oFrame.broken = frame.broken;
+    oFrame.sectionCount = frame.sectionCount;
+    oFrame.maxTension = frame.maxTension;
+    oFrame.maxTensionSection = frame.maxTensionSection;
+    oFrame.sections.assign(frame.sections.begin(), frame.sections.end());
+
+    mFrames.endPop();
+    return true;
+}
+
+bool CableTelemetry::popBreak(Break& oBreak)
+{
+    return mBreaks.pop(oBreak);
+}
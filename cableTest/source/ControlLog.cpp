@@ -0,0 +1,135 @@
+#include "ControlLog.h"
+#include "MyCrane.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+ControlLog::ControlLog()
+    : mEvents()
+    , mStep(0)
+    , mTime(0.0)
+    , mNextEvent(0)
+{
+}
+
+void ControlLog::add(Control iControl, double iSpeed)
+{
+    Event event;
+    event.step = mStep;
+    event.time = mTime;
+    event.control = iControl;
+    event.speed = iSpeed;
+    mEvents.push_back(event);
+}
+
+void ControlLog::apply(size_t iStep, MyCrane& iCrane)
+{
+    // Events of skipped steps are applied late rather than lost.
+    while ( mNextEvent < mEvents.size() && mEvents[mNextEvent].step <= iStep )
+    {
+        const Event& event = mEvents[mNextEvent++];
+        switch ( event.control )
+        {
+        case kControlElongation:
+            iCrane.setElongationSpeed(event.speed);
+            break;
+
+        case kControlElevation:
+            iCrane.setElevationSpeed(event.speed);
+            break;
+
+        case kControlWinch:
+            iCrane.setWinchSpeed(event.speed);
+            break;
+        }
+    }
+}
+
+const char* ControlLog::getControlName(Control iControl)
+{
+    switch ( iControl )
+    {
+    case kControlElongation:
+        return "elongation";
+    case kControlElevation:
+        return "elevation";
+    case kControlWinch:
+        return "winch";
+    default:
+        return "unknown";
+    }
+}
+
+bool ControlLog::save(const std::string& iFileName) const
+{
+    std::ofstream stream(iFileName.c_str());
+    if ( !stream )
+    {
+        std::cout << "Cannot write the control log to " << iFileName << std::endl;
+        return false;
+    }
+
+    stream << "# step time control speed" << std::endl;
+    stream << std::setprecision(17);
+    for (size_t i=0; i<mEvents.size(); ++i)
+    {
+        const Event& event = mEvents[i];
+        stream << event.step << " " << event.time << " " << getControlName(event.control) << " " << event.speed << "\n";
+    }
+
+    return stream.good();
+}
+
+bool ControlLog::load(const std::string& iFileName)
+{
+    std::ifstream stream(iFileName.c_str());
+    if ( !stream )
+    {
+        std::cout << "Cannot read the control log " << iFileName << std::endl;
+        return false;
+    }
+
+    mEvents.clear();
+    mNextEvent = 0;
+
+    std::string line;
+    for (size_t lineNumber=1; std::getline(stream, line); ++lineNumber)
+    {
+        if ( line.empty() || '#' == line[0] )
+        {
+            continue;
+        }
+
+        std::istringstream lineStream(line);
+        Event event;
+        std::string control;
+        bool valid = static_cast<bool>(lineStream >> event.step >> event.time >> control >> event.speed);
+        if ( control == "elongation" )
+        {
+            event.control = kControlElongation;
+        }
+        else if ( control == "elevation" )
+        {
+            event.control = kControlElevation;
+        }
+        else if ( control == "winch" )
+        {
+            event.control = kControlWinch;
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if ( !valid || (!mEvents.empty() && event.step < mEvents.back().step) )
+        {
+            std::cout << iFileName << ":" << lineNumber << ": invalid event \"" << line << "\"" << std::endl;
+            return false;
+        }
+        mEvents.push_back(event);
+    }
+
+    return true;
+}
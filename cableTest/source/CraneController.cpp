@@ -0,0 +1,208 @@
+#include "CraneController.h"
+#include "MyCrane.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+VelocityProfile::VelocityProfile()
+    : mSetpoints()
+    , mCursor(0)
+{
+}
+
+bool VelocityProfile::add(double iTime, double iVelocity)
+{
+    const Setpoint setpoint = { iTime, iVelocity };
+    return add(&setpoint, 1);
+}
+
+bool VelocityProfile::add(const Setpoint* iSetpoints, size_t iCount)
+{
+    double time = getEndTime();
+    for (size_t i=0; i<iCount; ++i)
+    {
+        if ( (!mSetpoints.empty() || i > 0) && iSetpoints[i].time < time )
+        {
+            return false;
+        }
+        time = iSetpoints[i].time;
+    }
+
+    mSetpoints.insert(mSetpoints.end(), iSetpoints, iSetpoints + iCount);
+    return true;
+}
+
+bool VelocityProfile::addTrapezoid(double iStartTime, double iDistance, double iMaxVelocity, double iAcceleration)
+{
+    if ( iMaxVelocity <= 0.0 || iAcceleration <= 0.0 )
+    {
+        return false;
+    }
+
+    const double sign = iDistance < 0.0 ? -1.0 : 1.0;
+    const double distance = fabs(iDistance);
+
+    // Time to reach the max velocity, and the distance covered meanwhile.
+    double rampTime = iMaxVelocity / iAcceleration;
+    double velocity = iMaxVelocity;
+    double cruiseTime = 0.0;
+    if ( iAcceleration * rampTime * rampTime >= distance )
+    {
+        // Triangular: ramp up over half the distance and down again.
+        rampTime = sqrt(distance / iAcceleration);
+        velocity = iAcceleration * rampTime;
+    }
+    else
+    {
+        cruiseTime = (distance - iAcceleration * rampTime * rampTime) / iMaxVelocity;
+    }
+
+    const Setpoint setpoints[] =
+    {
+        { iStartTime, 0.0 },
+        { iStartTime + rampTime, sign * velocity },
+        { iStartTime + rampTime + cruiseTime, sign * velocity },
+        { iStartTime + 2.0 * rampTime + cruiseTime, 0.0 }
+    };
+    return add(setpoints, 4);
+}
+
+void VelocityProfile::clear()
+{
+    mSetpoints.clear();
+    mCursor = 0;
+}
+
+double VelocityProfile::evaluate(double iTime)
+{
+    if ( mSetpoints.empty() )
+    {
+        return 0.0;
+    }
+
+    // The cursor only moves forward; going back in time restarts the search.
+    if ( mCursor > 0 && iTime < mSetpoints[mCursor - 1].time )
+    {
+        mCursor = 0;
+    }
+    while ( mCursor < mSetpoints.size() && mSetpoints[mCursor].time <= iTime )
+    {
+        ++mCursor;
+    }
+
+    if ( 0 == mCursor )
+    {
+        return mSetpoints.front().velocity;
+    }
+    if ( mSetpoints.size() == mCursor )
+    {
+        return mSetpoints.back().velocity;
+    }
+
+    const Setpoint& before = mSetpoints[mCursor - 1];
+    const Setpoint& after = mSetpoints[mCursor];
+    const double ratio = (iTime - before.time) / (after.time - before.time);
+    return before.velocity + ratio * (after.velocity - before.velocity);
+}
+
+static bool ParseMotor(const std::string& iName, CraneController::Motor& oMotor)
+{
+    if ( iName == "elongation" )
+    {
+        oMotor = CraneController::kMotorElongation;
+    }
+    else if ( iName == "elevation" )
+    {
+        oMotor = CraneController::kMotorElevation;
+    }
+    else if ( iName == "winch" )
+    {
+        oMotor = CraneController::kMotorWinch;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+CraneController::CraneController(MyCrane& iCrane)
+    : mCrane(iCrane)
+{
+}
+
+bool CraneController::load(const std::string& iFileName)
+{
+    std::ifstream stream(iFileName.c_str());
+    if ( !stream )
+    {
+        std::cout << "Cannot read the crane motion " << iFileName << std::endl;
+        return false;
+    }
+
+    std::string line;
+    for (size_t lineNumber=1; std::getline(stream, line); ++lineNumber)
+    {
+        const size_t comment = line.find('#');
+        if ( comment != std::string::npos )
+        {
+            line.erase(comment);
+        }
+
+        std::istringstream lineStream(line);
+        std::string keyword;
+        if ( !(lineStream >> keyword) )
+        {
+            continue;
+        }
+
+        bool valid = false;
+        Motor motor = kMotorWinch;
+        if ( keyword == "trapezoid" )
+        {
+            std::string motorName;
+            double start, distance, maxVelocity, acceleration;
+            valid = (lineStream >> motorName >> start >> distance >> maxVelocity >> acceleration)
+                && ParseMotor(motorName, motor)
+                && mProfiles[motor].addTrapezoid(start, distance, maxVelocity, acceleration);
+        }
+        else
+        {
+            double time, velocity;
+            valid = ParseMotor(keyword, motor)
+                && (lineStream >> time >> velocity)
+                && mProfiles[motor].add(time, velocity);
+        }
+
+        if ( !valid )
+        {
+            std::cout << iFileName << ":" << lineNumber << ": invalid entry \"" << line << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CraneController::apply(double iTime)
+{
+    if ( !mProfiles[kMotorElongation].isEmpty() )
+    {
+        mCrane.setElongationSpeed(mProfiles[kMotorElongation].evaluate(iTime));
+    }
+    if ( !mProfiles[kMotorElevation].isEmpty() )
+    {
+        mCrane.setElevationSpeed(mProfiles[kMotorElevation].evaluate(iTime));
+    }
+    if ( !mProfiles[kMotorWinch].isEmpty() )
+    {
+        mCrane.setWinchSpeed(mProfiles[kMotorWinch].evaluate(iTime));
+    }
+}
+
+void CraneController::preSubstep(double iTime, double h)
+{
+    apply(iTime + 0.5 * h);
+}
@@ -1,48 +1,24 @@
 #include "ExCableSystem.h"
+#include "CableDefinitionLoader.h"
 #include "MyCrane.h"
 
-#include <CableSystems/CableSystemsICD.h>
-#include <CableSystems/DynamicsICD.h>
-
-#ifdef USE_OSG
-#include <CableSystems/GraphicsICD.h>
-
-#include <VxGraphics/ICamera.h>
-#include <VxGraphics/IGraphicICD.h>
-#include <VxGraphicsPlugins/LightICD.h>
-#include <VxGraphicsPlugins/PerspectiveICD.h>
-#endif
-
-#include <VxPluginSystem/VxPluginSystem.h>
-
-#include <VxSim/VxApplication.h>
-#include <VxSim/VxExtensionFactory.h>
-
-#include <VxData/Container.h>
-#include <VxData/FieldArray.h>
-#include <VxData/FieldBase.h>
-
-#include <Vx/Find.h>
-#include <Vx/VxAssembly.h>
-#include <Vx/VxBox.h>
-#include <Vx/VxCollisionGeometry.h>
-#include <Vx/VxConnectionFactory.h>
-#include <Vx/VxHinge.h>
-#include <Vx/VxMessage.h>
-#include <Vx/VxPart.h>
-#include <Vx/VxTransform.h>
-
+#include <algorithm>
+#include <cassert>
+#include <iostream>
 #include <string>
 
-using namespace Vx;
-using namespace CableSystems;
-using namespace CableSystems::DynamicsICD;
+using Sim::Vec3;
 
 static const std::string sLoadAssemblyName("LoadAssembly");
 static const std::string sLoadName("Load");
 static const std::string sMyDynamicsExtensionName("My CableSystems Dynamics extension");
 static const std::string sMyGraphicsExtensionName("My CableSystems Graphics extension");
 
+static double DegreeToRadian(double degree)
+{
+    return degree * 3.14159265358979323846 / 180.0;
+}
+
 // The main focus of this tutorial is to show how to use the CableSystems ICD to create a
 // cable system for a simple crane.
 //
@@ -60,55 +36,45 @@ static const std::string sMyGraphicsExtensionName("My CableSystems Graphics exte
 //
 
 
-// Go through all the assemblies in the mechanism and return
-// the first one with the given name as parameter.
-//
-// @param[IN] mech  The mechanism in which the assembly should be found
-// @param[IN] name  The name of the assembly to find
-//
-// Returns the found assembly or NULL.
-static VxAssembly* GetAssemblyInMechanismFromName(const VxSim::VxMechanism* mech, const std::string& name)
+ExCableSystem::Settings::Settings()
+    : loadMass(400.0)
+    , cableLoader(NULL)
+    , axialStiffness(0.0)
+    , axialDamping(0.0)
+    , maxSectionLength(0.0)
+    , maxTension(0.0)
+    , adaptiveSections(false)
+    , implicitCables(false)
 {
-    const size_t count = mech->getAssemblyCount();
-    for (size_t i=0; i<count; ++i)
-    {
-        VxAssembly* assembly = mech->getAssembly(i);
-        if ( name == assembly->getName() )
-        {
-            return assembly;
-        }
-    }
-
-    return NULL;
 }
 
 // The object is created only to setup the tutorial.
-ExCableSystem::ExCableSystem()
-    : mScene()
+ExCableSystem::ExCableSystem(Sim::IScene& iScene, const Settings& iSettings)
+    : _jTestMechanism(Sim::kInvalidId)
+    , _jTestPart(Sim::kInvalidId)
+    , mScene(iScene)
+    , mSettings(iSettings)
     , mCrane(NULL)
-    , mLoadMechanism()
+    , mLoadMechanism(Sim::kInvalidId)
+    , mCable(Sim::kInvalidId)
 {
     // Create the scene with the different mechanisms;
     // i.e., crane, load, ground.
-    mScene = _createScene();
+    _createScene();
 
     // The crane mechanism is created. It is now possible to create the cable system
     // with respect to the parts inside the crane.
-   _createCableSystemForCrane();
+   mCable = _createCableSystemForCrane();
 
-#ifdef USE_OSG
    // The cable system is displayed with a graphic extension since it is not
    // in Vortex by default, unlike the collision geometries.
-   VxSim::VxExtension* gfxExtension = VxSim::VxExtensionFactory::create(CableSystems::GraphicsICD::kFactoryKey);
-   VxAssert(NULL != gfxExtension, "Cannot create the CableSystem Graphic Plugin\n");
-   gfxExtension->setName(sMyGraphicsExtensionName.c_str());
-
-   mCrane->getMechanism()->add(gfxExtension);
-
-   VxSim::VxExtension* dynExtension = mCrane->getMechanism()->findExtension(sMyDynamicsExtensionName);
+   if ( Sim::kInvalidId != mCable )
+   {
+       mScene.addCableGraphics(mCrane->getMechanism(), mCable, sMyGraphicsExtensionName);
+   }
 
-   VxConnectionFactory::create(dynExtension->getOutput(kCablesID), gfxExtension->getInput(kCablesID));
-#endif
+   // The loader is only valid during the construction.
+   mSettings.cableLoader = NULL;
 }
 
 // Default destructor
@@ -117,253 +83,228 @@ ExCableSystem::~ExCableSystem()
     delete mCrane;
 }
 
-// Return the created scene
-VxSim::VxScene* ExCableSystem::getScene()
-{
-    return mScene.get();
-}
-
 // Create the scene with the different mechanisms;
 // i.e., crane, load, ground.
-VxSim::VxScene* ExCableSystem::_createScene()
+void ExCableSystem::_createScene()
 {
-    VxSim::VxScene* scene = new VxSim::VxScene();
-
     // The crane object contains the mechanism for the crane; it also enables the
     // motion of the crane.
-    mCrane = new MyCrane();
-    scene->add(mCrane->getMechanism());
+    mCrane = new MyCrane(mScene);
 
-#ifdef USE_OSG
     // Create a light and add it to the scene
-    Vx::VxSmartPtr<VxSim::VxExtension> light = VxSim::VxExtensionFactory::create(VxGraphicsPlugins::LightICD::kDirectionalLightFactoryKey);
-    light->getInput(VxGraphicsPlugins::IGraphicICD::kInputOrientation)->setValue(Vx::VxVector3(VX_DEG2RAD(150.0), 0.0, 0.0));
-    scene->add(light.get());
-#endif
+    mScene.addDirectionalLight(Vec3(DegreeToRadian(150.0), 0.0, 0.0));
 
     // Create the load in its own mechanism.
     mLoadMechanism = _createLoad();
-    scene->add(mLoadMechanism.get());
 
     // Create a mechanism for the ground.
-    scene->add(_createGround());
+    _createGround();
 
 /*************
  * J's test
  */
-	VxSim::VxMechanism* jMechanism = new VxSim::VxMechanism();
+	_jTestMechanism = mScene.createMechanism("");
 	
-	VxAssembly* jAssembly = new VxAssembly();
-	jAssembly->setName("jTest");
-	VxPart* jPart = new VxPart(200.0);
-	_jTestPart = jPart;
-	jAssembly->addPart(jPart);
-	//jPart->setControl(Vx::VxPart::kControlStatic);
-	//jPart->setControl(Vx::VxPart::kControlDynamic);
-	jPart->setControl(Vx::VxPart::kControlAnimated);
-	jPart->setPosition(0.0,28.0, 5.0);
-
-	VxCollisionGeometry* jGeometry = new VxCollisionGeometry( new VxBox(1.0, 1.0, 1.0) );
-	jPart->addCollisionGeometry(jGeometry);
-
-	jMechanism->addAssembly(jAssembly);
-
-	scene->add(jMechanism);
+	Sim::AssemblyId jAssembly = mScene.createAssembly(_jTestMechanism, "jTest");
+	_jTestPart = mScene.createPart(jAssembly, Sim::PartDefinition("jTestPart", Sim::kPartAnimated, Vec3(0.0,28.0, 5.0), 200.0));
+
+	mScene.addBox(_jTestPart, Vec3(1.0, 1.0, 1.0));
 /*************/
 
 
 
-#ifdef USE_OSG
     // Create a camera for the scene.
-    Vx::VxSmartPtr<VxSim::VxExtension> freeCameraExtension = VxSim::VxExtensionFactory::create(VxGraphicsPlugins::PerspectiveICD::kExtensionFactoryKey);
-    VxGraphics::ICamera* freeCamera = VxGraphics::ICamera::getInterface(freeCameraExtension.get());
-
     // Position the camera in the world.
-    Vx::VxTransform tm = Vx::VxTransform(Vx::VxVector3(-50,-35, 35), Vx::VxEulerAngles(VX_DEG2RAD(-15), VX_DEG2RAD(25), VX_DEG2RAD(40)));
-    freeCamera->setTransform(tm);
-
-    // Add a camera to the scene.
-    scene->add(freeCameraExtension.get());
-#endif
-
-    return scene;
+    mScene.addCamera(Sim::Pose(Vec3(-50,-35, 35), Vec3(DegreeToRadian(-15), DegreeToRadian(25), DegreeToRadian(40))));
 }
 
 
 // Create the load mechanism and return it.
-// The caller owns the pointer.
-VxSim::VxMechanism* ExCableSystem::_createLoad()
+Sim::MechanismId ExCableSystem::_createLoad()
 {
     // Create the mechanism.
-    VxSim::VxMechanism* mechanism = new VxSim::VxMechanism();
+    Sim::MechanismId mechanism = mScene.createMechanism("");
 
-    mechanism->addAssembly(_createLoadAssembly());
+    _createLoadAssembly(mechanism);
 
     return mechanism;
 }
 
 
 // Create the ground mechanism and return it.
-// The caller owns the pointer.
-VxSim::VxMechanism* ExCableSystem::_createGround()
+Sim::MechanismId ExCableSystem::_createGround()
 {
     // Create the mechanism.
-    VxSim::VxMechanism *groundMechanism = new VxSim::VxMechanism();
+    Sim::MechanismId groundMechanism = mScene.createMechanism("");
 
-    groundMechanism->addAssembly(_createGroundAssembly());
+    _createGroundAssembly(groundMechanism);
 
     return groundMechanism;
 }
 
 // Create the ground assembly and return it.
-// The caller owns the pointer.
-VxAssembly* ExCableSystem::_createGroundAssembly()
+Sim::AssemblyId ExCableSystem::_createGroundAssembly(Sim::MechanismId iMechanism)
 {
-    VxAssembly* groundAssembly = new VxAssembly();
-    groundAssembly->setName("groundAssembly");
+    Sim::AssemblyId groundAssembly = mScene.createAssembly(iMechanism, "groundAssembly");
 
     // The ground is static. It behaves as having infinite mass.
     // Therefore, you don't need to set the ground's mass.
-    VxPart* groundPart = new VxPart();
-    groundAssembly->addPart(groundPart);
-
     // It is set as static since the ground must not move when force is applied to it.
     // It supports the crane and the load; it does not fall under gravity.
-    groundPart->setControl(Vx::VxPart::kControlStatic);
     // It is not required to set the name of the part, but it makes it easier to find the ground part in the debugger.
-    groundPart->setName("groundPart");
     // Center the ground at (0,0) and set the ground to be at z=-0.1; i.e., the top of the collision geometry to be at z=0.
-    groundPart->setPosition(0.0, 0.0, -0.1);
+    Sim::PartId groundPart = mScene.createPart(groundAssembly, Sim::PartDefinition("groundPart", Sim::kPartStatic, Vec3(0.0, 0.0, -0.1)));
     // Make the box big enough to have space around the crane.
-    groundPart->addCollisionGeometry(new VxCollisionGeometry(new VxBox(100.0, 100.0, 0.2)));
+    mScene.addBox(groundPart, Vec3(100.0, 100.0, 0.2));
 
     return groundAssembly;
 }
 
 
 // Create the load assembly and return it.
-// The caller owns the pointer.
-VxAssembly* ExCableSystem::_createLoadAssembly()
+Sim::AssemblyId ExCableSystem::_createLoadAssembly(Sim::MechanismId iMechanism)
 {
-    VxAssembly* loadAssembly = new VxAssembly();
-    loadAssembly->setName(sLoadAssemblyName.c_str());
-
-    const VxReal mass = 400.0;
-    VxPart* loadPart = new VxPart(mass);
-    loadAssembly->addPart(loadPart);
+    Sim::AssemblyId loadAssembly = mScene.createAssembly(iMechanism, sLoadAssemblyName);
 
     // The load should move by the forces applied to it; hence, it must be dynamic.
-    loadPart->setControl(Vx::VxPart::kControlDynamic);
     // It is not required to set the name of the part, but it makes it easier to find the ground part in the debugger.
-    loadPart->setName(sLoadName.c_str());
-    loadPart->setPosition(0.0, 28.0, 0.5);
+    const double mass = mSettings.loadMass;
+    Sim::PartId loadPart = mScene.createPart(loadAssembly, Sim::PartDefinition(sLoadName, Sim::kPartDynamic, Vec3(0.0, 28.0, 0.5), mass));
 
-    VxCollisionGeometry* collisionGeometry = new VxCollisionGeometry(new VxBox(1.0, 1.0, 1.0));
-    loadPart->addCollisionGeometry(collisionGeometry);
+    mScene.addBox(loadPart, Vec3(1.0, 1.0, 1.0));
 
     return loadAssembly;
 }
 
 // Create the cable system and set its definition to behave correctly for
 // the crane and load mechanisms.
-void ExCableSystem::_createCableSystemForCrane()
+Sim::CableId ExCableSystem::_createCableSystemForCrane()
 {
 
-    VxSim::VxMechanism* craneMechanism = mCrane->getMechanism();
-    VxAssembly* craneAssembly = GetAssemblyInMechanismFromName(craneMechanism, MyCrane::sCraneAssemblyName);
-    if ( NULL == craneAssembly )
+    Sim::MechanismId craneMechanism = mCrane->getMechanism();
+    Sim::AssemblyId craneAssembly = mScene.findAssembly(craneMechanism, MyCrane::sCraneAssemblyName);
+    if ( Sim::kInvalidId == craneAssembly )
     {
-        VxWarning(0, "The crane assembly was not found in the crane mechanism.\n");
-        return;
+        std::cout << "The crane assembly was not found in the crane mechanism." << std::endl;
+        return Sim::kInvalidId;
     }
 
-    VxSim::VxExtension* cableSystemExtension =  VxSim::VxExtensionFactory::create(CableSystemsICD::Extensions::kDynamicsKey);
-    cableSystemExtension->setName(sMyDynamicsExtensionName.c_str());
-    // Since the crane use the cable system, it makes sense to add it
-    // to the crane mechanism.
-    craneMechanism->add(cableSystemExtension);
-
-    // The cable system always has a definition. Retrieve it to fill it
-    // with the good definitions.
-    VxData::Container& container = cableSystemExtension->getParameterContainer();
-    VxData::FieldBase& defFieldBase = container[kDefinitionID];
-    VxData::Container& definition = dynamic_cast<VxData::Container&>(defFieldBase);
-    VxData::FieldBase& fieldBasePoints = definition[CableSystemDefinitionContainerID::kPointDefinitionsID];
-//    if ( ! fieldBasePoints["size"].setValue(static_cast<unsigned int>(4)) ) // We will set 4 items below
-    if ( ! fieldBasePoints["size"].setValue(static_cast<unsigned int>(5)) ) // We will set 5 items below
+    Sim::CableDefinition definition;
+    if ( mSettings.cableLoader )
     {
-        VxFatalError(0, "Cannot resize the List of PointDefinition\n");
+        // The cable comes from a definition file; its parts can be in any
+        // mechanism of the tutorial.
+        std::vector<Sim::MechanismId> mechanisms;
+        mechanisms.push_back(craneMechanism);
+        mechanisms.push_back(mLoadMechanism);
+        mechanisms.push_back(_jTestMechanism);
+        if ( !mSettings.cableLoader->resolve(mScene, mechanisms, definition) )
+        {
+            return Sim::kInvalidId;
+        }
+        _applySettings(definition);
+        return mScene.createCable(craneMechanism, definition);
     }
 
+    definition.name = sMyDynamicsExtensionName;
 
     // The cable system starts at the winch pass over the mid pulley, then the tip pulley and ends at the load.
     // Create the point definition for each contact of the cable with a part.
-    VxData::Container* winch = dynamic_cast<VxData::Container*>(&(fieldBasePoints["0"]));
-
-    (*winch)[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kWinch));
-    (*winch)[PointDefinitionContainerID::kVxPartID].setValue(Vx::Find::part(MyCrane::sWinchName, craneAssembly));
-
     // IMPORTANT: The mid point must be added in the right order.
-    VxData::Container& midPulley = dynamic_cast<VxData::Container&>(fieldBasePoints["1"]);
-    midPulley[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kPulley));
-    midPulley[PointDefinitionContainerID::kVxPartID].setValue(Vx::Find::part(MyCrane::sMidPulleyName, craneAssembly));
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableWinch, mScene.findPart(craneAssembly, MyCrane::sWinchName)));
+
+    Sim::CablePointDefinition midPulley(Sim::kCablePulley, mScene.findPart(craneAssembly, MyCrane::sMidPulleyName));
     // In some cases, CableSystems might not be able to correctly deduce on which side the cable passes.
     // This usually is the case for the winch because it has only one point to use for its deduction.
     // After launching the application for the first time, or stepping through the debugger, it is easy to spot this problem.
     // Sometimes, you can help CableSystems by inverting the guess with:
-    if ( !midPulley[PulleyDefinitionContainerID::kInverseWrappingID].setValue(true) )
-    {
-        VxInfo(0, "Cannot set the value of the inverse wrapping in the mid pulley\n");
-    }
+    midPulley.inverseWrapping = true;
+    definition.points.push_back(midPulley);
 
-    VxData::Container& tipPulley = dynamic_cast<VxData::Container&>(fieldBasePoints["2"]);
-    tipPulley[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kPulley));
-    tipPulley[PointDefinitionContainerID::kVxPartID].setValue(Vx::Find::part(MyCrane::sTipPulleyName, craneAssembly));
-
-	VxData::Container& ringHook = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	ringHook[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kRing));
-    ringHook[PointDefinitionContainerID::kVxPartID].setValue(_jTestPart);
-	ringHook[RingDefinitionContainerID::kRelativePrimaryAxisID].setValue(VxVector3(1, 0, 0));
-
-    VxAssembly* loadAssembly = _getLoadAssembly();
-    VxPart* load = Vx::Find::part(sLoadName, loadAssembly);
-    VX_ASSERT(NULL != load, "A part named \"load\" must be in the load assembly.\n");
-    const VxVector3 offset(0,0,-0.5); // Needed to attach on the top of the load and not at the center of mass.
-    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["4"]);
-    attachmentPoint[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint[PointDefinitionContainerID::kVxPartID].setValue(load);
-    attachmentPoint[PointDefinitionContainerID::kOffsetID].setValue(offset);
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCablePulley, mScene.findPart(craneAssembly, MyCrane::sTipPulleyName)));
+
+	Sim::CablePointDefinition ringHook(Sim::kCableRing, _jTestPart);
+	ringHook.ringPrimaryAxis = Vec3(1, 0, 0);
+    definition.points.push_back(ringHook);
+
+    Sim::AssemblyId loadAssembly = _getLoadAssembly();
+    Sim::PartId load = mScene.findPart(loadAssembly, sLoadName);
+    assert(Sim::kInvalidId != load && "A part named \"load\" must be in the load assembly.");
+    const Vec3 offset(0,0,-0.5); // Needed to attach on the top of the load and not at the center of mass.
+    definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, load, offset));
 
     // Get the last segment and change its parameters
     // Segments: "0" Arc on winch, "1" Segment between winch and midPulley, "2" Arc on midPulley
     //           "3" Segment between midPulley and tipPulley, "4" Arc on tipPulley,
-    //           "5" Segment between tipPulley and Load
-    VxData::FieldBase& fieldBaseSegments = definition[CableSystemDefinitionContainerID::kSegmentDefinitionsID];
-    VxData::Container& lastSegmentDefinition = dynamic_cast<VxData::Container&>(fieldBaseSegments["5"]);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(1.0);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	//lastSegmentDefinition[SegmentDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
-
-    VxData::Container& lastSegmentDefinition2 = dynamic_cast<VxData::Container&>(fieldBaseSegments["6"]);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(3.0);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	lastSegmentDefinition2[SegmentDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
-
-    VxData::FieldBase& fieldBaseParams = definition[CableSystemDefinitionContainerID::kParamDefinitionID];
-    VxData::Container& params = dynamic_cast<VxData::Container&>(fieldBaseParams);
-    params[CableSystemParamDefinitionContainerID::kAxialStiffnessID].setValue(10000.0);
-    params[CableSystemParamDefinitionContainerID::kAxialDampingID].setValue(2000.0);
-	//params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
+    //           "5" Segment between tipPulley and ring, "6" Segment between ring and Load
+    Sim::CableSegmentDefinition lastSegmentDefinition;
+    lastSegmentDefinition.index = definition.getSpanSegmentIndex(2);
+    lastSegmentDefinition.flexible = true;
+    lastSegmentDefinition.maxSectionLength = 1.0;
+    lastSegmentDefinition.minSectionLength = 0.2;
+    definition.segments.push_back(lastSegmentDefinition);
+
+    Sim::CableSegmentDefinition lastSegmentDefinition2;
+    lastSegmentDefinition2.index = definition.getSpanSegmentIndex(3);
+    lastSegmentDefinition2.flexible = true;
+    lastSegmentDefinition2.maxSectionLength = 3.0;
+    lastSegmentDefinition2.minSectionLength = 0.2;
+	lastSegmentDefinition2.collisionGeometryType = 2;
+    definition.segments.push_back(lastSegmentDefinition2);
+
+    definition.params.axialStiffness = 10000.0;
+    definition.params.axialDamping = 2000.0;
+    _applySettings(definition);
 
+    // Since the crane use the cable system, it makes sense to add it
+    // to the crane mechanism.
+    return mScene.createCable(craneMechanism, definition);
+}
 
+// Override the cable definition with the settings given to the constructor.
+void ExCableSystem::_applySettings(Sim::CableDefinition& definition) const
+{
+    if ( mSettings.axialStiffness > 0.0 )
+    {
+        definition.params.axialStiffness = mSettings.axialStiffness;
+    }
+    if ( mSettings.axialDamping > 0.0 )
+    {
+        definition.params.axialDamping = mSettings.axialDamping;
+    }
+    if ( mSettings.maxTension > 0.0 )
+    {
+        definition.params.enableBreakage = true;
+        definition.params.maxTension = mSettings.maxTension;
+    }
+    if ( mSettings.implicitCables )
+    {
+        definition.params.implicitAxial = true;
+    }
+    if ( mSettings.adaptiveSections )
+    {
+        for (size_t i=0; i<definition.segments.size(); ++i)
+        {
+            definition.segments[i].adaptive = definition.segments[i].flexible;
+        }
+    }
+    if ( mSettings.maxSectionLength > 0.0 )
+    {
+        for (size_t i=0; i<definition.segments.size(); ++i)
+        {
+            Sim::CableSegmentDefinition& segment = definition.segments[i];
+            if ( segment.flexible )
+            {
+                segment.maxSectionLength = mSettings.maxSectionLength;
+                // Keep room between the two lengths for the split and merge hysteresis.
+                segment.minSectionLength = std::min(segment.minSectionLength, 0.2 * mSettings.maxSectionLength);
+            }
+        }
+    }
 }
 
 // Should always return a valid assembly.
-// The caller owns the returned pointer.
-VxAssembly* ExCableSystem::_getLoadAssembly()
+Sim::AssemblyId ExCableSystem::_getLoadAssembly()
 {
-    return GetAssemblyInMechanismFromName(mLoadMechanism.get(), sLoadAssemblyName);
+    return mScene.findAssembly(mLoadMechanism, sLoadAssemblyName);
 }
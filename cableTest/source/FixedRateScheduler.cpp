@@ -0,0 +1,92 @@
+#include "FixedRateScheduler.h"
+
+#include <iostream>
+#include <thread>
+
+FixedRateScheduler::Settings::Settings()
+    : stepRate(60.0)
+    , maxCatchUpSteps(4)
+{
+}
+
+FixedRateScheduler::FixedRateScheduler(const Settings& iSettings)
+    : mSettings(iSettings)
+    , mPeriod(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / iSettings.stepRate)))
+    , mStart()
+    , mFrameStart()
+    , mScheduled(0)
+    , mFrameSteps(0)
+    , mFrameCount(0)
+    , mStepCount(0)
+    , mCatchUpFrameCount(0)
+    , mOverrunCount(0)
+    , mDroppedStepCount(0)
+    , mMaxLag(0.0)
+{
+    if ( mSettings.maxCatchUpSteps < 1 )
+    {
+        mSettings.maxCatchUpSteps = 1;
+    }
+}
+
+void FixedRateScheduler::start()
+{
+    mStart = Clock::now();
+    mScheduled = 0;
+}
+
+size_t FixedRateScheduler::waitForSteps()
+{
+    const Clock::time_point due = mStart + mPeriod * mScheduled;
+    Clock::time_point now = Clock::now();
+    size_t steps = 1;
+    if ( now < due )
+    {
+        std::this_thread::sleep_until(due);
+        now = Clock::now();
+    }
+    else
+    {
+        const double lag = std::chrono::duration<double>(now - due).count();
+        if ( lag > mMaxLag )
+        {
+            mMaxLag = lag;
+        }
+
+        // The step due now, and the ones that became due since.
+        steps += static_cast<size_t>((now - due) / mPeriod);
+        if ( steps > mSettings.maxCatchUpSteps )
+        {
+            const size_t dropped = steps - mSettings.maxCatchUpSteps;
+            mDroppedStepCount += dropped;
+            mStart += mPeriod * dropped;
+            steps = mSettings.maxCatchUpSteps;
+        }
+    }
+
+    if ( steps > 1 )
+    {
+        ++mCatchUpFrameCount;
+    }
+    mScheduled += steps;
+    mFrameStart = now;
+    mFrameSteps = steps;
+    return steps;
+}
+
+void FixedRateScheduler::endFrame()
+{
+    if ( Clock::now() - mFrameStart > mPeriod * mFrameSteps )
+    {
+        ++mOverrunCount;
+    }
+    ++mFrameCount;
+    mStepCount += mFrameSteps;
+}
+
+void FixedRateScheduler::printReport() const
+{
+    std::cout << "Fixed rate of " << mSettings.stepRate << " Hz: " << mStepCount << " steps in " << mFrameCount << " frames, "
+              << mCatchUpFrameCount << " catching up, " << mOverrunCount << " overrun, "
+              << mDroppedStepCount << " steps dropped, max lag = " << mMaxLag * 1e3 << " ms" << std::endl;
+}
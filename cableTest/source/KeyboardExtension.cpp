@@ -13,6 +13,7 @@ KeyboardExtension::KeyboardExtension(VxSim::VxPluginExtension *iProxy)
     : VxSim::IKeyboard(iProxy)
     , VxSim::IExtension(iProxy)
     , mCrane(NULL)
+    , mControlLog(NULL)
     , mInc(0.2)
 {
     addKeyDescription(IKeyboard::kShiftMask + '7', "Hold to extend the telescopic section of the crane (i.e. Boom out)");
@@ -37,15 +38,15 @@ void KeyboardExtension::onKeyPressed(int key)
         switch(key & ~(IKeyboard::kShiftMask | IKeyboard::kAltMask) )
         {
         case '7': // Boom In or Out (extend)
-            mCrane->setElongationSpeed(factor * 0.5);
+            _setSpeed(ControlLog::kControlElongation, factor * 0.5);
             break;
 
         case '8' : // Boom Up or Down
-            mCrane->setElevationSpeed(factor * 0.1);
+            _setSpeed(ControlLog::kControlElevation, factor * 0.1);
             break;
 
         case '9' : // Winch In or Out
-            mCrane->setWinchSpeed(factor * 0.5);
+            _setSpeed(ControlLog::kControlWinch, factor * 0.5);
             break;
 
 		case 'a' :
@@ -62,15 +63,15 @@ void KeyboardExtension::onKeyReleased(int key)
         switch( key  & ~(IKeyboard::kShiftMask | IKeyboard::kAltMask) )
         {
         case '7' : // Boom In or Out (extend)
-            mCrane->setElongationSpeed(0.0);
+            _setSpeed(ControlLog::kControlElongation, 0.0);
             break;
 
         case '8': // Boom Up or Down
-            mCrane->setElevationSpeed(0.0);
+            _setSpeed(ControlLog::kControlElevation, 0.0);
             break;
 
         case '9': // Winch In or Out
-            mCrane->setWinchSpeed(0.0);
+            _setSpeed(ControlLog::kControlWinch, 0.0);
             break;
         }
     }
@@ -80,3 +81,31 @@ void KeyboardExtension::setCrane(MyCrane * iCrane)
 {
     mCrane = iCrane;
 }
+
+void KeyboardExtension::setControlLog(ControlLog * iLog)
+{
+    mControlLog = iLog;
+}
+
+void KeyboardExtension::_setSpeed(ControlLog::Control iControl, Vx::VxReal iSpeed)
+{
+    switch ( iControl )
+    {
+    case ControlLog::kControlElongation:
+        mCrane->setElongationSpeed(iSpeed);
+        break;
+
+    case ControlLog::kControlElevation:
+        mCrane->setElevationSpeed(iSpeed);
+        break;
+
+    case ControlLog::kControlWinch:
+        mCrane->setWinchSpeed(iSpeed);
+        break;
+    }
+
+    if ( mControlLog )
+    {
+        mControlLog->add(iControl, iSpeed);
+    }
+}
@@ -0,0 +1,73 @@
+#include "NameRegistry.h"
+
+namespace Sim
+{
+    NameRegistry::NameRegistry(SceneArena* iArena)
+        : mArena(iArena)
+        , mScopes()
+        , mCount(0)
+    {
+    }
+
+    bool NameRegistry::add(int iScope, const std::string& iName, int iId)
+    {
+        if ( iScope < 0 )
+        {
+            return false;
+        }
+
+        if ( static_cast<size_t>(iScope) >= mScopes.size() )
+        {
+            mScopes.resize(iScope + 1, Table(0, Table::hasher(), Table::key_equal(), TableAllocator(mArena)));
+        }
+        if ( !mScopes[iScope].insert(Table::value_type(iName, iId)).second )
+        {
+            return false;
+        }
+
+        ++mCount;
+        return true;
+    }
+
+    bool NameRegistry::remove(int iScope, const std::string& iName)
+    {
+        if ( iScope < 0 || static_cast<size_t>(iScope) >= mScopes.size() || 0 == mScopes[iScope].erase(iName) )
+        {
+            return false;
+        }
+
+        --mCount;
+        return true;
+    }
+
+    int NameRegistry::find(int iScope, const std::string& iName) const
+    {
+        if ( iScope < 0 || static_cast<size_t>(iScope) >= mScopes.size() )
+        {
+            return kInvalidId;
+        }
+
+        const Table& table = mScopes[iScope];
+        const Table::const_iterator found = table.find(iName);
+        return found != table.end() ? found->second : kInvalidId;
+    }
+
+    size_t NameRegistry::getMemoryUsage() const
+    {
+        // An entry is a node holding the pair and the link to the next one,
+        // plus the cached hash.
+        const size_t entryBytes = sizeof(Table::value_type) + sizeof(void*) + sizeof(size_t);
+        size_t bytes = mScopes.capacity() * sizeof(Table);
+        for (size_t i=0; i<mScopes.size(); ++i)
+        {
+            bytes += mScopes[i].bucket_count() * sizeof(void*) + mScopes[i].size() * entryBytes;
+        }
+        return bytes;
+    }
+
+    void NameRegistry::clear()
+    {
+        mScopes.clear();
+        mCount = 0;
+    }
+}
@@ -0,0 +1,1840 @@
+#include "NativeScene.h"
+#include "ThreadPool.h"
+#include "TrajectoryFormat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+static const double sPi = 3.14159265358979323846;
+
+// Friction coefficient used for all the contacts.
+static const double sFriction = 1.0;
+
+// Index of no island: for the roots not numbered yet, and the static and
+// animated parts.
+static const size_t sNoIsland = ~static_cast<size_t>(0);
+
+// Checkpoint file: magic, version (u32), then the state; see saveCheckpoint().
+static const char sCheckpointMagic[4] = { 'C', 'T', 'C', 'K' };
+static const unsigned int sCheckpointVersion = 2;
+
+// Wrap an angle in [-pi, pi].
+static double WrapAngle(double angle)
+{
+    while ( angle > sPi )
+    {
+        angle -= 2.0 * sPi;
+    }
+    while ( angle < -sPi )
+    {
+        angle += 2.0 * sPi;
+    }
+    return angle;
+}
+
+// Maximum iterations of the implicit cable solve in each substep. The
+// first one is enough for a chain at rest; the next ones correct the
+// linearization of a chain that swings with a heavy load, until it
+// converges (see CableChain::solve()).
+static const int sImplicitCableIterations = 4;
+
+// Bytes allocated by an array.
+template <class Array>
+static size_t GetMemoryUsage(const Array& iArray)
+{
+    return iArray.capacity() * sizeof(typename Array::value_type);
+}
+
+// Heap bytes of a string, none when it fits in the string itself.
+static size_t GetMemoryUsage(const std::string& iString)
+{
+    return iString.capacity() > sizeof(std::string) ? iString.capacity() + 1 : 0;
+}
+
+// Adds the time spent in a scope to a phase of ioPhaseTimes; free when
+// ioPhaseTimes is NULL. The islands are timed on their worker with it, the
+// profiler only being fed from the calling thread.
+class ScopedPhaseTime
+{
+public:
+    ScopedPhaseTime(double* ioPhaseTimes, StepProfiler::Phase iPhase)
+        : mPhaseTimes(ioPhaseTimes)
+        , mPhase(iPhase)
+    {
+        if ( mPhaseTimes )
+        {
+            mStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedPhaseTime()
+    {
+        if ( mPhaseTimes )
+        {
+            mPhaseTimes[mPhase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+        }
+    }
+
+private:
+    double* mPhaseTimes;
+    StepProfiler::Phase mPhase;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// Parameters s and t of the closest points p0 + (p1 - p0) s and
+// q0 + (q1 - q0) t of two segments, both in [0, 1].
+static void ClosestSegmentParameters(const Sim::Vec3& p0, const Sim::Vec3& p1, const Sim::Vec3& q0, const Sim::Vec3& q1, double& s, double& t)
+{
+    const Sim::Vec3 d1 = p1 - p0;
+    const Sim::Vec3 d2 = q1 - q0;
+    const Sim::Vec3 r = p0 - q0;
+    const double a = Sim::dot(d1, d1);
+    const double e = Sim::dot(d2, d2);
+    const double f = Sim::dot(d2, r);
+    const double c = Sim::dot(d1, r);
+    const double b = Sim::dot(d1, d2);
+    const double denominator = a * e - b * b;
+
+    // Closest point of the first line to the second one, unless they are parallel.
+    s = denominator > 1e-12 * a * e ? std::min(std::max((b * f - c * e) / denominator, 0.0), 1.0) : 0.0;
+    t = e > 0.0 ? (b * s + f) / e : 0.0;
+    if ( t < 0.0 || t > 1.0 )
+    {
+        t = std::min(std::max(t, 0.0), 1.0);
+        s = a > 0.0 ? std::min(std::max((b * t - c) / a, 0.0), 1.0) : 0.0;
+    }
+}
+
+namespace Sim
+{
+    NativeScene::NativeScene()
+        : mTime(0.0)
+        , mStepCount(0)
+        , mSubstepCount(20)
+        , mGravity(0.0, 0.0, -9.81)
+        , mProfiler(NULL)
+        , mSubstepCallback(NULL)
+        , mArena()
+        , mAssemblyNameRegistry(&mArena)
+        , mPartNameRegistry(&mArena)
+        , mCableNameRegistry(&mArena)
+        , mThreadPool(NULL)
+        , mIslandsDirty(true)
+        , mIslandBuildCount(0)
+        , mWorkspaces(1)
+    {
+    }
+
+    NativeScene::~NativeScene()
+    {
+    }
+
+    NativeScene::Workspace::Workspace()
+    {
+        std::fill(phaseTimes, phaseTimes + StepProfiler::kPhaseCount, 0.0);
+    }
+
+    void NativeScene::setThreadPool(ThreadPool* iPool)
+    {
+        mThreadPool = iPool;
+        mWorkspaces.resize(NULL != iPool ? iPool->getThreadCount() : 1);
+    }
+
+    MechanismId NativeScene::createMechanism(const std::string& iName)
+    {
+        mMechanisms.push_back(iName);
+        return static_cast<MechanismId>(mMechanisms.size() - 1);
+    }
+
+    AssemblyId NativeScene::createAssembly(MechanismId iMechanism, const std::string& iName)
+    {
+        mAssemblyNames.push_back(iName);
+        mAssemblyMechanisms.push_back(iMechanism);
+        mAssemblySelfCollision.push_back(true);
+
+        const AssemblyId assembly = static_cast<AssemblyId>(mAssemblyNames.size() - 1);
+        mAssemblyNameRegistry.add(iMechanism, iName, assembly);
+        return assembly;
+    }
+
+    PartId NativeScene::createPart(AssemblyId iAssembly, const PartDefinition& iDefinition)
+    {
+        Body body(&mArena);
+        body.name = iDefinition.name;
+        body.assembly = iAssembly;
+        body.control = iDefinition.control;
+        body.explicitMass = iDefinition.mass > 0.0;
+        body.mass = body.explicitMass ? iDefinition.mass : 1.0;
+        body.invMass = 0.0;
+        body.position = iDefinition.position;
+        body.previousPosition = iDefinition.position;
+        mBodies.push_back(body);
+
+        const PartId part = static_cast<PartId>(mBodies.size() - 1);
+        mPartNameRegistry.add(iAssembly, iDefinition.name, part);
+        mIslandsDirty = true;
+        _updateMassProperties(part);
+        return part;
+    }
+
+    void NativeScene::addBox(PartId iPart, const Vec3& iDimensions, const Pose& iRelative)
+    {
+        Geometry geometry;
+        geometry.type = kGeometryBox;
+        geometry.halfExtents = iDimensions * 0.5;
+        geometry.radius = 0.0;
+        geometry.height = 0.0;
+        geometry.position = iRelative.position;
+        geometry.orientation = Quat::fromEuler(iRelative.euler);
+        mBodies[iPart].geometries.push_back(geometry);
+
+        const Vec3& h = geometry.halfExtents;
+        for (int i=0; i<8; ++i)
+        {
+            const Vec3 corner((i & 1) ? h.x : -h.x, (i & 2) ? h.y : -h.y, (i & 4) ? h.z : -h.z);
+            _addSample(iPart, geometry.position + geometry.orientation.rotate(corner));
+        }
+
+        _updateMassProperties(iPart);
+    }
+
+    void NativeScene::addCylinder(PartId iPart, double iRadius, double iHeight, const Pose& iRelative)
+    {
+        // The long axis of the cylinder is along its local z axis.
+        Geometry geometry;
+        geometry.type = kGeometryCylinder;
+        geometry.halfExtents = Vec3(iRadius, iRadius, 0.5 * iHeight);
+        geometry.radius = iRadius;
+        geometry.height = iHeight;
+        geometry.position = iRelative.position;
+        geometry.orientation = Quat::fromEuler(iRelative.euler);
+        mBodies[iPart].geometries.push_back(geometry);
+
+        for (int i=0; i<8; ++i)
+        {
+            const double angle = i * sPi / 4.0;
+            const Vec3 rim(iRadius * std::cos(angle), iRadius * std::sin(angle), 0.0);
+            _addSample(iPart, geometry.position + geometry.orientation.rotate(rim + Vec3(0.0, 0.0, 0.5 * iHeight)));
+            _addSample(iPart, geometry.position + geometry.orientation.rotate(rim - Vec3(0.0, 0.0, 0.5 * iHeight)));
+        }
+
+        _updateMassProperties(iPart);
+    }
+
+    void NativeScene::addPlane(PartId iPart)
+    {
+        // The plane normal is the local z axis, like Vx::VxPlane.
+        Geometry geometry;
+        geometry.type = kGeometryPlane;
+        geometry.radius = 0.0;
+        geometry.height = 0.0;
+        mBodies[iPart].geometries.push_back(geometry);
+    }
+
+    void NativeScene::setSelfCollision(AssemblyId iAssembly, bool iEnabled)
+    {
+        mAssemblySelfCollision[iAssembly] = iEnabled;
+    }
+
+    ConstraintId NativeScene::createHinge(AssemblyId /*iAssembly*/, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis)
+    {
+        const Body& body1 = mBodies[iPart1];
+        const Body& body2 = mBodies[iPart2];
+        const Vec3 axis = iAxis / length(iAxis);
+
+        Joint joint;
+        joint.type = kJointHinge;
+        joint.part1 = iPart1;
+        joint.part2 = iPart2;
+        joint.localAnchor1 = body1.orientation.inverseRotate(iPosition - body1.position);
+        joint.localAnchor2 = body2.orientation.inverseRotate(iPosition - body2.position);
+        joint.localAxis1 = body1.orientation.inverseRotate(axis);
+        joint.localAxis2 = body2.orientation.inverseRotate(axis);
+        joint.restRelative = body2.orientation.conjugate() * body1.orientation;
+        joint.control = kConstraintFree;
+        joint.desiredVelocity = 0.0;
+        joint.motorTarget = 0.0;
+        joint.limitsActive = false;
+        joint.lower = 0.0;
+        joint.upper = 0.0;
+        joint.coordinate = 0.0;
+        mJoints.push_back(joint);
+        mIslandsDirty = true;
+
+        return static_cast<ConstraintId>(mJoints.size() - 1);
+    }
+
+    ConstraintId NativeScene::createPrismatic(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis)
+    {
+        // Same frames as the hinge, only the solve differs.
+        const ConstraintId constraint = createHinge(iAssembly, iPart1, iPart2, iPosition, iAxis);
+        mJoints[constraint].type = kJointPrismatic;
+        return constraint;
+    }
+
+    void NativeScene::setConstraintControl(ConstraintId iConstraint, ConstraintControl iControl)
+    {
+        Joint& joint = mJoints[iConstraint];
+        joint.control = iControl;
+        joint.desiredVelocity = 0.0;
+        // The motor holds the current position until a velocity is given.
+        joint.motorTarget = joint.coordinate;
+    }
+
+    void NativeScene::setMotorDesiredVelocity(ConstraintId iConstraint, double iVelocity)
+    {
+        mJoints[iConstraint].desiredVelocity = iVelocity;
+    }
+
+    void NativeScene::setLimits(ConstraintId iConstraint, double iLower, double iUpper)
+    {
+        Joint& joint = mJoints[iConstraint];
+        joint.limitsActive = true;
+        joint.lower = iLower;
+        joint.upper = iUpper;
+    }
+
+    CableId NativeScene::createCable(MechanismId iMechanism, const CableDefinition& iDefinition)
+    {
+        std::vector<Vec3> pointPositions;
+        pointPositions.reserve(iDefinition.points.size());
+        for (size_t i=0; i<iDefinition.points.size(); ++i)
+        {
+            pointPositions.push_back(_getCablePointPosition(iDefinition.points[i]));
+        }
+
+        mCables.push_back(Cable());
+        Cable& cable = mCables.back();
+        cable.chain.build(iDefinition, pointPositions);
+        cable.mechanism = iMechanism;
+        cable.winchJoint = kInvalidId;
+        cable.winchRadius = 0.0;
+        cable.winchAngle = 0.0;
+
+        // The winch spools the cable when its hinge rotates.
+        if ( !iDefinition.points.empty() && kCableWinch == iDefinition.points[0].type )
+        {
+            const PartId winch = iDefinition.points[0].part;
+            for (size_t i=0; i<mJoints.size(); ++i)
+            {
+                if ( kJointHinge == mJoints[i].type && (mJoints[i].part1 == winch || mJoints[i].part2 == winch) )
+                {
+                    cable.winchJoint = static_cast<ConstraintId>(i);
+                    cable.winchAngle = mJoints[i].coordinate;
+                    break;
+                }
+            }
+
+            // The drum is the smallest cylinder of the winch.
+            const GeometryArray& geometries = mBodies[winch].geometries;
+            for (size_t i=0; i<geometries.size(); ++i)
+            {
+                if ( kGeometryCylinder == geometries[i].type && (cable.winchRadius == 0.0 || geometries[i].radius < cable.winchRadius) )
+                {
+                    cable.winchRadius = geometries[i].radius;
+                }
+            }
+        }
+
+        const CableId id = static_cast<CableId>(mCables.size() - 1);
+        mCableNameRegistry.add(iMechanism, iDefinition.name, id);
+        mIslandsDirty = true;
+        return id;
+    }
+
+    AssemblyId NativeScene::findAssembly(MechanismId iMechanism, const std::string& iName) const
+    {
+        return mAssemblyNameRegistry.find(iMechanism, iName);
+    }
+
+    PartId NativeScene::findPart(AssemblyId iAssembly, const std::string& iName) const
+    {
+        return mPartNameRegistry.find(iAssembly, iName);
+    }
+
+    CableId NativeScene::findCable(MechanismId iMechanism, const std::string& iName) const
+    {
+        return mCableNameRegistry.find(iMechanism, iName);
+    }
+
+    Vec3 NativeScene::getPartPosition(PartId iPart) const
+    {
+        return mBodies[iPart].position;
+    }
+
+    NativeScene::MemoryReport::MemoryReport()
+        : mechanisms()
+        , nameBytes(0)
+        , solverBytes(0)
+        , arenaReservedBytes(0)
+        , arenaAllocatedBytes(0)
+        , arenaReleasedBytes(0)
+        , arenaBlockCount(0)
+    {
+    }
+
+    size_t NativeScene::MemoryReport::getTotalBytes() const
+    {
+        size_t bytes = nameBytes + solverBytes;
+        for (size_t i=0; i<mechanisms.size(); ++i)
+        {
+            const MechanismMemory& mechanism = mechanisms[i];
+            bytes += mechanism.parts.bytes + mechanism.geometries.bytes + mechanism.constraints.bytes + mechanism.cables.bytes;
+        }
+        return bytes;
+    }
+
+    void NativeScene::getMemoryReport(MemoryReport& oReport) const
+    {
+        oReport = MemoryReport();
+        oReport.mechanisms.resize(mMechanisms.size());
+        for (size_t i=0; i<mMechanisms.size(); ++i)
+        {
+            oReport.mechanisms[i].name = mMechanisms[i];
+        }
+
+        // The slack of the arrays of the scene is not counted.
+        for (size_t i=0; i<mBodies.size(); ++i)
+        {
+            const Body& body = mBodies[i];
+            MechanismMemory& mechanism = oReport.mechanisms[mAssemblyMechanisms[body.assembly]];
+            mechanism.parts.add(sizeof(Body) + GetMemoryUsage(body.name));
+            mechanism.geometries.count += body.geometries.size();
+            mechanism.geometries.bytes += GetMemoryUsage(body.geometries) + GetMemoryUsage(body.samples);
+        }
+        for (size_t i=0; i<mJoints.size(); ++i)
+        {
+            oReport.mechanisms[mAssemblyMechanisms[mBodies[mJoints[i].part1].assembly]].constraints.add(sizeof(Joint));
+        }
+        for (size_t i=0; i<mCables.size(); ++i)
+        {
+            const Cable& cable = mCables[i];
+            const CableDefinition& definition = cable.chain.getDefinition();
+            const size_t bytes = sizeof(Cable) + cable.chain.getMemoryUsage() + cable.broadphase.getMemoryUsage()
+                + GetMemoryUsage(definition.name) + GetMemoryUsage(definition.points) + GetMemoryUsage(definition.segments);
+            oReport.mechanisms[cable.mechanism].cables.add(bytes);
+        }
+
+        oReport.nameBytes = GetMemoryUsage(mMechanisms) + GetMemoryUsage(mAssemblyNames)
+            + GetMemoryUsage(mAssemblyMechanisms) + mAssemblySelfCollision.capacity() / 8
+            + mAssemblyNameRegistry.getMemoryUsage() + mPartNameRegistry.getMemoryUsage() + mCableNameRegistry.getMemoryUsage();
+        for (size_t i=0; i<mMechanisms.size(); ++i)
+        {
+            oReport.nameBytes += GetMemoryUsage(mMechanisms[i]);
+        }
+        for (size_t i=0; i<mAssemblyNames.size(); ++i)
+        {
+            oReport.nameBytes += GetMemoryUsage(mAssemblyNames[i]);
+        }
+
+        oReport.solverBytes = GetMemoryUsage(mIslands) + GetMemoryUsage(mKinematicParts) + GetMemoryUsage(mKinematicBounds)
+            + GetMemoryUsage(mIslandCablePairs) + GetMemoryUsage(mTouchingCables) + GetMemoryUsage(mSweptCables)
+            + GetMemoryUsage(mIslandParts) + GetMemoryUsage(mIslandJoints) + GetMemoryUsage(mIslandCables)
+            + GetMemoryUsage(mIslandParents) + GetMemoryUsage(mIslandOfRoot) + GetMemoryUsage(mIslandOfElement)
+            + GetMemoryUsage(mWorkspaces);
+        for (size_t i=0; i<mIslands.size(); ++i)
+        {
+            oReport.solverBytes += GetMemoryUsage(mIslands[i].sectionPairs);
+        }
+        for (size_t i=0; i<mWorkspaces.size(); ++i)
+        {
+            const Workspace& workspace = mWorkspaces[i];
+            oReport.solverBytes += GetMemoryUsage(workspace.pinnedInvMass) + GetMemoryUsage(workspace.partShare)
+                + GetMemoryUsage(workspace.candidateSections) + GetMemoryUsage(workspace.candidatePairs);
+        }
+
+        oReport.arenaReservedBytes = mArena.getReservedBytes();
+        oReport.arenaAllocatedBytes = mArena.getAllocatedBytes();
+        oReport.arenaReleasedBytes = mArena.getReleasedBytes();
+        oReport.arenaBlockCount = mArena.getBlockCount();
+    }
+
+    // The checkpoint holds, after the magic and the version: the time (f64),
+    // the step count (u64), then for each part its name and the position,
+    // orientation, velocities and previous transform (f64s), for each
+    // constraint the control, motor and limit state, and for each cable its
+    // name, the winch angle and the state of the chain. The names and counts
+    // are checked when loading. All the values go through TrajectoryFormat.
+    bool NativeScene::saveCheckpoint(const std::string& iFileName) const
+    {
+        using namespace TrajectoryFormat;
+
+        std::vector<unsigned char> buffer(sCheckpointMagic, sCheckpointMagic + 4);
+        PutU32(buffer, sCheckpointVersion);
+        PutF64(buffer, mTime);
+        PutU64(buffer, mStepCount);
+
+        PutU32(buffer, static_cast<unsigned int>(mBodies.size()));
+        for (size_t i=0; i<mBodies.size(); ++i)
+        {
+            const Body& body = mBodies[i];
+            const double values[] =
+            {
+                body.position.x, body.position.y, body.position.z,
+                body.orientation.w, body.orientation.x, body.orientation.y, body.orientation.z,
+                body.linearVelocity.x, body.linearVelocity.y, body.linearVelocity.z,
+                body.angularVelocity.x, body.angularVelocity.y, body.angularVelocity.z,
+                body.previousPosition.x, body.previousPosition.y, body.previousPosition.z,
+                body.previousOrientation.w, body.previousOrientation.x, body.previousOrientation.y, body.previousOrientation.z
+            };
+            PutString(buffer, body.name);
+            for (size_t v=0; v<sizeof(values) / sizeof(values[0]); ++v)
+            {
+                PutF64(buffer, values[v]);
+            }
+        }
+
+        PutU32(buffer, static_cast<unsigned int>(mJoints.size()));
+        for (size_t i=0; i<mJoints.size(); ++i)
+        {
+            const Joint& joint = mJoints[i];
+            PutU32(buffer, joint.type);
+            PutU32(buffer, joint.control);
+            PutF64(buffer, joint.desiredVelocity);
+            PutF64(buffer, joint.motorTarget);
+            PutU32(buffer, joint.limitsActive ? 1 : 0);
+            PutF64(buffer, joint.lower);
+            PutF64(buffer, joint.upper);
+            PutF64(buffer, joint.coordinate);
+        }
+
+        PutU32(buffer, static_cast<unsigned int>(mCables.size()));
+        for (size_t i=0; i<mCables.size(); ++i)
+        {
+            PutString(buffer, mCables[i].chain.getDefinition().name);
+            PutF64(buffer, mCables[i].winchAngle);
+            mCables[i].chain.saveState(buffer);
+        }
+
+        std::ofstream stream(iFileName.c_str(), std::ios::binary);
+        if ( !stream || !stream.write(reinterpret_cast<const char*>(&buffer[0]), buffer.size()) )
+        {
+            std::cout << "Cannot write the checkpoint to " << iFileName << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool NativeScene::loadCheckpoint(const std::string& iFileName)
+    {
+        using namespace TrajectoryFormat;
+
+        std::ifstream stream(iFileName.c_str(), std::ios::binary);
+        if ( !stream )
+        {
+            std::cout << "Cannot read the checkpoint " << iFileName << std::endl;
+            return false;
+        }
+        const std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        const unsigned char* data = buffer.empty() ? NULL : &buffer[0];
+        const unsigned char* end = data + buffer.size();
+
+        unsigned int version = 0;
+        const bool hasMagic = buffer.size() >= 4 && 0 == memcmp(data, sCheckpointMagic, 4);
+        if ( hasMagic )
+        {
+            data += 4;
+        }
+        if ( !hasMagic || !GetU32(data, end, version) || version != sCheckpointVersion )
+        {
+            std::cout << iFileName << " is not a checkpoint of this version" << std::endl;
+            return false;
+        }
+
+        // The state is read in copies, swapped in once the whole file is valid.
+        double time = 0.0;
+        unsigned long long stepCount = 0;
+        unsigned int count = 0;
+        std::vector<Body> bodies(mBodies);
+        std::vector<Joint> joints(mJoints);
+        std::vector<Cable> cables(mCables);
+        const char* mismatch = NULL;
+
+        bool valid = GetF64(data, end, time) && GetU64(data, end, stepCount) && GetU32(data, end, count);
+        if ( valid && count != bodies.size() )
+        {
+            mismatch = "part count";
+        }
+        for (size_t i=0; valid && NULL == mismatch && i<bodies.size(); ++i)
+        {
+            Body& body = bodies[i];
+            std::string name;
+            double* const values[] =
+            {
+                &body.position.x, &body.position.y, &body.position.z,
+                &body.orientation.w, &body.orientation.x, &body.orientation.y, &body.orientation.z,
+                &body.linearVelocity.x, &body.linearVelocity.y, &body.linearVelocity.z,
+                &body.angularVelocity.x, &body.angularVelocity.y, &body.angularVelocity.z,
+                &body.previousPosition.x, &body.previousPosition.y, &body.previousPosition.z,
+                &body.previousOrientation.w, &body.previousOrientation.x, &body.previousOrientation.y, &body.previousOrientation.z
+            };
+            valid = GetString(data, end, name);
+            if ( valid && name != body.name )
+            {
+                mismatch = "part names";
+            }
+            for (size_t v=0; valid && v<sizeof(values) / sizeof(values[0]); ++v)
+            {
+                valid = GetF64(data, end, *values[v]);
+            }
+        }
+
+        valid = valid && (NULL != mismatch || GetU32(data, end, count));
+        if ( valid && NULL == mismatch && count != joints.size() )
+        {
+            mismatch = "constraint count";
+        }
+        for (size_t i=0; valid && NULL == mismatch && i<joints.size(); ++i)
+        {
+            Joint& joint = joints[i];
+            unsigned int type = 0, control = 0, limitsActive = 0;
+            valid = GetU32(data, end, type) && GetU32(data, end, control)
+                && GetF64(data, end, joint.desiredVelocity) && GetF64(data, end, joint.motorTarget)
+                && GetU32(data, end, limitsActive) && GetF64(data, end, joint.lower) && GetF64(data, end, joint.upper)
+                && GetF64(data, end, joint.coordinate);
+            if ( valid && type != static_cast<unsigned int>(joint.type) )
+            {
+                mismatch = "constraint types";
+            }
+            joint.control = kConstraintMotorized == control ? kConstraintMotorized : kConstraintFree;
+            joint.limitsActive = 0 != limitsActive;
+        }
+
+        valid = valid && (NULL != mismatch || GetU32(data, end, count));
+        if ( valid && NULL == mismatch && count != cables.size() )
+        {
+            mismatch = "cable count";
+        }
+        for (size_t i=0; valid && NULL == mismatch && i<cables.size(); ++i)
+        {
+            std::string name;
+            valid = GetString(data, end, name) && GetF64(data, end, cables[i].winchAngle);
+            if ( valid && name != cables[i].chain.getDefinition().name )
+            {
+                mismatch = "cable names";
+            }
+            valid = valid && (NULL != mismatch || cables[i].chain.loadState(data, end));
+        }
+
+        if ( NULL != mismatch )
+        {
+            std::cout << "The checkpoint " << iFileName << " was saved from another scene: the " << mismatch << " differ" << std::endl;
+            return false;
+        }
+        if ( !valid || data != end )
+        {
+            std::cout << "The checkpoint " << iFileName << " is corrupted" << std::endl;
+            return false;
+        }
+
+        mTime = time;
+        mStepCount = static_cast<size_t>(stepCount);
+        mBodies.swap(bodies);
+        mJoints.swap(joints);
+        mCables.swap(cables);
+        // The pairs of sections of the islands were found on the old chains.
+        mIslandsDirty = true;
+        return true;
+    }
+
+    // Compute the mass and inertia of the part from its geometries.
+    void NativeScene::_updateMassProperties(PartId iPart)
+    {
+        Body& body = mBodies[iPart];
+
+        double volume = 0.0;
+        for (size_t i=0; i<body.geometries.size(); ++i)
+        {
+            const Geometry& geometry = body.geometries[i];
+            if ( kGeometryBox == geometry.type )
+            {
+                volume += 8.0 * geometry.halfExtents.x * geometry.halfExtents.y * geometry.halfExtents.z;
+            }
+            else if ( kGeometryCylinder == geometry.type )
+            {
+                volume += sPi * geometry.radius * geometry.radius * geometry.height;
+            }
+        }
+
+        if ( !body.explicitMass )
+        {
+            body.mass = volume > 0.0 ? volume : 1.0;
+        }
+        const double density = volume > 0.0 ? body.mass / volume : 0.0;
+
+        Mat3 inertia;
+        for (size_t i=0; i<body.geometries.size(); ++i)
+        {
+            const Geometry& geometry = body.geometries[i];
+            Vec3 diagonal;
+            double mass = 0.0;
+            if ( kGeometryBox == geometry.type )
+            {
+                const Vec3 d = geometry.halfExtents * 2.0;
+                mass = density * d.x * d.y * d.z;
+                diagonal = Vec3(d.y * d.y + d.z * d.z, d.x * d.x + d.z * d.z, d.x * d.x + d.y * d.y) * (mass / 12.0);
+            }
+            else if ( kGeometryCylinder == geometry.type )
+            {
+                const double r2 = geometry.radius * geometry.radius;
+                mass = density * sPi * r2 * geometry.height;
+                const double perpendicular = mass * (3.0 * r2 + geometry.height * geometry.height) / 12.0;
+                diagonal = Vec3(perpendicular, perpendicular, 0.5 * mass * r2);
+            }
+            else
+            {
+                continue;
+            }
+
+            // Rotate the inertia in the part frame and move it to the part origin.
+            const Mat3 rotation = Mat3::fromQuat(geometry.orientation);
+            Mat3 shifted = rotation * Mat3::diagonal(diagonal) * rotation.transpose();
+            const Vec3& p = geometry.position;
+            const double p2 = dot(p, p);
+            for (int r=0; r<3; ++r)
+            {
+                for (int c=0; c<3; ++c)
+                {
+                    shifted.a[r][c] += mass * ((r == c ? p2 : 0.0) - p[r] * p[c]);
+                }
+            }
+            inertia = inertia + shifted;
+        }
+
+        if ( 0.0 == volume )
+        {
+            // No geometry: a small sphere of the given mass.
+            inertia = Mat3::identity() * (0.1 * body.mass);
+        }
+
+        if ( kPartDynamic == body.control )
+        {
+            body.invMass = 1.0 / body.mass;
+            body.invInertia = inertia.inverse();
+        }
+        else
+        {
+            body.invMass = 0.0;
+            body.invInertia.setZero();
+        }
+    }
+
+    void NativeScene::_addSample(PartId iPart, const Vec3& iLocal)
+    {
+        mBodies[iPart].samples.push_back(iLocal);
+    }
+
+    bool NativeScene::_canCollide(const Body& iBody1, const Body& iBody2) const
+    {
+        if ( &iBody1 == &iBody2 )
+        {
+            return false;
+        }
+
+        return iBody1.assembly != iBody2.assembly || mAssemblySelfCollision[iBody1.assembly];
+    }
+
+    Vec3 NativeScene::_getCablePointPosition(const CablePointDefinition& iPoint) const
+    {
+        const Body& body = mBodies[iPoint.part];
+        if ( kCableRing != iPoint.type )
+        {
+            return body.position + body.orientation.rotate(iPoint.offset);
+        }
+
+        return body.position;
+    }
+
+    void NativeScene::step(double iTimeStep)
+    {
+        const double h = iTimeStep / mSubstepCount;
+        for (int i=0; i<mSubstepCount; ++i)
+        {
+            if ( mSubstepCallback )
+            {
+                StepProfiler::ScopedPhase phase(mProfiler, StepProfiler::kPhasePreUpdate);
+                mSubstepCallback->preSubstep(mTime + i * h, h);
+            }
+            _substep(h);
+        }
+
+        mTime += iTimeStep;
+        ++mStepCount;
+    }
+
+    void NativeScene::_substep(double h)
+    {
+        {
+            StepProfiler::ScopedPhase phase(mProfiler, StepProfiler::kPhaseCollision);
+            _updateIslands();
+        }
+
+        {
+            StepProfiler::ScopedPhase phase(mProfiler, StepProfiler::kPhaseConstraintSolve);
+            _moveKinematicParts(h);
+        }
+
+        std::chrono::steady_clock::time_point start;
+        if ( mProfiler )
+        {
+            start = std::chrono::steady_clock::now();
+            for (size_t i=0; i<mWorkspaces.size(); ++i)
+            {
+                std::fill(mWorkspaces[i].phaseTimes, mWorkspaces[i].phaseTimes + StepProfiler::kPhaseCount, 0.0);
+            }
+        }
+
+        if ( NULL != mThreadPool && mThreadPool->getThreadCount() > 1 && mIslands.size() > 1 )
+        {
+            // Each task only writes the parts, constraints and cables of its island.
+            mThreadPool->run(mIslands.size(), [this, h](size_t iTask, size_t iWorker)
+            {
+                _solveIsland(mIslands[iTask], mWorkspaces[iWorker], h);
+            });
+        }
+        else
+        {
+            for (size_t i=0; i<mIslands.size(); ++i)
+            {
+                _solveIsland(mIslands[i], mWorkspaces[0], h);
+            }
+        }
+
+        // The islands overlap in time on the workers: the wall time of the
+        // solve is shared between the phases as the workers spent it.
+        if ( mProfiler )
+        {
+            double phaseTimes[StepProfiler::kPhaseCount] = {};
+            double total = 0.0;
+            for (size_t i=0; i<mWorkspaces.size(); ++i)
+            {
+                for (int phase=0; phase<StepProfiler::kPhaseCount; ++phase)
+                {
+                    phaseTimes[phase] += mWorkspaces[i].phaseTimes[phase];
+                    total += mWorkspaces[i].phaseTimes[phase];
+                }
+            }
+
+            const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (int phase=0; phase<StepProfiler::kPhaseCount; ++phase)
+            {
+                if ( phaseTimes[phase] > 0.0 )
+                {
+                    mProfiler->addPhaseTime(static_cast<StepProfiler::Phase>(phase), wallTime * phaseTimes[phase] / total);
+                }
+            }
+        }
+    }
+
+    // The islands are the connected components of a graph over the dynamic
+    // parts and the cables: a constraint joins its parts, a cable joins the
+    // parts it is attached to and the constraint of its winch, and two
+    // cables that may touch are joined. The static and animated parts join
+    // nothing, the solve of an island only reads them.
+    //
+    // Two cables may touch when the bounds of their broadphases overlap.
+    // The boxes of the broadphases are fat and seldom refit, so the pairs,
+    // found by sweeping the bounds along x, seldom change and the islands
+    // are only built again when they do. A cable moving into the bounds of
+    // another during a substep touches it from the next one on.
+    void NativeScene::_updateIslands()
+    {
+        mSweptCables.clear();
+        for (size_t c=0; c<mCables.size(); ++c)
+        {
+            if ( mCables[c].chain.hasCollision() && !mCables[c].broadphase.getBounds().isEmpty() )
+            {
+                mSweptCables.push_back(static_cast<CableId>(c));
+            }
+        }
+        std::sort(mSweptCables.begin(), mSweptCables.end(), [this](CableId iCable1, CableId iCable2)
+        {
+            return mCables[iCable1].broadphase.getBounds().min.x < mCables[iCable2].broadphase.getBounds().min.x;
+        });
+
+        mTouchingCables.clear();
+        for (size_t i=0; i<mSweptCables.size(); ++i)
+        {
+            const Aabb& bounds = mCables[mSweptCables[i]].broadphase.getBounds();
+            for (size_t j=i+1; j<mSweptCables.size(); ++j)
+            {
+                const Aabb& other = mCables[mSweptCables[j]].broadphase.getBounds();
+                if ( other.min.x > bounds.max.x )
+                {
+                    break;
+                }
+                if ( bounds.overlaps(other) )
+                {
+                    mTouchingCables.push_back(std::make_pair(std::min(mSweptCables[i], mSweptCables[j]), std::max(mSweptCables[i], mSweptCables[j])));
+                }
+            }
+        }
+        std::sort(mTouchingCables.begin(), mTouchingCables.end());
+
+        if ( mIslandsDirty || mTouchingCables != mIslandCablePairs )
+        {
+            mIslandCablePairs.swap(mTouchingCables);
+            _buildIslands();
+            mIslandsDirty = false;
+            ++mIslandBuildCount;
+        }
+    }
+
+    void NativeScene::_buildIslands()
+    {
+        // Union-find over the parts, then the cables.
+        const size_t cableElement = mBodies.size();
+        mIslandParents.resize(mBodies.size() + mCables.size());
+        for (size_t i=0; i<mIslandParents.size(); ++i)
+        {
+            mIslandParents[i] = i;
+        }
+
+        for (size_t i=0; i<mJoints.size(); ++i)
+        {
+            const Joint& joint = mJoints[i];
+            const bool dynamic1 = kPartDynamic == mBodies[joint.part1].control;
+            const bool dynamic2 = kPartDynamic == mBodies[joint.part2].control;
+            // A constraint between two parts that do not move is kept apart
+            // from the islands of the dynamic parts attached to them.
+            if ( dynamic1 == dynamic2 )
+            {
+                _mergeIslands(joint.part1, joint.part2);
+            }
+        }
+
+        for (size_t c=0; c<mCables.size(); ++c)
+        {
+            const Cable& cable = mCables[c];
+            const std::vector<CablePointDefinition>& points = cable.chain.getDefinition().points;
+            for (size_t i=0; i<points.size(); ++i)
+            {
+                if ( kPartDynamic == mBodies[points[i].part].control )
+                {
+                    _mergeIslands(cableElement + c, points[i].part);
+                }
+            }
+            if ( kInvalidId != cable.winchJoint )
+            {
+                _mergeIslands(cableElement + c, _getJointElement(mJoints[cable.winchJoint]));
+            }
+        }
+
+        for (size_t i=0; i<mIslandCablePairs.size(); ++i)
+        {
+            _mergeIslands(cableElement + mIslandCablePairs[i].first, cableElement + mIslandCablePairs[i].second);
+        }
+
+        // The islands are numbered in the order of their first part,
+        // constraint or cable, and the ranges filled by a counting sort.
+        mIslandOfRoot.assign(mIslandParents.size(), sNoIsland);
+        mKinematicParts.clear();
+        size_t islandCount = 0;
+        const size_t elementCount = mBodies.size() + mJoints.size() + mCables.size();
+        mIslandOfElement.assign(elementCount, sNoIsland);
+        for (size_t e=0; e<elementCount; ++e)
+        {
+            size_t element = e;
+            if ( e < mBodies.size() )
+            {
+                if ( kPartDynamic != mBodies[e].control )
+                {
+                    mKinematicParts.push_back(static_cast<PartId>(e));
+                    continue;
+                }
+            }
+            else if ( e < mBodies.size() + mJoints.size() )
+            {
+                element = _getJointElement(mJoints[e - mBodies.size()]);
+            }
+            else
+            {
+                element = cableElement + e - mBodies.size() - mJoints.size();
+            }
+
+            const size_t root = _findIslandRoot(element);
+            if ( sNoIsland == mIslandOfRoot[root] )
+            {
+                mIslandOfRoot[root] = islandCount++;
+            }
+            mIslandOfElement[e] = mIslandOfRoot[root];
+        }
+
+        mIslands.resize(islandCount);
+        for (size_t i=0; i<islandCount; ++i)
+        {
+            Island& island = mIslands[i];
+            island.partEnd = 0;
+            island.jointEnd = 0;
+            island.cableEnd = 0;
+            island.sectionPairs.clear();
+            island.sectionPairsDirty = true;
+        }
+        for (size_t e=0; e<elementCount; ++e)
+        {
+            if ( sNoIsland == mIslandOfElement[e] )
+            {
+                continue;
+            }
+
+            Island& island = mIslands[mIslandOfElement[e]];
+            if ( e < mBodies.size() )
+            {
+                ++island.partEnd;
+            }
+            else if ( e < mBodies.size() + mJoints.size() )
+            {
+                ++island.jointEnd;
+            }
+            else
+            {
+                ++island.cableEnd;
+            }
+        }
+
+        // The ends hold the counts, then the begins, then the ends again.
+        size_t partCount = 0;
+        size_t jointCount = 0;
+        size_t cableCount = 0;
+        for (size_t i=0; i<islandCount; ++i)
+        {
+            Island& island = mIslands[i];
+            island.partBegin = partCount;
+            partCount += island.partEnd;
+            island.partEnd = island.partBegin;
+            island.jointBegin = jointCount;
+            jointCount += island.jointEnd;
+            island.jointEnd = island.jointBegin;
+            island.cableBegin = cableCount;
+            cableCount += island.cableEnd;
+            island.cableEnd = island.cableBegin;
+        }
+
+        mIslandParts.resize(partCount);
+        mIslandJoints.resize(jointCount);
+        mIslandCables.resize(cableCount);
+        for (size_t e=0; e<elementCount; ++e)
+        {
+            if ( sNoIsland == mIslandOfElement[e] )
+            {
+                continue;
+            }
+
+            Island& island = mIslands[mIslandOfElement[e]];
+            if ( e < mBodies.size() )
+            {
+                mIslandParts[island.partEnd++] = static_cast<PartId>(e);
+            }
+            else if ( e < mBodies.size() + mJoints.size() )
+            {
+                mIslandJoints[island.jointEnd++] = static_cast<ConstraintId>(e - mBodies.size());
+            }
+            else
+            {
+                mIslandCables[island.cableEnd++] = static_cast<CableId>(e - mBodies.size() - mJoints.size());
+            }
+        }
+    }
+
+    size_t NativeScene::_findIslandRoot(size_t iElement)
+    {
+        while ( mIslandParents[iElement] != iElement )
+        {
+            mIslandParents[iElement] = mIslandParents[mIslandParents[iElement]];
+            iElement = mIslandParents[iElement];
+        }
+        return iElement;
+    }
+
+    void NativeScene::_mergeIslands(size_t iElement1, size_t iElement2)
+    {
+        const size_t root1 = _findIslandRoot(iElement1);
+        const size_t root2 = _findIslandRoot(iElement2);
+        mIslandParents[std::max(root1, root2)] = std::min(root1, root2);
+    }
+
+    // The part whose island solves the constraint: a dynamic one if any.
+    size_t NativeScene::_getJointElement(const Joint& iJoint) const
+    {
+        if ( kPartDynamic != mBodies[iJoint.part1].control && kPartDynamic == mBodies[iJoint.part2].control )
+        {
+            return iJoint.part2;
+        }
+        return iJoint.part1;
+    }
+
+    // The static parts stay in place and the animated ones move at their
+    // velocity, before the islands are solved.
+    void NativeScene::_moveKinematicParts(double h)
+    {
+        mKinematicBounds.resize(mKinematicParts.size());
+        for (size_t i=0; i<mKinematicParts.size(); ++i)
+        {
+            Body& body = mBodies[mKinematicParts[i]];
+            body.previousPosition = body.position;
+            body.previousOrientation = body.orientation;
+
+            if ( kPartAnimated == body.control )
+            {
+                body.position += body.linearVelocity * h;
+                body.orientation.integrate(body.angularVelocity * h);
+            }
+
+            mKinematicBounds[i] = Aabb();
+            for (size_t g=0; g<body.geometries.size(); ++g)
+            {
+                mKinematicBounds[i].add(_getGeometryBounds(body, body.geometries[g]));
+            }
+        }
+    }
+
+    void NativeScene::_solveIsland(Island& island, Workspace& workspace, double h)
+    {
+        double* phaseTimes = mProfiler ? workspace.phaseTimes : NULL;
+        {
+            ScopedPhaseTime phase(phaseTimes, StepProfiler::kPhaseConstraintSolve);
+            _integrate(island, h);
+
+            for (size_t i=island.jointBegin; i<island.jointEnd; ++i)
+            {
+                _solveJoint(mJoints[mIslandJoints[i]], h);
+            }
+        }
+
+        {
+            ScopedPhaseTime phase(phaseTimes, StepProfiler::kPhaseCableUpdate);
+            _updateWinches(island);
+            for (size_t i=island.cableBegin; i<island.cableEnd; ++i)
+            {
+                mCables[mIslandCables[i]].chain.slide();
+            }
+            _solveCables(island, workspace, h);
+        }
+
+        {
+            ScopedPhaseTime phase(phaseTimes, StepProfiler::kPhaseCollision);
+            _solveContacts(island, workspace);
+        }
+
+        {
+            ScopedPhaseTime phase(phaseTimes, StepProfiler::kPhaseConstraintSolve);
+            _updateVelocities(island, h);
+        }
+    }
+
+    // Predict the positions from the velocities and gravity.
+    void NativeScene::_integrate(const Island& iIsland, double h)
+    {
+        for (size_t i=iIsland.partBegin; i<iIsland.partEnd; ++i)
+        {
+            Body& body = mBodies[mIslandParts[i]];
+            body.previousPosition = body.position;
+            body.previousOrientation = body.orientation;
+
+            body.linearVelocity += mGravity * h;
+            body.position += body.linearVelocity * h;
+            body.orientation.integrate(body.angularVelocity * h);
+        }
+
+        for (size_t i=iIsland.jointBegin; i<iIsland.jointEnd; ++i)
+        {
+            Joint& joint = mJoints[mIslandJoints[i]];
+            if ( kConstraintMotorized == joint.control )
+            {
+                joint.motorTarget += joint.desiredVelocity * h;
+                if ( joint.limitsActive )
+                {
+                    joint.motorTarget = std::min(std::max(joint.motorTarget, joint.lower), joint.upper);
+                }
+            }
+        }
+
+        for (size_t i=iIsland.cableBegin; i<iIsland.cableEnd; ++i)
+        {
+            mCables[mIslandCables[i]].chain.predict(h, mGravity);
+        }
+    }
+
+    // Update the coordinate of the joint from the current positions.
+    double NativeScene::_measureCoordinate(Joint& joint)
+    {
+        const Body& body1 = mBodies[joint.part1];
+        const Body& body2 = mBodies[joint.part2];
+
+        if ( kJointHinge == joint.type )
+        {
+            const Quat relative = body2.orientation.conjugate() * body1.orientation * joint.restRelative.conjugate();
+            const double raw = WrapAngle(2.0 * std::atan2(dot(relative.vec(), joint.localAxis2), relative.w));
+            joint.coordinate += WrapAngle(raw - WrapAngle(joint.coordinate));
+        }
+        else
+        {
+            const Vec3 anchor1 = body1.position + body1.orientation.rotate(joint.localAnchor1);
+            const Vec3 anchor2 = body2.position + body2.orientation.rotate(joint.localAnchor2);
+            joint.coordinate = dot(anchor1 - anchor2, body2.orientation.rotate(joint.localAxis2));
+        }
+
+        return joint.coordinate;
+    }
+
+    void NativeScene::_solveJoint(Joint& joint, double /*h*/)
+    {
+        const double coordinate = _measureCoordinate(joint);
+
+        // The value the coordinate must have after the solve.
+        double target = coordinate;
+        if ( kConstraintMotorized == joint.control )
+        {
+            target = joint.motorTarget;
+        }
+        else if ( joint.limitsActive )
+        {
+            target = std::min(std::max(coordinate, joint.lower), joint.upper);
+        }
+
+        const Body& body2 = mBodies[joint.part2];
+        const Vec3 axis = body2.orientation.rotate(joint.localAxis2);
+
+        if ( kJointHinge == joint.type )
+        {
+            // Align the axes.
+            const Vec3 axis1 = mBodies[joint.part1].orientation.rotate(joint.localAxis1);
+            _applyAngularCorrection(joint.part1, joint.part2, cross(axis1, axis));
+
+            // Drive the angle.
+            if ( target != coordinate )
+            {
+                _applyAngularCorrection(joint.part1, joint.part2, axis * (target - coordinate));
+            }
+
+            // Join the anchors.
+            const Vec3 anchor1 = mBodies[joint.part1].position + mBodies[joint.part1].orientation.rotate(joint.localAnchor1);
+            const Vec3 anchor2 = mBodies[joint.part2].position + mBodies[joint.part2].orientation.rotate(joint.localAnchor2);
+            _applyPositionalCorrection(joint.part1, joint.part2, anchor1, anchor2, anchor2 - anchor1);
+        }
+        else
+        {
+            // Lock the relative orientation.
+            const Quat error = mBodies[joint.part1].orientation * (mBodies[joint.part2].orientation * joint.restRelative).conjugate();
+            const Vec3 rotation = error.vec() * (error.w < 0.0 ? 2.0 : -2.0);
+            _applyAngularCorrection(joint.part1, joint.part2, rotation);
+
+            // Keep the anchor of part1 on the axis at the target distance.
+            const Vec3 anchor1 = mBodies[joint.part1].position + mBodies[joint.part1].orientation.rotate(joint.localAnchor1);
+            const Vec3 anchor2 = mBodies[joint.part2].position + mBodies[joint.part2].orientation.rotate(joint.localAnchor2);
+            const Vec3 goal = anchor2 + axis * target;
+            _applyPositionalCorrection(joint.part1, joint.part2, anchor1, anchor2, goal - anchor1);
+        }
+    }
+
+    // The winch pays the cable out or reels it in by changing the rest length
+    // of the section next to the winch.
+    void NativeScene::_updateWinches(const Island& iIsland)
+    {
+        for (size_t c=iIsland.cableBegin; c<iIsland.cableEnd; ++c)
+        {
+            Cable& cable = mCables[mIslandCables[c]];
+            if ( kInvalidId == cable.winchJoint )
+            {
+                continue;
+            }
+
+            const double angle = mJoints[cable.winchJoint].coordinate;
+            cable.chain.spool((angle - cable.winchAngle) * cable.winchRadius);
+            cable.winchAngle = angle;
+        }
+    }
+
+    void NativeScene::_solveCables(const Island& iIsland, Workspace& workspace, double h)
+    {
+        for (size_t c=iIsland.cableBegin; c<iIsland.cableEnd; ++c)
+        {
+            CableChain& chain = mCables[mIslandCables[c]].chain;
+            if ( chain.isImplicit() )
+            {
+                _solveCableImplicit(chain, workspace, h);
+            }
+            else
+            {
+                chain.solve(h);
+            }
+
+            // The pinned nodes follow their part, and pull on it.
+            for (size_t i=0; i<chain.getNodeCount(); ++i)
+            {
+                const PartId part = chain.getNodePart(i);
+                if ( kInvalidId != part )
+                {
+                    const Body& body = mBodies[part];
+                    const Vec3 point = body.position + body.orientation.rotate(chain.getNodeOffset(i));
+                    _applyParticleCorrection(chain, i, part, point, point - chain.getNodePosition(i));
+                }
+            }
+        }
+    }
+
+    // The pinned nodes start on their part and are lumped with it in the
+    // solve of the chain; each part then takes its share of the impulse of
+    // its nodes, so that it moves along with them.
+    // A pinned node and its part move together: lumped, their inverse mass
+    // at the node is W = w (w I + Wp)^-1 Wp, where w is the inverse mass of
+    // the node and Wp the one of the part at the node. The part takes the
+    // share w (w I + Wp)^-1 of the impulse of the node.
+    void NativeScene::_solveCableImplicit(CableChain& chain, Workspace& workspace, double h)
+    {
+        const size_t nodeCount = chain.getNodeCount();
+        std::vector<double>& pinnedInvMass = workspace.pinnedInvMass;
+        std::vector<Mat3>& partShare = workspace.partShare;
+        pinnedInvMass.resize(6 * nodeCount);
+        partShare.resize(nodeCount);
+        for (int iteration=0; iteration<sImplicitCableIterations; ++iteration)
+        {
+            for (size_t i=0; i<nodeCount; ++i)
+            {
+                const PartId part = chain.getNodePart(i);
+                if ( kInvalidId == part )
+                {
+                    continue;
+                }
+
+                const Body& body = mBodies[part];
+                const Vec3 point = body.position + body.orientation.rotate(chain.getNodeOffset(i));
+                chain.setNodePosition(i, point);
+
+                const double nodeInvMass = chain.getNodeInvMass(i);
+                const Mat3 partInvMass = _getPointInverseMass(body, point);
+                partShare[i] = (Mat3::identity() * nodeInvMass + partInvMass).inverse() * nodeInvMass;
+                const Mat3 lumped = partShare[i] * partInvMass;
+                double* w = &pinnedInvMass[6 * i];
+                w[0] = lumped.a[0][0];
+                w[1] = 0.5 * (lumped.a[0][1] + lumped.a[1][0]);
+                w[2] = 0.5 * (lumped.a[0][2] + lumped.a[2][0]);
+                w[3] = lumped.a[1][1];
+                w[4] = 0.5 * (lumped.a[1][2] + lumped.a[2][1]);
+                w[5] = lumped.a[2][2];
+            }
+
+            if ( !chain.solve(h, nodeCount > 0 ? &pinnedInvMass[0] : NULL, iteration) )
+            {
+                break;
+            }
+
+            for (size_t i=0; i<nodeCount; ++i)
+            {
+                const PartId part = chain.getNodePart(i);
+                if ( kInvalidId == part || kPartDynamic != mBodies[part].control )
+                {
+                    continue;
+                }
+
+                Body& body = mBodies[part];
+                const Vec3 point = body.position + body.orientation.rotate(chain.getNodeOffset(i));
+                const Vec3 p = partShare[i] * chain.getNodeImpulse(i);
+                body.position += p * body.invMass;
+                body.orientation.integrate(_worldInvInertia(body, cross(point - body.position, p)));
+            }
+        }
+    }
+
+    // The samples of a part are only tested against the static and animated
+    // parts whose box overlaps the box of the samples, which is measured
+    // again after each correction of the part.
+    void NativeScene::_solveContacts(Island& island, Workspace& workspace)
+    {
+        for (size_t i=island.partBegin; i<island.partEnd; ++i)
+        {
+            const PartId b = mIslandParts[i];
+            Body& body = mBodies[b];
+            Aabb bounds;
+            bool boundsValid = false;
+            for (size_t k=0; k<mKinematicParts.size(); ++k)
+            {
+                const PartId o = mKinematicParts[k];
+                const Body& other = mBodies[o];
+                if ( !_canCollide(body, other) )
+                {
+                    continue;
+                }
+
+                if ( !boundsValid )
+                {
+                    bounds = Aabb();
+                    for (size_t s=0; s<body.samples.size(); ++s)
+                    {
+                        bounds.add(body.position + body.orientation.rotate(body.samples[s]));
+                    }
+                    boundsValid = true;
+                }
+                if ( !bounds.overlaps(mKinematicBounds[k]) )
+                {
+                    continue;
+                }
+
+                for (size_t s=0; s<body.samples.size(); ++s)
+                {
+                    for (size_t g=0; g<other.geometries.size(); ++g)
+                    {
+                        const Vec3 point = body.position + body.orientation.rotate(body.samples[s]);
+                        Vec3 normal;
+                        double depth = 0.0;
+                        if ( !_getPenetration(other, other.geometries[g], point, 0.0, normal, depth) )
+                        {
+                            continue;
+                        }
+
+                        _applyPositionalCorrection(b, o, point, point, normal * depth);
+                        boundsValid = false;
+
+                        // Static friction cancels the tangential motion of the point, up to the Coulomb cone.
+                        const Vec3 corrected = body.position + body.orientation.rotate(body.samples[s]);
+                        const Vec3 previous = body.previousPosition + body.previousOrientation.rotate(body.samples[s]);
+                        Vec3 slip = corrected - previous;
+                        slip -= normal * dot(normal, slip);
+                        const double slipLength = length(slip);
+                        if ( slipLength > 0.0 )
+                        {
+                            const double scale = std::min(1.0, sFriction * depth / slipLength);
+                            _applyPositionalCorrection(b, o, corrected, corrected, -slip * scale);
+                        }
+                    }
+                }
+            }
+        }
+
+        _solveCableContacts(island, workspace);
+    }
+
+    // The free nodes of the cables touch the static and animated geometries,
+    // and the sections of the cables touch each other. The broadphase of
+    // each cable only hands out the sections near a geometry or another
+    // section, so the cost follows the number of contacts rather than the
+    // number of sections times the number of geometries.
+    void NativeScene::_solveCableContacts(Island& island, Workspace& workspace)
+    {
+        bool moved = island.sectionPairsDirty;
+        island.sectionPairsDirty = false;
+        for (size_t c=island.cableBegin; c<island.cableEnd; ++c)
+        {
+            Cable& cable = mCables[mIslandCables[c]];
+            if ( cable.chain.hasCollision() )
+            {
+                const double radius = cable.chain.getDefinition().params.radius;
+                moved = cable.broadphase.update(cable.chain, radius, radius) || moved;
+            }
+        }
+
+        std::vector<size_t>& candidateSections = workspace.candidateSections;
+        for (size_t c=island.cableBegin; c<island.cableEnd; ++c)
+        {
+            Cable& cable = mCables[mIslandCables[c]];
+            CableChain& chain = cable.chain;
+            if ( !chain.hasCollision() )
+            {
+                continue;
+            }
+
+            const double radius = chain.getDefinition().params.radius;
+            for (size_t k=0; k<mKinematicParts.size(); ++k)
+            {
+                if ( !cable.broadphase.getBounds().overlaps(mKinematicBounds[k]) )
+                {
+                    continue;
+                }
+
+                const Body& other = mBodies[mKinematicParts[k]];
+
+                for (size_t g=0; g<other.geometries.size(); ++g)
+                {
+                    candidateSections.clear();
+                    cable.broadphase.query(_getGeometryBounds(other, other.geometries[g]), candidateSections);
+
+                    // The sections come in order: the first node of a section
+                    // is the last one of the previous candidate.
+                    for (size_t s=0; s<candidateSections.size(); ++s)
+                    {
+                        const size_t section = candidateSections[s];
+                        const size_t first = s > 0 && candidateSections[s - 1] + 1 == section ? section + 1 : section;
+                        for (size_t i=first; i<=section+1; ++i)
+                        {
+                            if ( kInvalidId != chain.getNodePart(i) )
+                            {
+                                continue;
+                            }
+
+                            Vec3 position = chain.getNodePosition(i);
+                            Vec3 normal;
+                            double depth = 0.0;
+                            if ( _getPenetration(other, other.geometries[g], position, radius, normal, depth) )
+                            {
+                                position += normal * depth;
+
+                                Vec3 slip = position - chain.getNodePreviousPosition(i);
+                                slip -= normal * dot(normal, slip);
+                                const double slipLength = length(slip);
+                                if ( slipLength > 0.0 )
+                                {
+                                    position -= slip * std::min(1.0, sFriction * depth / slipLength);
+                                }
+                                chain.setNodePosition(i, position);
+                                chain.setNodeContact(i);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // The candidate pairs of sections only change when a fat box moved.
+        std::vector<CableBroadphase::SectionPair>& candidatePairs = workspace.candidatePairs;
+        if ( moved )
+        {
+            island.sectionPairs.clear();
+            for (size_t i=island.cableBegin; i<island.cableEnd; ++i)
+            {
+                const CableId c = mIslandCables[i];
+                if ( !mCables[c].chain.hasCollision() )
+                {
+                    continue;
+                }
+
+                for (size_t j=i; j<island.cableEnd; ++j)
+                {
+                    const CableId d = mIslandCables[j];
+                    if ( !mCables[d].chain.hasCollision() )
+                    {
+                        continue;
+                    }
+
+                    candidatePairs.clear();
+                    if ( c == d )
+                    {
+                        mCables[c].broadphase.findSelfPairs(candidatePairs);
+                    }
+                    else
+                    {
+                        mCables[c].broadphase.findPairs(mCables[d].broadphase, candidatePairs);
+                    }
+
+                    for (size_t p=0; p<candidatePairs.size(); ++p)
+                    {
+                        if ( c == d && _isSelfContactExcluded(mCables[c].chain, candidatePairs[p].first, candidatePairs[p].second) )
+                        {
+                            continue;
+                        }
+
+                        SectionPair pair;
+                        pair.cable1 = c;
+                        pair.section1 = candidatePairs[p].first;
+                        pair.cable2 = d;
+                        pair.section2 = candidatePairs[p].second;
+                        island.sectionPairs.push_back(pair);
+                    }
+                }
+            }
+        }
+
+        for (size_t p=0; p<island.sectionPairs.size(); ++p)
+        {
+            const SectionPair& pair = island.sectionPairs[p];
+            CableChain& chain1 = mCables[pair.cable1].chain;
+            CableChain& chain2 = mCables[pair.cable2].chain;
+            const double distance = chain1.getDefinition().params.radius + chain2.getDefinition().params.radius;
+            _solveSectionContact(chain1, pair.section1, chain2, pair.section2, distance);
+        }
+    }
+
+    // A cable can not fold back on itself tighter than its radius: the
+    // sections closer along the chain than half a turn of that radius touch
+    // because of the bend, not because of a contact. The cable also turns
+    // around the winches and pulleys on a single pinned node, so the two
+    // sections on both sides of its neighbours are left out too.
+    bool NativeScene::_isSelfContactExcluded(const CableChain& iChain, size_t iSection1, size_t iSection2) const
+    {
+        if ( iSection1 + 2 == iSection2
+             && (kInvalidId != iChain.getNodePart(iSection1 + 1) || kInvalidId != iChain.getNodePart(iSection2)) )
+        {
+            return true;
+        }
+
+        const double halfTurn = sPi * iChain.getDefinition().params.radius;
+        double length = 0.0;
+        for (size_t i=iSection1+1; i<iSection2; ++i)
+        {
+            length += iChain.getSectionRestLength(i);
+            if ( length >= halfTurn )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Push the closest points of two sections iDistance apart. The pinned
+    // nodes follow their part and do not move.
+    void NativeScene::_solveSectionContact(CableChain& chain1, size_t iSection1, CableChain& chain2, size_t iSection2, double iDistance)
+    {
+        if ( chain1.isSectionBroken(iSection1) || chain2.isSectionBroken(iSection2) )
+        {
+            return;
+        }
+
+        const Vec3 p0 = chain1.getNodePosition(iSection1);
+        const Vec3 p1 = chain1.getNodePosition(iSection1 + 1);
+        const Vec3 q0 = chain2.getNodePosition(iSection2);
+        const Vec3 q1 = chain2.getNodePosition(iSection2 + 1);
+        double s = 0.0;
+        double t = 0.0;
+        ClosestSegmentParameters(p0, p1, q0, q1, s, t);
+
+        const Vec3 delta = (p0 + (p1 - p0) * s) - (q0 + (q1 - q0) * t);
+        const double gap = length(delta);
+        if ( gap >= iDistance || gap < 1e-12 )
+        {
+            return;
+        }
+
+        const double w[4] = {
+            kInvalidId == chain1.getNodePart(iSection1) ? chain1.getNodeInvMass(iSection1) : 0.0,
+            kInvalidId == chain1.getNodePart(iSection1 + 1) ? chain1.getNodeInvMass(iSection1 + 1) : 0.0,
+            kInvalidId == chain2.getNodePart(iSection2) ? chain2.getNodeInvMass(iSection2) : 0.0,
+            kInvalidId == chain2.getNodePart(iSection2 + 1) ? chain2.getNodeInvMass(iSection2 + 1) : 0.0 };
+        const double b[4] = { 1.0 - s, s, 1.0 - t, t };
+        const double weight = w[0] * b[0] * b[0] + w[1] * b[1] * b[1] + w[2] * b[2] * b[2] + w[3] * b[3] * b[3];
+        if ( weight <= 0.0 )
+        {
+            return;
+        }
+
+        const Vec3 push = delta * ((iDistance - gap) / (gap * weight));
+        chain1.setNodePosition(iSection1, p0 + push * (w[0] * b[0]));
+        chain1.setNodePosition(iSection1 + 1, p1 + push * (w[1] * b[1]));
+        chain2.setNodePosition(iSection2, q0 - push * (w[2] * b[2]));
+        chain2.setNodePosition(iSection2 + 1, q1 - push * (w[3] * b[3]));
+        for (int i=0; i<2; ++i)
+        {
+            if ( w[i] > 0.0 )
+            {
+                chain1.setNodeContact(iSection1 + i);
+            }
+            if ( w[2 + i] > 0.0 )
+            {
+                chain2.setNodeContact(iSection2 + i);
+            }
+        }
+    }
+
+    // Box of the geometry in world coordinates, infinite for planes.
+    Aabb NativeScene::_getGeometryBounds(const Body& iBody, const Geometry& iGeometry) const
+    {
+        if ( kGeometryPlane == iGeometry.type )
+        {
+            return Aabb(Vec3(-1e300, -1e300, -1e300), Vec3(1e300, 1e300, 1e300));
+        }
+
+        const Quat orientation = iBody.orientation * iGeometry.orientation;
+        const Vec3 center = iBody.position + iBody.orientation.rotate(iGeometry.position);
+        const Vec3 ax = orientation.rotate(Vec3(iGeometry.halfExtents.x, 0.0, 0.0));
+        const Vec3 ay = orientation.rotate(Vec3(0.0, iGeometry.halfExtents.y, 0.0));
+        const Vec3 az = orientation.rotate(Vec3(0.0, 0.0, iGeometry.halfExtents.z));
+        const Vec3 extent(std::fabs(ax.x) + std::fabs(ay.x) + std::fabs(az.x),
+                          std::fabs(ax.y) + std::fabs(ay.y) + std::fabs(az.y),
+                          std::fabs(ax.z) + std::fabs(ay.z) + std::fabs(az.z));
+        return Aabb(center - extent, center + extent);
+    }
+
+    void NativeScene::_updateVelocities(const Island& iIsland, double h)
+    {
+        for (size_t i=iIsland.partBegin; i<iIsland.partEnd; ++i)
+        {
+            Body& body = mBodies[mIslandParts[i]];
+            body.linearVelocity = (body.position - body.previousPosition) / h;
+            const Quat dq = body.orientation * body.previousOrientation.conjugate();
+            body.angularVelocity = dq.vec() * ((dq.w < 0.0 ? -2.0 : 2.0) / h);
+        }
+
+        for (size_t i=iIsland.cableBegin; i<iIsland.cableEnd; ++i)
+        {
+            mCables[mIslandCables[i]].chain.updateVelocities(h);
+        }
+    }
+
+    Vec3 NativeScene::_worldInvInertia(const Body& iBody, const Vec3& v) const
+    {
+        return iBody.orientation.rotate(iBody.invInertia * iBody.orientation.inverseRotate(v));
+    }
+
+    double NativeScene::_getGeneralizedInverseMass(const Body& iBody, const Vec3& iPoint, const Vec3& iNormal) const
+    {
+        if ( kPartDynamic != iBody.control )
+        {
+            return 0.0;
+        }
+
+        const Vec3 rn = cross(iPoint - iBody.position, iNormal);
+        return iBody.invMass + dot(rn, _worldInvInertia(iBody, rn));
+    }
+
+    Mat3 NativeScene::_getPointInverseMass(const Body& iBody, const Vec3& iPoint) const
+    {
+        Mat3 m;
+        if ( kPartDynamic != iBody.control )
+        {
+            return m;
+        }
+
+        // Column j is the motion of the point for a unit impulse along axis j.
+        const Vec3 r = iPoint - iBody.position;
+        for (int j=0; j<3; ++j)
+        {
+            const Vec3 impulse(0 == j ? 1.0 : 0.0, 1 == j ? 1.0 : 0.0, 2 == j ? 1.0 : 0.0);
+            const Vec3 motion = impulse * iBody.invMass + cross(_worldInvInertia(iBody, cross(r, impulse)), r);
+            for (int i=0; i<3; ++i)
+            {
+                m.a[i][j] = motion[i];
+            }
+        }
+        return m;
+    }
+
+    // Move iPoint1 on part1 by iCorrection relative to iPoint2 on part2,
+    // sharing the correction according to the generalized inverse masses.
+    void NativeScene::_applyPositionalCorrection(PartId iPart1, PartId iPart2, const Vec3& iPoint1, const Vec3& iPoint2, const Vec3& iCorrection)
+    {
+        const double c = length(iCorrection);
+        if ( c < 1e-12 )
+        {
+            return;
+        }
+
+        const Vec3 n = iCorrection / c;
+        Body& body1 = mBodies[iPart1];
+        Body& body2 = mBodies[iPart2];
+        const double w1 = _getGeneralizedInverseMass(body1, iPoint1, n);
+        const double w2 = _getGeneralizedInverseMass(body2, iPoint2, n);
+        if ( w1 + w2 <= 0.0 )
+        {
+            return;
+        }
+
+        const Vec3 p = n * (c / (w1 + w2));
+        if ( w1 > 0.0 )
+        {
+            body1.position += p * body1.invMass;
+            body1.orientation.integrate(_worldInvInertia(body1, cross(iPoint1 - body1.position, p)));
+        }
+        if ( w2 > 0.0 )
+        {
+            body2.position -= p * body2.invMass;
+            body2.orientation.integrate(-_worldInvInertia(body2, cross(iPoint2 - body2.position, p)));
+        }
+    }
+
+    // Rotate part1 by iRotation relative to part2.
+    void NativeScene::_applyAngularCorrection(PartId iPart1, PartId iPart2, const Vec3& iRotation)
+    {
+        const double angle = length(iRotation);
+        if ( angle < 1e-12 )
+        {
+            return;
+        }
+
+        const Vec3 n = iRotation / angle;
+        Body& body1 = mBodies[iPart1];
+        Body& body2 = mBodies[iPart2];
+        const double w1 = kPartDynamic == body1.control ? dot(n, _worldInvInertia(body1, n)) : 0.0;
+        const double w2 = kPartDynamic == body2.control ? dot(n, _worldInvInertia(body2, n)) : 0.0;
+        if ( w1 + w2 <= 0.0 )
+        {
+            return;
+        }
+
+        const Vec3 p = n * (angle / (w1 + w2));
+        if ( w1 > 0.0 )
+        {
+            body1.orientation.integrate(_worldInvInertia(body1, p));
+        }
+        if ( w2 > 0.0 )
+        {
+            body2.orientation.integrate(-_worldInvInertia(body2, p));
+        }
+    }
+
+    // Move the cable node by iCorrection relative to iPoint on the part.
+    void NativeScene::_applyParticleCorrection(CableChain& chain, size_t iNode, PartId iPart, const Vec3& iPoint, const Vec3& iCorrection)
+    {
+        const double c = length(iCorrection);
+        if ( c < 1e-12 )
+        {
+            return;
+        }
+
+        const Vec3 n = iCorrection / c;
+        Body& body = mBodies[iPart];
+        const double nodeInvMass = chain.getNodeInvMass(iNode);
+        const double w = _getGeneralizedInverseMass(body, iPoint, n);
+        if ( nodeInvMass + w <= 0.0 )
+        {
+            return;
+        }
+
+        const Vec3 p = n * (c / (nodeInvMass + w));
+        chain.setNodePosition(iNode, chain.getNodePosition(iNode) + p * nodeInvMass);
+        if ( w > 0.0 )
+        {
+            body.position -= p * body.invMass;
+            body.orientation.integrate(-_worldInvInertia(body, cross(iPoint - body.position, p)));
+        }
+    }
+
+    bool NativeScene::_getPenetration(const Body& iBody, const Geometry& iGeometry, const Vec3& iPoint, double iRadius, Vec3& oNormal, double& oDepth) const
+    {
+        const Quat orientation = iBody.orientation * iGeometry.orientation;
+        const Vec3 local = orientation.inverseRotate(iBody.orientation.inverseRotate(iPoint - iBody.position) - iGeometry.position);
+
+        if ( kGeometryPlane == iGeometry.type )
+        {
+            oDepth = iRadius - local.z;
+            oNormal = orientation.rotate(Vec3(0.0, 0.0, 1.0));
+            return oDepth > 0.0;
+        }
+
+        // Boxes, and cylinders approximated by their box.
+        const Vec3& h = iGeometry.halfExtents;
+        const double depths[3] = { h.x + iRadius - std::fabs(local.x), h.y + iRadius - std::fabs(local.y), h.z + iRadius - std::fabs(local.z) };
+        int axis = 0;
+        for (int i=0; i<3; ++i)
+        {
+            if ( depths[i] <= 0.0 )
+            {
+                return false;
+            }
+            if ( depths[i] < depths[axis] )
+            {
+                axis = i;
+            }
+        }
+
+        Vec3 normal;
+        const double side = local[axis] < 0.0 ? -1.0 : 1.0;
+        if ( 0 == axis )
+        {
+            normal.x = side;
+        }
+        else if ( 1 == axis )
+        {
+            normal.y = side;
+        }
+        else
+        {
+            normal.z = side;
+        }
+
+        oDepth = depths[axis];
+        oNormal = orientation.rotate(normal);
+        return true;
+    }
+}
@@ -0,0 +1,182 @@
+#include "ParameterSweep.h"
+#include "ExCableSystem.h"
+#include "MyCrane.h"
+#include "NativeScene.h"
+#include "StepStatistics.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+ParameterSweep::Grid::Grid()
+    : axialStiffness(1, 10000.0)
+    , axialDamping(1, 2000.0)
+    , maxSectionLength(1, 0.0)
+    , loadMass(1, 400.0)
+    , timeStep(1, 1.0 / 60.0)
+{
+}
+
+size_t ParameterSweep::Grid::getPointCount() const
+{
+    return axialStiffness.size() * axialDamping.size() * maxSectionLength.size() * loadMass.size() * timeStep.size();
+}
+
+ParameterSweep::ParameterSweep(const Grid& iGrid, double iSimulationTime)
+    : mGrid(iGrid)
+    , mSimulationTime(iSimulationTime)
+    , mWinchSpeed(-0.5)
+    , mMaxTension(0.0)
+    , mCableLoader(NULL)
+    , mResults()
+{
+}
+
+// The time step varies the fastest, the stiffness the slowest.
+ParameterSweep::Point ParameterSweep::getPoint(size_t iIndex) const
+{
+    Point point;
+    point.timeStep = mGrid.timeStep[iIndex % mGrid.timeStep.size()];
+    iIndex /= mGrid.timeStep.size();
+    point.loadMass = mGrid.loadMass[iIndex % mGrid.loadMass.size()];
+    iIndex /= mGrid.loadMass.size();
+    point.maxSectionLength = mGrid.maxSectionLength[iIndex % mGrid.maxSectionLength.size()];
+    iIndex /= mGrid.maxSectionLength.size();
+    point.axialDamping = mGrid.axialDamping[iIndex % mGrid.axialDamping.size()];
+    iIndex /= mGrid.axialDamping.size();
+    point.axialStiffness = mGrid.axialStiffness[iIndex % mGrid.axialStiffness.size()];
+    return point;
+}
+
+void ParameterSweep::run(ThreadPool& iPool)
+{
+    mResults.assign(getPointCount(), Result());
+
+    // Each task writes only its own entry of the results.
+    iPool.run(mResults.size(), [this](size_t iTask, size_t /*iWorker*/)
+    {
+        mResults[iTask] = _runPoint(getPoint(iTask));
+    });
+}
+
+ParameterSweep::Result ParameterSweep::_runPoint(const Point& iPoint) const
+{
+    ExCableSystem::Settings settings;
+    settings.loadMass = iPoint.loadMass;
+    settings.cableLoader = mCableLoader;
+    settings.axialStiffness = iPoint.axialStiffness;
+    settings.axialDamping = iPoint.axialDamping;
+    settings.maxSectionLength = iPoint.maxSectionLength;
+    settings.maxTension = mMaxTension;
+
+    Sim::NativeScene scene;
+    ExCableSystem cableSystem(scene, settings);
+    const Sim::CableId cable = cableSystem.getCable();
+    cableSystem.getCrane()->setWinchSpeed(mWinchSpeed);
+
+    Result result;
+    result.point = iPoint;
+    result.stepCount = static_cast<size_t>(ceil(mSimulationTime / iPoint.timeStep));
+    result.maxTension = 0.0;
+    result.breakTime = -1.0;
+    result.finalLength = 0.0;
+
+    StepStatistics statistics;
+    statistics.reserve(result.stepCount);
+    for (size_t i=0; i<result.stepCount; ++i)
+    {
+        const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+        scene.step(iPoint.timeStep);
+        statistics.addStep(std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count());
+
+        if ( Sim::kInvalidId == cable )
+        {
+            continue;
+        }
+        for (size_t j=0; j<scene.getCableSectionCount(cable); ++j)
+        {
+            if ( scene.getCableSectionTension(cable, j) > result.maxTension )
+            {
+                result.maxTension = scene.getCableSectionTension(cable, j);
+            }
+        }
+        if ( result.breakTime < 0.0 && scene.isCableBroken(cable) )
+        {
+            result.breakTime = scene.getTime();
+        }
+    }
+
+    if ( Sim::kInvalidId != cable )
+    {
+        result.finalLength = scene.getCableLength(cable);
+    }
+
+    const StepStatistics::Summary summary = statistics.computeSummary();
+    result.meanStepTime = summary.mean;
+    result.p99StepTime = summary.p99;
+    return result;
+}
+
+bool ParameterSweep::writeTable(const std::string& iFileName) const
+{
+    std::ofstream stream(iFileName.c_str());
+    if ( !stream )
+    {
+        std::cout << "Cannot write the sweep results to " << iFileName << std::endl;
+        return false;
+    }
+
+    _writeCsv(stream);
+    return stream.good();
+}
+
+void ParameterSweep::_writeCsv(std::ostream& oStream) const
+{
+    oStream << "stiffness,damping,max_section_length,load_mass,time_step,steps,max_tension,break_time_s,final_length,step_mean_ms,step_p99_ms" << std::endl;
+    oStream << std::setprecision(9);
+    for (size_t i=0; i<mResults.size(); ++i)
+    {
+        const Result& result = mResults[i];
+        oStream << result.point.axialStiffness << ","
+                << result.point.axialDamping << ","
+                << result.point.maxSectionLength << ","
+                << result.point.loadMass << ","
+                << result.point.timeStep << ","
+                << result.stepCount << ","
+                << result.maxTension << ","
+                << result.breakTime << ","
+                << result.finalLength << ","
+                << result.meanStepTime * 1e3 << ","
+                << result.p99StepTime * 1e3 << "\n";
+    }
+}
+
+void ParameterSweep::printTable() const
+{
+    std::cout << std::setw(10) << "stiffness" << std::setw(10) << "damping" << std::setw(9) << "section"
+              << std::setw(9) << "mass" << std::setw(10) << "dt" << std::setw(12) << "max T"
+              << std::setw(9) << "break" << std::setw(9) << "length" << std::setw(10) << "step ms" << std::endl;
+    for (size_t i=0; i<mResults.size(); ++i)
+    {
+        const Result& result = mResults[i];
+        std::cout << std::setw(10) << result.point.axialStiffness
+                  << std::setw(10) << result.point.axialDamping
+                  << std::setw(9) << result.point.maxSectionLength
+                  << std::setw(9) << result.point.loadMass
+                  << std::setw(10) << result.point.timeStep
+                  << std::setw(12) << result.maxTension;
+        if ( result.breakTime < 0.0 )
+        {
+            std::cout << std::setw(9) << "-";
+        }
+        else
+        {
+            std::cout << std::setw(9) << result.breakTime;
+        }
+        std::cout << std::setw(9) << result.finalLength
+                  << std::setw(10) << result.meanStepTime * 1e3 << std::endl;
+    }
+}
@@ -0,0 +1,78 @@
+#include "ProfilerExtension.h"
+
+#include <VxSim/VxPluginExtension.h>
+#include <VxSim/VxUuid.h>
+
+const VxSim::VxFactoryKey ProfilerExtension::kFactoryKey(VxSim::VxUuid("0b7f3e52-2c1d-4f0a-9d55-6a3c1e8b4f21"), "Tutorials", "ProfilerExtension");
+
+// Default Destructor
+ProfilerExtension::~ProfilerExtension()
+{
+}
+
+// Default Constructor
+ProfilerExtension::ProfilerExtension(VxSim::VxPluginExtension *iProxy)
+    : VxSim::IExtension(iProxy)
+    , VxSim::IDynamics(iProxy)
+    , outputPreUpdateTime(0.0, "Pre-update time", &iProxy->getOutputContainer())
+    , outputConstraintSolveTime(0.0, "Constraint solve time", &iProxy->getOutputContainer())
+    , outputGraphicsSyncTime(0.0, "Graphics sync time", &iProxy->getOutputContainer())
+    , outputStepCount(0, "Step count", &iProxy->getOutputContainer())
+    , mProfiler(NULL)
+    , mMark()
+{
+}
+
+void ProfilerExtension::setProfiler(StepProfiler* iProfiler)
+{
+    mProfiler = iProfiler;
+}
+
+void ProfilerExtension::beginUpdate()
+{
+    if ( mProfiler )
+    {
+        mProfiler->beginStep();
+    }
+    mMark = std::chrono::steady_clock::now();
+}
+
+void ProfilerExtension::preStep()
+{
+    const double elapsed = _lap();
+    outputPreUpdateTime = elapsed;
+    if ( mProfiler )
+    {
+        mProfiler->addPhaseTime(StepProfiler::kPhasePreUpdate, elapsed);
+    }
+}
+
+void ProfilerExtension::postStep()
+{
+    const double elapsed = _lap();
+    outputConstraintSolveTime = elapsed;
+    if ( mProfiler )
+    {
+        mProfiler->addPhaseTime(StepProfiler::kPhaseConstraintSolve, elapsed);
+    }
+}
+
+void ProfilerExtension::endUpdate()
+{
+    const double elapsed = _lap();
+    outputGraphicsSyncTime = elapsed;
+    outputStepCount = outputStepCount.getValue() + 1;
+    if ( mProfiler )
+    {
+        mProfiler->addPhaseTime(StepProfiler::kPhaseGraphicsSync, elapsed);
+        mProfiler->endStep();
+    }
+}
+
+double ProfilerExtension::_lap()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - mMark).count();
+    mMark = now;
+    return elapsed;
+}
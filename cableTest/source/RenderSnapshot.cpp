@@ -0,0 +1,52 @@
+#include "RenderSnapshot.h"
+#include "NativeScene.h"
+
+RenderSnapshot::RenderSnapshot()
+    : step(0)
+    , time(0.0)
+    , partPositions()
+    , partOrientations()
+    , cableRadii()
+    , cableNodeStarts()
+    , cableNodes()
+{
+}
+
+void RenderSnapshot::capture(const Sim::NativeScene& iScene)
+{
+    step = iScene.getStepCount();
+    time = iScene.getTime();
+
+    const size_t partCount = iScene.getPartCount();
+    partPositions.resize(partCount);
+    partOrientations.resize(partCount);
+    for (size_t i=0; i<partCount; ++i)
+    {
+        const Sim::PartId part = static_cast<Sim::PartId>(i);
+        partPositions[i] = iScene.getPartPosition(part);
+        partOrientations[i] = iScene.getPartOrientation(part);
+    }
+
+    const size_t cableCount = iScene.getCableCount();
+    cableRadii.resize(cableCount);
+    cableNodeStarts.resize(cableCount + 1);
+    size_t nodeCount = 0;
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        cableRadii[c] = iScene.getCable(static_cast<Sim::CableId>(c)).getDefinition().params.radius;
+        cableNodeStarts[c] = nodeCount;
+        nodeCount += iScene.getCableNodeCount(static_cast<Sim::CableId>(c));
+    }
+    cableNodeStarts[cableCount] = nodeCount;
+
+    cableNodes.resize(nodeCount);
+    for (size_t c=0; c<cableCount; ++c)
+    {
+        const Sim::CableChain& chain = iScene.getCable(static_cast<Sim::CableId>(c));
+        Sim::Vec3* nodes = nodeCount > 0 ? &cableNodes[cableNodeStarts[c]] : NULL;
+        for (size_t i=0; i<chain.getNodeCount(); ++i)
+        {
+            nodes[i] = chain.getNodePosition(i);
+        }
+    }
+}
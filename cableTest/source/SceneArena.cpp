@@ -0,0 +1,52 @@
+#include "SceneArena.h"
+
+#include <cstdint>
+
+namespace Sim
+{
+    SceneArena::SceneArena(size_t iBlockSize)
+        : mBlockSize(iBlockSize > 0 ? iBlockSize : 1)
+        , mBlocks()
+        , mNext(NULL)
+        , mEnd(NULL)
+        , mReservedBytes(0)
+        , mAllocatedBytes(0)
+        , mReleasedBytes(0)
+    {
+    }
+
+    SceneArena::~SceneArena()
+    {
+        for (size_t i=0; i<mBlocks.size(); ++i)
+        {
+            ::operator delete(mBlocks[i]);
+        }
+    }
+
+    void* SceneArena::allocate(size_t iSize, size_t iAlignment)
+    {
+        const uintptr_t mask = static_cast<uintptr_t>(iAlignment) - 1;
+        uintptr_t start = (reinterpret_cast<uintptr_t>(mNext) + mask) & ~mask;
+        if ( NULL == mNext || start + iSize > reinterpret_cast<uintptr_t>(mEnd) )
+        {
+            // The rest of the last block is left unused. The blocks from
+            // operator new are aligned for any type.
+            const size_t blockSize = iSize > mBlockSize ? iSize : mBlockSize;
+            char* block = static_cast<char*>(::operator new(blockSize));
+            mBlocks.push_back(block);
+            mReservedBytes += blockSize;
+            mNext = block;
+            mEnd = block + blockSize;
+            start = reinterpret_cast<uintptr_t>(block);
+        }
+
+        mNext = reinterpret_cast<char*>(start + iSize);
+        mAllocatedBytes += iSize;
+        return reinterpret_cast<void*>(start);
+    }
+
+    void SceneArena::deallocate(void* /*iPointer*/, size_t iSize)
+    {
+        mReleasedBytes += iSize;
+    }
+}
@@ -0,0 +1,159 @@
+#include "SceneExporter.h"
+#include "NativeScene.h"
+#include "TrajectoryFormat.h"
+
+#include <iostream>
+
+using namespace TrajectoryFormat;
+
+const char SceneExporter::kMagic[4] = { 'C', 'S', 'C', 'N' };
+const char SceneExporter::kIndexMagic[4] = { 'C', 'S', 'C', 'I' };
+const unsigned int SceneExporter::kVersion;
+
+static void PutVec3(std::vector<unsigned char>& oBuffer, const Sim::Vec3& iValue)
+{
+    PutF32(oBuffer, static_cast<float>(iValue.x));
+    PutF32(oBuffer, static_cast<float>(iValue.y));
+    PutF32(oBuffer, static_cast<float>(iValue.z));
+}
+
+static void PutQuat(std::vector<unsigned char>& oBuffer, const Sim::Quat& iValue)
+{
+    PutF32(oBuffer, static_cast<float>(iValue.w));
+    PutF32(oBuffer, static_cast<float>(iValue.x));
+    PutF32(oBuffer, static_cast<float>(iValue.y));
+    PutF32(oBuffer, static_cast<float>(iValue.z));
+}
+
+SceneExporter::SceneExporter()
+    : mSnapshot()
+    , mBuilder()
+    , mFrame()
+    , mFrameOffsets()
+    , mOffset(0)
+    , mHeaderSize(0)
+    , mStream()
+{
+}
+
+SceneExporter::~SceneExporter()
+{
+    close();
+}
+
+bool SceneExporter::open(const std::string& iFileName, const Sim::NativeScene& iScene)
+{
+    close();
+
+    mStream.open(iFileName.c_str(), std::ios::binary | std::ios::trunc);
+    if ( !mStream )
+    {
+        std::cout << "Cannot export the scene to " << iFileName << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> header;
+    header.insert(header.end(), kMagic, kMagic + 4);
+    PutU32(header, kVersion);
+    PutU32(header, static_cast<unsigned int>(iScene.getPartCount()));
+    for (size_t i=0; i<iScene.getPartCount(); ++i)
+    {
+        const Sim::PartId part = static_cast<Sim::PartId>(i);
+        PutString(header, iScene.getPartName(part));
+        PutU32(header, static_cast<unsigned int>(iScene.getPartGeometryCount(part)));
+        for (size_t j=0; j<iScene.getPartGeometryCount(part); ++j)
+        {
+            const Sim::NativeScene::Geometry& geometry = iScene.getPartGeometry(part, j);
+            Sim::Vec3 dimensions;
+            if ( Sim::NativeScene::kGeometryBox == geometry.type )
+            {
+                dimensions = geometry.halfExtents * 2.0;
+            }
+            else if ( Sim::NativeScene::kGeometryCylinder == geometry.type )
+            {
+                dimensions = Sim::Vec3(geometry.radius, geometry.height, 0.0);
+            }
+            PutU32(header, static_cast<unsigned int>(geometry.type));
+            PutVec3(header, dimensions);
+            PutVec3(header, geometry.position);
+            PutQuat(header, geometry.orientation);
+        }
+    }
+    PutU32(header, static_cast<unsigned int>(iScene.getCableCount()));
+    for (size_t i=0; i<iScene.getCableCount(); ++i)
+    {
+        const Sim::CableId cable = static_cast<Sim::CableId>(i);
+        PutString(header, iScene.getCableName(cable));
+        PutF32(header, static_cast<float>(iScene.getCable(cable).getDefinition().params.radius));
+    }
+    mStream.write(reinterpret_cast<const char*>(&header[0]), header.size());
+
+    mFrameOffsets.clear();
+    mHeaderSize = header.size();
+    mOffset = mHeaderSize;
+    return true;
+}
+
+void SceneExporter::reserve(size_t iFrameCount)
+{
+    mFrameOffsets.reserve(iFrameCount);
+}
+
+void SceneExporter::write(const Sim::NativeScene& iScene)
+{
+    if ( !isOpen() )
+    {
+        return;
+    }
+
+    mSnapshot.capture(iScene);
+    mBuilder.buildInstances(mSnapshot);
+
+    mFrame.clear();
+    PutU64(mFrame, mSnapshot.step);
+    PutF64(mFrame, mSnapshot.time);
+    for (size_t i=0; i<mSnapshot.partPositions.size(); ++i)
+    {
+        PutVec3(mFrame, mSnapshot.partPositions[i]);
+        PutQuat(mFrame, mSnapshot.partOrientations[i]);
+    }
+
+    const std::vector<float>& instances = mBuilder.getInstances();
+    for (size_t c=0; c<mSnapshot.getCableCount(); ++c)
+    {
+        const size_t begin = mBuilder.getInstanceStart(c) * CableMeshBuilder::kInstanceSize;
+        const size_t end = mBuilder.getInstanceStart(c + 1) * CableMeshBuilder::kInstanceSize;
+        PutU32(mFrame, static_cast<unsigned int>(mBuilder.getInstanceStart(c + 1) - mBuilder.getInstanceStart(c)));
+        for (size_t i=begin; i<end; ++i)
+        {
+            PutF32(mFrame, instances[i]);
+        }
+    }
+
+    mFrameOffsets.push_back(mOffset);
+    mStream.write(reinterpret_cast<const char*>(&mFrame[0]), mFrame.size());
+    mOffset += mFrame.size();
+}
+
+bool SceneExporter::close()
+{
+    if ( !isOpen() )
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> footer;
+    footer.reserve(mFrameOffsets.size() * 8 + 8 + 8 + 4);
+    for (size_t i=0; i<mFrameOffsets.size(); ++i)
+    {
+        PutU64(footer, mFrameOffsets[i]);
+    }
+    PutU64(footer, mFrameOffsets.size());
+    PutU64(footer, mOffset);
+    footer.insert(footer.end(), kIndexMagic, kIndexMagic + 4);
+    mStream.write(reinterpret_cast<const char*>(&footer[0]), footer.size());
+
+    const bool success = mStream.good();
+    mStream.close();
+    return success;
+}
@@ -0,0 +1,258 @@
+#include "SceneReader.h"
+#include "CableMeshBuilder.h"
+#include "SceneExporter.h"
+#include "TrajectoryFormat.h"
+
+#include <iostream>
+
+using namespace TrajectoryFormat;
+
+static bool GetVec3(const unsigned char*& ioData, const unsigned char* iEnd, Sim::Vec3& oValue)
+{
+    float x, y, z;
+    if ( !GetF32(ioData, iEnd, x) || !GetF32(ioData, iEnd, y) || !GetF32(ioData, iEnd, z) )
+    {
+        return false;
+    }
+    oValue = Sim::Vec3(x, y, z);
+    return true;
+}
+
+static bool GetQuat(const unsigned char*& ioData, const unsigned char* iEnd, Sim::Quat& oValue)
+{
+    float w, x, y, z;
+    if ( !GetF32(ioData, iEnd, w) || !GetF32(ioData, iEnd, x) || !GetF32(ioData, iEnd, y) || !GetF32(ioData, iEnd, z) )
+    {
+        return false;
+    }
+    oValue = Sim::Quat(w, x, y, z);
+    return true;
+}
+
+SceneReader::SceneReader()
+    : mStream()
+    , mSize(0)
+    , mBuffer()
+    , mPartNames()
+    , mPartGeometries()
+    , mCableNames()
+    , mCableRadii()
+    , mFrameOffsets()
+    , mIndexOffset(0)
+{
+}
+
+bool SceneReader::open(const std::string& iFileName)
+{
+    close();
+
+    mStream.open(iFileName.c_str(), std::ios::binary);
+    if ( !mStream || !mStream.seekg(0, std::ios::end) )
+    {
+        std::cout << "Cannot read the scene " << iFileName << std::endl;
+        close();
+        return false;
+    }
+    mSize = static_cast<unsigned long long>(mStream.tellg());
+
+    if ( !_readIndex() || !_readHeader() )
+    {
+        std::cout << iFileName << " is not a complete exported scene" << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void SceneReader::close()
+{
+    if ( mStream.is_open() )
+    {
+        mStream.close();
+    }
+    mStream.clear();
+    mSize = 0;
+    mPartNames.clear();
+    mPartGeometries.clear();
+    mCableNames.clear();
+    mCableRadii.clear();
+    mFrameOffsets.clear();
+    mIndexOffset = 0;
+}
+
+// The footer gives the index, which gives the end of the header: the
+// start of the first frame.
+bool SceneReader::_readIndex()
+{
+    if ( mSize < 8 + kFooterSize || !_readBytes(mSize - kFooterSize, kFooterSize) )
+    {
+        return false;
+    }
+
+    const unsigned char* data = &mBuffer[0];
+    const unsigned char* end = data + mBuffer.size();
+    unsigned long long frameCount = 0;
+    if ( !GetU64(data, end, frameCount) || !GetU64(data, end, mIndexOffset) || 0 != memcmp(data, SceneExporter::kIndexMagic, 4) )
+    {
+        return false;
+    }
+    if ( mIndexOffset > mSize - kFooterSize || (mSize - kFooterSize - mIndexOffset) != 8 * frameCount )
+    {
+        return false;
+    }
+
+    if ( frameCount > 0 && !_readBytes(mIndexOffset, static_cast<size_t>(8 * frameCount)) )
+    {
+        return false;
+    }
+
+    data = mBuffer.empty() ? NULL : &mBuffer[0];
+    end = data + mBuffer.size();
+    mFrameOffsets.resize(static_cast<size_t>(frameCount));
+    for (size_t i=0; i<mFrameOffsets.size(); ++i)
+    {
+        // The frames are in order, between the header and the index.
+        if ( !GetU64(data, end, mFrameOffsets[i]) || mFrameOffsets[i] > mIndexOffset || (i > 0 && mFrameOffsets[i] < mFrameOffsets[i - 1]) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SceneReader::_readHeader()
+{
+    const unsigned long long headerSize = mFrameOffsets.empty() ? mIndexOffset : mFrameOffsets[0];
+    if ( headerSize < 8 || !_readBytes(0, static_cast<size_t>(headerSize)) )
+    {
+        return false;
+    }
+
+    const unsigned char* data = &mBuffer[0];
+    const unsigned char* end = data + mBuffer.size();
+    unsigned int version = 0;
+    unsigned int partCount = 0;
+    if ( 0 != memcmp(data, SceneExporter::kMagic, 4) )
+    {
+        return false;
+    }
+    data += 4;
+    if ( !GetU32(data, end, version) || SceneExporter::kVersion != version || !GetU32(data, end, partCount) )
+    {
+        return false;
+    }
+
+    mPartNames.resize(partCount);
+    mPartGeometries.resize(partCount);
+    for (size_t i=0; i<mPartNames.size(); ++i)
+    {
+        unsigned int geometryCount = 0;
+        if ( !GetString(data, end, mPartNames[i]) || !GetU32(data, end, geometryCount) )
+        {
+            return false;
+        }
+
+        // A geometry takes 4 + 3 * 4 + 3 * 4 + 4 * 4 bytes.
+        if ( geometryCount > static_cast<size_t>(end - data) / 44 )
+        {
+            return false;
+        }
+        mPartGeometries[i].resize(geometryCount);
+        for (size_t j=0; j<geometryCount; ++j)
+        {
+            Geometry& geometry = mPartGeometries[i][j];
+            if ( !GetU32(data, end, geometry.type) || !GetVec3(data, end, geometry.dimensions)
+                 || !GetVec3(data, end, geometry.position) || !GetQuat(data, end, geometry.orientation) )
+            {
+                return false;
+            }
+        }
+    }
+
+    unsigned int cableCount = 0;
+    if ( !GetU32(data, end, cableCount) )
+    {
+        return false;
+    }
+    mCableNames.resize(cableCount);
+    mCableRadii.resize(cableCount);
+    for (size_t i=0; i<mCableNames.size(); ++i)
+    {
+        float radius = 0.0f;
+        if ( !GetString(data, end, mCableNames[i]) || !GetF32(data, end, radius) )
+        {
+            return false;
+        }
+        mCableRadii[i] = radius;
+    }
+
+    return data == end;
+}
+
+bool SceneReader::_readBytes(unsigned long long iOffset, size_t iSize)
+{
+    mBuffer.resize(iSize);
+    if ( 0 == iSize )
+    {
+        return true;
+    }
+    mStream.clear();
+    mStream.seekg(static_cast<std::streamoff>(iOffset));
+    mStream.read(reinterpret_cast<char*>(&mBuffer[0]), iSize);
+    return mStream.good();
+}
+
+bool SceneReader::readFrame(size_t iFrame, Frame& oFrame)
+{
+    if ( iFrame >= mFrameOffsets.size() )
+    {
+        return false;
+    }
+
+    const unsigned long long begin = mFrameOffsets[iFrame];
+    const unsigned long long end = iFrame + 1 < mFrameOffsets.size() ? mFrameOffsets[iFrame + 1] : mIndexOffset;
+    if ( begin == end || !_readBytes(begin, static_cast<size_t>(end - begin)) )
+    {
+        return false;
+    }
+
+    const unsigned char* data = &mBuffer[0];
+    const unsigned char* dataEnd = data + mBuffer.size();
+    unsigned long long step = 0;
+    if ( !GetU64(data, dataEnd, step) || !GetF64(data, dataEnd, oFrame.time) )
+    {
+        return false;
+    }
+    oFrame.step = static_cast<size_t>(step);
+
+    oFrame.parts.resize(mPartNames.size());
+    for (size_t i=0; i<oFrame.parts.size(); ++i)
+    {
+        if ( !GetVec3(data, dataEnd, oFrame.parts[i].position) || !GetQuat(data, dataEnd, oFrame.parts[i].orientation) )
+        {
+            return false;
+        }
+    }
+
+    oFrame.cables.resize(mCableNames.size());
+    for (size_t i=0; i<oFrame.cables.size(); ++i)
+    {
+        unsigned int sectionCount = 0;
+        if ( !GetU32(data, dataEnd, sectionCount)
+             || sectionCount > static_cast<size_t>(dataEnd - data) / (4 * CableMeshBuilder::kInstanceSize) )
+        {
+            return false;
+        }
+
+        std::vector<float>& instances = oFrame.cables[i].instances;
+        instances.resize(sectionCount * CableMeshBuilder::kInstanceSize);
+        for (size_t j=0; j<instances.size(); ++j)
+        {
+            GetF32(data, dataEnd, instances[j]);
+        }
+    }
+
+    return data == dataEnd;
+}
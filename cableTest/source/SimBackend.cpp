@@ -0,0 +1,36 @@
+#include "SimBackend.h"
+
+namespace Sim
+{
+    // CableSystems numbers the segments along the cable: winches and pulleys
+    // first get the arc wrapped on them, then comes the straight segment to the
+    // next point. For a winch, two pulleys and a load this gives:
+    // "0" arc on winch, "1" winch to pulley, "2" arc on pulley, "3" pulley to
+    // pulley, "4" arc on pulley, "5" pulley to load.
+    size_t CableDefinition::getSpanSegmentIndex(size_t iPointIndex) const
+    {
+        size_t arcCount = 0;
+        for (size_t i=0; i<=iPointIndex && i<points.size(); ++i)
+        {
+            if ( points[i].type == kCableWinch || points[i].type == kCablePulley )
+            {
+                ++arcCount;
+            }
+        }
+
+        return arcCount + iPointIndex;
+    }
+
+    const CableSegmentDefinition* CableDefinition::findSegment(size_t iSegmentIndex) const
+    {
+        for (size_t i=0; i<segments.size(); ++i)
+        {
+            if ( segments[i].index == iSegmentIndex )
+            {
+                return &segments[i];
+            }
+        }
+
+        return NULL;
+    }
+}
@@ -0,0 +1,141 @@
+#include "StepProfiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+StepProfiler::ScopedPhase::ScopedPhase(StepProfiler* iProfiler, Phase iPhase)
+    : mProfiler(iProfiler)
+    , mPhase(iPhase)
+{
+    if ( NULL != mProfiler )
+    {
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+StepProfiler::ScopedPhase::~ScopedPhase()
+{
+    if ( NULL != mProfiler )
+    {
+        mProfiler->addPhaseTime(mPhase, std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count());
+    }
+}
+
+StepProfiler::StepProfiler(size_t iCapacity)
+    : mRing(iCapacity)
+    , mStepCount(0)
+{
+    mCurrent.step = 0;
+    mLastSample.step = 0;
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        mCurrent.phases[i] = 0.0;
+        mLastSample.phases[i] = 0.0;
+        mTotals[i] = 0.0;
+        mMaxima[i] = 0.0;
+    }
+}
+
+void StepProfiler::beginStep()
+{
+    mCurrent.step = mStepCount;
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        mCurrent.phases[i] = 0.0;
+    }
+}
+
+void StepProfiler::addPhaseTime(Phase iPhase, double iSeconds)
+{
+    mCurrent.phases[iPhase] += iSeconds;
+}
+
+void StepProfiler::endStep()
+{
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        mTotals[i] += mCurrent.phases[i];
+        if ( mCurrent.phases[i] > mMaxima[i] )
+        {
+            mMaxima[i] = mCurrent.phases[i];
+        }
+    }
+    mLastSample = mCurrent;
+    ++mStepCount;
+
+    mRing.push(mCurrent);
+}
+
+bool StepProfiler::pop(Sample& oSample)
+{
+    return mRing.pop(oSample);
+}
+
+const char* StepProfiler::getPhaseName(Phase iPhase)
+{
+    switch ( iPhase )
+    {
+    case kPhasePreUpdate:
+        return "pre_update";
+    case kPhaseCollision:
+        return "collision";
+    case kPhaseConstraintSolve:
+        return "constraint_solve";
+    case kPhaseCableUpdate:
+        return "cable_update";
+    case kPhaseGraphicsSync:
+        return "graphics_sync";
+    default:
+        return "unknown";
+    }
+}
+
+bool StepProfiler::writeCsv(const std::string& iFileName)
+{
+    std::ofstream stream(iFileName.c_str());
+    if ( !stream )
+    {
+        std::cout << "Cannot write the step profile to " << iFileName << std::endl;
+        return false;
+    }
+
+    stream << "step";
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        stream << "," << getPhaseName(static_cast<Phase>(i)) << "_s";
+    }
+    stream << std::endl;
+
+    stream << std::setprecision(9);
+    Sample sample;
+    while ( pop(sample) )
+    {
+        stream << sample.step;
+        for (int i=0; i<kPhaseCount; ++i)
+        {
+            stream << "," << sample.phases[i];
+        }
+        stream << "\n";
+    }
+
+    stream << "# steps = " << mStepCount << ", dropped samples = " << getDroppedCount() << "\n";
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        stream << "# " << getPhaseName(static_cast<Phase>(i)) << ": total_s = " << mTotals[i] << ", max_s = " << mMaxima[i] << "\n";
+    }
+
+    return stream.good();
+}
+
+void StepProfiler::printSummary() const
+{
+    std::cout << "Step phases over " << mStepCount << " steps (ms):" << std::endl;
+    for (int i=0; i<kPhaseCount; ++i)
+    {
+        const double mean = mStepCount > 0 ? mTotals[i] / mStepCount : 0.0;
+        std::cout << "  " << getPhaseName(static_cast<Phase>(i))
+                  << ": mean = " << mean * 1e3
+                  << ", max = " << mMaxima[i] * 1e3 << std::endl;
+    }
+}
@@ -0,0 +1,131 @@
+#include "StepStatistics.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Return the value at the given percentile of an already sorted array using
+// the nearest-rank method.
+static double GetPercentile(const std::vector<double>& sorted, double percentile)
+{
+    if ( sorted.empty() )
+    {
+        return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(percentile / 100.0 * sorted.size() + 0.5);
+    if ( rank > 0 )
+    {
+        --rank;
+    }
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+StepStatistics::StepStatistics()
+    : mStepTimes()
+{
+}
+
+void StepStatistics::reserve(size_t iStepCount)
+{
+    mStepTimes.reserve(iStepCount);
+}
+
+void StepStatistics::addStep(double iSeconds)
+{
+    mStepTimes.push_back(iSeconds);
+}
+
+StepStatistics::Summary StepStatistics::computeSummary() const
+{
+    Summary summary;
+    summary.stepCount = mStepTimes.size();
+    summary.totalTime = 0.0;
+    summary.mean = 0.0;
+    summary.p50 = 0.0;
+    summary.p90 = 0.0;
+    summary.p99 = 0.0;
+    summary.max = 0.0;
+
+    if ( mStepTimes.empty() )
+    {
+        return summary;
+    }
+
+    // The percentiles need a sorted copy; the recorded order is kept intact.
+    std::vector<double> sorted(mStepTimes);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t i=0; i<sorted.size(); ++i)
+    {
+        summary.totalTime += sorted[i];
+    }
+    summary.mean = summary.totalTime / sorted.size();
+    summary.p50 = GetPercentile(sorted, 50.0);
+    summary.p90 = GetPercentile(sorted, 90.0);
+    summary.p99 = GetPercentile(sorted, 99.0);
+    summary.max = sorted.back();
+
+    return summary;
+}
+
+bool StepStatistics::writeSummary(const std::string& iFileName, const std::string& iSceneName) const
+{
+    std::ofstream file(iFileName.c_str());
+    if ( !file )
+    {
+        std::cout << "Cannot open the step statistics file " << iFileName << std::endl;
+        return false;
+    }
+
+    const Summary summary = computeSummary();
+    const std::string csvExtension(".csv");
+    const bool isCsv = iFileName.size() >= csvExtension.size()
+        && iFileName.compare(iFileName.size() - csvExtension.size(), csvExtension.size(), csvExtension) == 0;
+
+    return isCsv ? writeCsv(file, iSceneName, summary) : writeJson(file, iSceneName, summary);
+}
+
+void StepStatistics::printSummary(const std::string& iSceneName) const
+{
+    const Summary summary = computeSummary();
+    std::cout << "Scene " << iSceneName << ": " << summary.stepCount << " steps in " << summary.totalTime << " s" << std::endl;
+    std::cout << "  step time (ms): mean = " << summary.mean * 1000.0
+              << ", p50 = " << summary.p50 * 1000.0
+              << ", p99 = " << summary.p99 * 1000.0
+              << ", max = " << summary.max * 1000.0 << std::endl;
+}
+
+bool StepStatistics::writeJson(std::ostream& oStream, const std::string& iSceneName, const Summary& iSummary) const
+{
+    oStream << std::setprecision(9);
+    oStream << "{\n";
+    oStream << "  \"scene\": \"" << iSceneName << "\",\n";
+    oStream << "  \"steps\": " << iSummary.stepCount << ",\n";
+    oStream << "  \"total_s\": " << iSummary.totalTime << ",\n";
+    oStream << "  \"step_time_s\": {\n";
+    oStream << "    \"mean\": " << iSummary.mean << ",\n";
+    oStream << "    \"p50\": " << iSummary.p50 << ",\n";
+    oStream << "    \"p99\": " << iSummary.p99 << ",\n";
+    oStream << "    \"max\": " << iSummary.max << "\n";
+    oStream << "  }\n";
+    oStream << "}\n";
+
+    return !oStream.fail();
+}
+
+bool StepStatistics::writeCsv(std::ostream& oStream, const std::string& iSceneName, const Summary& iSummary) const
+{
+    oStream << std::setprecision(9);
+    oStream << "scene,steps,total_s,mean_s,p50_s,p99_s,max_s\n";
+    oStream << iSceneName << ','
+            << iSummary.stepCount << ','
+            << iSummary.totalTime << ','
+            << iSummary.mean << ','
+            << iSummary.p50 << ','
+            << iSummary.p99 << ','
+            << iSummary.max << '\n';
+
+    return !oStream.fail();
+}
@@ -0,0 +1,319 @@
+#include "StressScene.h"
+#include "MyCrane.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using Sim::Pose;
+using Sim::Vec3;
+
+static const double sHalfPi = 1.57079632679489661923;
+
+// Distance between the cables of a crane along the winch axis, and size of the loads.
+static const double sCableSpacing = 1.5;
+static const double sLoadSize = 1.0;
+static const double sIdlerRadius = 0.5;
+
+StressScene::Settings::Settings()
+    : craneCount(4)
+    , cablesPerCrane(1)
+    , cableLength(40.0)
+    , maxSectionLength(1.0)
+    , pulleyCount(2)
+    , layout("grid")
+    , spacing(0.0)
+    , seed(1)
+    , loadMass(400.0)
+    , axialStiffness(10000.0)
+    , axialDamping(2000.0)
+    , cableCollision(false)
+    , adaptiveSections(false)
+    , implicitCables(false)
+{
+}
+
+StressScene::StressScene(Sim::IScene& iScene, const Settings& iSettings)
+    : mScene(iScene)
+    , mSettings(iSettings)
+    , mOrigins()
+    , mCranes()
+    , mCables()
+    , mCranePulleyCount(0)
+    , mIdlers()
+    , mLoad()
+    , mMin()
+    , mMax()
+    , mRandomState(0)
+{
+    // Splitmix the seed, the xorshift state must not be zero.
+    mRandomState = static_cast<unsigned long long>(mSettings.seed) + 0x9E3779B97F4A7C15ULL;
+    mRandomState = (mRandomState ^ (mRandomState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    mRandomState = (mRandomState ^ (mRandomState >> 27)) * 0x94D049BB133111EBULL;
+    mRandomState = (mRandomState ^ (mRandomState >> 31)) | 1;
+
+    if ( 0 == mSettings.craneCount )
+    {
+        return;
+    }
+    if ( 0 == mSettings.pulleyCount )
+    {
+        std::cout << "The cables of the stress scene go over the tip pulley at least" << std::endl;
+        mSettings.pulleyCount = 1;
+    }
+
+    // The rigging is planned on the first crane, at the origin of the yard.
+    mOrigins.push_back(Vec3());
+    mCranes.push_back(new MyCrane(mScene, mOrigins[0]));
+    _planRigging();
+
+    _layOut();
+    for (size_t i=1; i<mOrigins.size(); ++i)
+    {
+        mCranes.push_back(new MyCrane(mScene, mOrigins[i]));
+    }
+    for (size_t i=0; i<mCranes.size(); ++i)
+    {
+        _createRigging(i);
+    }
+    _createGround();
+}
+
+StressScene::~StressScene()
+{
+    for (size_t i=0; i<mCranes.size(); ++i)
+    {
+        delete mCranes[i];
+    }
+}
+
+std::string StressScene::getDescription() const
+{
+    std::ostringstream description;
+    description << mCranes.size() << " cranes x " << mSettings.cablesPerCrane << " cables, "
+                << mSettings.pulleyCount << " pulleys, " << mSettings.cableLength << " m, " << mSettings.layout;
+    return description.str();
+}
+
+// The cable goes from the winch over the tip pulley (and the mid pulley
+// before it when there are two pulleys or more), then over the idlers laid
+// out in front of the tip, and ends on the load. The length left after the
+// crane pulleys is shared between the idler spans, and the last span drops
+// to the load on the ground, or hangs it in the air when it is shorter
+// than the height of the tip.
+void StressScene::_planRigging()
+{
+    const Sim::AssemblyId assembly = mScene.findAssembly(mCranes[0]->getMechanism(), MyCrane::sCraneAssemblyName);
+    const Vec3 winch = mScene.getPartPosition(mScene.findPart(assembly, MyCrane::sWinchName));
+    const Vec3 midPulley = mScene.getPartPosition(mScene.findPart(assembly, MyCrane::sMidPulleyName));
+    const Vec3 tip = mScene.getPartPosition(mScene.findPart(assembly, MyCrane::sTipPulleyName));
+
+    mCranePulleyCount = std::min<size_t>(mSettings.pulleyCount, 2);
+    double craneLength = Sim::length(tip - winch);
+    if ( 2 == mCranePulleyCount )
+    {
+        craneLength = Sim::length(midPulley - winch) + Sim::length(tip - midPulley);
+    }
+
+    double remaining = mSettings.cableLength - craneLength;
+    if ( remaining < 1.0 )
+    {
+        std::cout << "The cables of the stress scene need at least " << craneLength + 1.0 << " m, they are lengthened" << std::endl;
+        remaining = 1.0;
+    }
+
+    // The top of a load resting on the ground.
+    const double height = tip.z - sLoadSize;
+    const size_t idlerCount = mSettings.pulleyCount - mCranePulleyCount;
+    double span = 0.0;
+    if ( idlerCount > 0 )
+    {
+        span = remaining > height + idlerCount ? (remaining - height) / idlerCount : remaining / (idlerCount + 1);
+    }
+
+    mIdlers.clear();
+    Vec3 last = tip;
+    for (size_t k=0; k<idlerCount; ++k)
+    {
+        last += Vec3(0.0, span, 0.0);
+        mIdlers.push_back(last);
+    }
+
+    const double lastSpan = remaining - idlerCount * span;
+    const double drop = std::min(lastSpan, height);
+    const double reach = std::sqrt(std::max(lastSpan * lastSpan - drop * drop, 0.0));
+    mLoad = last + Vec3(0.0, reach, -drop - 0.5 * sLoadSize);
+
+    // The base of the crane is 4 m wide and long.
+    const double halfWidth = std::max(2.0, 0.5 * sCableSpacing * mSettings.cablesPerCrane);
+    mMin = Vec3(-halfWidth, -2.0, 0.0);
+    mMax = Vec3(halfWidth, std::max(tip.y, mLoad.y) + sLoadSize, tip.z);
+}
+
+// The grid is as square as possible. The random layout draws the cranes in
+// a square about twice the area of the grid, and draws again the cranes
+// whose footprint overlaps one placed before; the square grows when the
+// draws keep failing.
+void StressScene::_layOut()
+{
+    const double margin = 4.0;
+    const double pitchX = mSettings.spacing > 0.0 ? mSettings.spacing : mMax.x - mMin.x + margin;
+    const double pitchY = mSettings.spacing > 0.0 ? mSettings.spacing : mMax.y - mMin.y + margin;
+    const size_t columnCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(mSettings.craneCount))));
+
+    if ( mSettings.layout != "random" )
+    {
+        if ( mSettings.layout != "grid" )
+        {
+            std::cout << "Unknown layout " << mSettings.layout << ", the cranes are laid out on a grid" << std::endl;
+        }
+        for (size_t i=1; i<mSettings.craneCount; ++i)
+        {
+            mOrigins.push_back(Vec3(pitchX * (i % columnCount), pitchY * (i / columnCount), 0.0));
+        }
+        return;
+    }
+
+    double sizeX = 1.5 * pitchX * columnCount;
+    double sizeY = 1.5 * pitchY * columnCount;
+    size_t failedCount = 0;
+    while ( mOrigins.size() < mSettings.craneCount )
+    {
+        const Vec3 origin((_random() - 0.5) * sizeX, (_random() - 0.5) * sizeY, 0.0);
+        bool overlaps = false;
+        for (size_t i=0; i<mOrigins.size() && !overlaps; ++i)
+        {
+            overlaps = std::fabs(origin.x - mOrigins[i].x) < pitchX && std::fabs(origin.y - mOrigins[i].y) < pitchY;
+        }
+
+        if ( !overlaps )
+        {
+            mOrigins.push_back(origin);
+            failedCount = 0;
+        }
+        else if ( ++failedCount == 100 )
+        {
+            sizeX *= 1.1;
+            sizeY *= 1.1;
+            failedCount = 0;
+        }
+    }
+}
+
+void StressScene::_createGround()
+{
+    Vec3 lower = mOrigins[0];
+    Vec3 upper = mOrigins[0];
+    for (size_t i=1; i<mOrigins.size(); ++i)
+    {
+        lower = Vec3(std::min(lower.x, mOrigins[i].x), std::min(lower.y, mOrigins[i].y), 0.0);
+        upper = Vec3(std::max(upper.x, mOrigins[i].x), std::max(upper.y, mOrigins[i].y), 0.0);
+    }
+    lower += mMin - Vec3(10.0, 10.0, 0.0);
+    upper += mMax + Vec3(10.0, 10.0, 0.0);
+
+    // The top of the ground is at z=0, like the one of ExCableSystem.
+    const Sim::MechanismId mechanism = mScene.createMechanism("StressGround");
+    const Sim::AssemblyId assembly = mScene.createAssembly(mechanism, "groundAssembly");
+    const Vec3 center = (lower + upper) * 0.5;
+    const Sim::PartId ground = mScene.createPart(assembly, Sim::PartDefinition("groundPart", Sim::kPartStatic, Vec3(center.x, center.y, -0.1)));
+    mScene.addBox(ground, Vec3(upper.x - lower.x, upper.y - lower.y, 0.2));
+}
+
+// The idlers and the loads of a crane are in a mechanism of their own, so
+// that the loads collide with the crane.
+void StressScene::_createRigging(size_t iCrane)
+{
+    const Vec3& origin = mOrigins[iCrane];
+    const Sim::MechanismId crane = mCranes[iCrane]->getMechanism();
+    const Sim::AssemblyId craneAssembly = mScene.findAssembly(crane, MyCrane::sCraneAssemblyName);
+
+    std::ostringstream rigging;
+    rigging << "Rigging_" << iCrane;
+    const Sim::MechanismId mechanism = mScene.createMechanism(rigging.str());
+
+    // The idlers are as wide as the cables of the crane, their axis along x.
+    std::vector<Sim::PartId> idlers;
+    if ( !mIdlers.empty() )
+    {
+        const Sim::AssemblyId assembly = mScene.createAssembly(mechanism, "IdlerAssembly");
+        const Pose axis(Vec3(), Vec3(0.0, sHalfPi, 0.0));
+        for (size_t k=0; k<mIdlers.size(); ++k)
+        {
+            std::ostringstream name;
+            name << "Idler_" << k;
+            idlers.push_back(mScene.createPart(assembly, Sim::PartDefinition(name.str(), Sim::kPartStatic, origin + mIdlers[k])));
+            mScene.addCylinder(idlers.back(), sIdlerRadius, sCableSpacing * mSettings.cablesPerCrane, axis);
+        }
+    }
+
+    const Sim::AssemblyId loadAssembly = mScene.createAssembly(mechanism, "LoadAssembly");
+    for (size_t j=0; j<mSettings.cablesPerCrane; ++j)
+    {
+        const double x = (j - 0.5 * (mSettings.cablesPerCrane - 1.0)) * sCableSpacing;
+
+        std::ostringstream name;
+        name << "Load_" << j;
+        const Sim::PartId load = mScene.createPart(loadAssembly, Sim::PartDefinition(name.str(), Sim::kPartDynamic, origin + mLoad + Vec3(x, 0.0, 0.0), mSettings.loadMass));
+        mScene.addBox(load, Vec3(sLoadSize, sLoadSize, sLoadSize));
+
+        std::ostringstream cableName;
+        cableName << "Cable_" << iCrane << "_" << j;
+        Sim::CableDefinition definition;
+        definition.name = cableName.str();
+        // Each cable has its own point on the winch and the pulleys, along
+        // their axis, which is the x axis of their part.
+        const Vec3 lane(x, 0.0, 0.0);
+        definition.points.push_back(Sim::CablePointDefinition(Sim::kCableWinch, mScene.findPart(craneAssembly, MyCrane::sWinchName), lane));
+        if ( 2 == mCranePulleyCount )
+        {
+            // Same wrapping as the cable of ExCableSystem.
+            Sim::CablePointDefinition midPulley(Sim::kCablePulley, mScene.findPart(craneAssembly, MyCrane::sMidPulleyName), lane);
+            midPulley.inverseWrapping = true;
+            definition.points.push_back(midPulley);
+        }
+        definition.points.push_back(Sim::CablePointDefinition(Sim::kCablePulley, mScene.findPart(craneAssembly, MyCrane::sTipPulleyName), lane));
+        for (size_t k=0; k<idlers.size(); ++k)
+        {
+            definition.points.push_back(Sim::CablePointDefinition(Sim::kCablePulley, idlers[k], lane));
+        }
+        definition.points.push_back(Sim::CablePointDefinition(Sim::kCableAttachmentPoint, load, Vec3(0.0, 0.0, 0.5 * sLoadSize)));
+
+        // Every span is flexible.
+        for (size_t p=0; p+1<definition.points.size(); ++p)
+        {
+            Sim::CableSegmentDefinition segment;
+            segment.index = definition.getSpanSegmentIndex(p);
+            segment.flexible = true;
+            segment.maxSectionLength = mSettings.maxSectionLength;
+            segment.minSectionLength = std::min(0.2, 0.2 * mSettings.maxSectionLength);
+            segment.adaptive = mSettings.adaptiveSections;
+            definition.segments.push_back(segment);
+        }
+
+        definition.params.axialStiffness = mSettings.axialStiffness;
+        definition.params.axialDamping = mSettings.axialDamping;
+        definition.params.implicitAxial = mSettings.implicitCables;
+        if ( mSettings.cableCollision )
+        {
+            definition.params.collisionGeometryType = 2;
+        }
+
+        const Sim::CableId cable = mScene.createCable(crane, definition);
+        mCables.push_back(cable);
+
+        std::ostringstream graphicsName;
+        graphicsName << "CableGraphics_" << iCrane << "_" << j;
+        mScene.addCableGraphics(crane, cable, graphicsName.str());
+    }
+}
+
+// xorshift64*
+double StressScene::_random()
+{
+    mRandomState ^= mRandomState >> 12;
+    mRandomState ^= mRandomState << 25;
+    mRandomState ^= mRandomState >> 27;
+    return static_cast<double>((mRandomState * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
@@ -0,0 +1,182 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t iThreadCount)
+    : mQueues()
+    , mThreads()
+    , mMutex()
+    , mWakeUp()
+    , mDone()
+    , mTask(NULL)
+    , mBatch(0)
+    , mPendingCount(0)
+    , mActiveCount(0)
+    , mError()
+    , mStop(false)
+{
+    if ( 0 == iThreadCount )
+    {
+        iThreadCount = std::thread::hardware_concurrency();
+    }
+    if ( 0 == iThreadCount )
+    {
+        iThreadCount = 1;
+    }
+
+    for (size_t i=0; i<iThreadCount; ++i)
+    {
+        mQueues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    // Worker 0 is the thread calling run().
+    for (size_t i=1; i<iThreadCount; ++i)
+    {
+        mThreads.push_back(std::thread(&ThreadPool::_workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWakeUp.notify_all();
+
+    for (size_t i=0; i<mThreads.size(); ++i)
+    {
+        mThreads[i].join();
+    }
+}
+
+void ThreadPool::run(size_t iTaskCount, const Task& iTask)
+{
+    if ( 0 == iTaskCount )
+    {
+        return;
+    }
+
+    // The tasks are dealt with the lock held, so that a worker sees the
+    // task of the batch as soon as it finds a task in a queue.
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &iTask;
+        mPendingCount = iTaskCount;
+        mError = std::exception_ptr();
+
+        for (size_t i=0; i<iTaskCount; ++i)
+        {
+            Queue& queue = *mQueues[i % mQueues.size()];
+            std::lock_guard<std::mutex> queueLock(queue.mutex);
+            queue.tasks.push_back(i);
+        }
+        ++mBatch;
+    }
+    mWakeUp.notify_all();
+
+    _work(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // Also wait for the workers to leave _work(), so that none of them
+        // is still looking for tasks when the next batch is dealt.
+        while ( mPendingCount > 0 || mActiveCount > 0 )
+        {
+            mDone.wait(lock);
+        }
+        mTask = NULL;
+        error = mError;
+    }
+
+    if ( error )
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::_workerLoop(size_t iWorker)
+{
+    size_t batch = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while ( !mStop && batch == mBatch )
+            {
+                mWakeUp.wait(lock);
+            }
+            if ( mStop )
+            {
+                return;
+            }
+            batch = mBatch;
+            ++mActiveCount;
+        }
+
+        _work(iWorker);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if ( 0 == --mActiveCount )
+        {
+            mDone.notify_all();
+        }
+    }
+}
+
+void ThreadPool::_work(size_t iWorker)
+{
+    size_t task = 0;
+    while ( _pop(iWorker, task) || _steal(iWorker, task) )
+    {
+        std::exception_ptr error;
+        try
+        {
+            (*mTask)(task, iWorker);
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if ( error && !mError )
+        {
+            mError = error;
+        }
+        if ( 0 == --mPendingCount )
+        {
+            mDone.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::_pop(size_t iWorker, size_t& oTask)
+{
+    Queue& queue = *mQueues[iWorker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if ( queue.tasks.empty() )
+    {
+        return false;
+    }
+
+    oTask = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::_steal(size_t iWorker, size_t& oTask)
+{
+    for (size_t i=1; i<mQueues.size(); ++i)
+    {
+        Queue& queue = *mQueues[(iWorker + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if ( !queue.tasks.empty() )
+        {
+            oTask = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
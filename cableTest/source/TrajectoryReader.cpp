@@ -0,0 +1,298 @@
+#include "TrajectoryReader.h"
+#include "TrajectoryFormat.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TrajectoryFormat;
+
+TrajectoryReader::TrajectoryReader()
+    : mData(NULL)
+    , mSize(0)
+#ifdef _WIN32
+    , mFile(INVALID_HANDLE_VALUE)
+    , mMapping(NULL)
+#endif
+    , mKeyFrameInterval(1)
+    , mPositionQuantum(0.0)
+    , mOrientationQuantum(0.0)
+    , mVelocityQuantum(0.0)
+    , mTensionQuantum(0.0)
+    , mPartNames()
+    , mCableNames()
+    , mFrameCount(0)
+    , mIndex(NULL)
+{
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+    close();
+}
+
+bool TrajectoryReader::open(const std::string& iFileName)
+{
+    close();
+
+#ifdef _WIN32
+    mFile = CreateFileA(iFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if ( INVALID_HANDLE_VALUE == mFile || !GetFileSizeEx(mFile, &size) || 0 == size.QuadPart )
+    {
+        std::cout << "Cannot read the trajectory " << iFileName << std::endl;
+        close();
+        return false;
+    }
+    mSize = static_cast<size_t>(size.QuadPart);
+    mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    mData = NULL != mMapping ? static_cast<const unsigned char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : NULL;
+#else
+    const int file = ::open(iFileName.c_str(), O_RDONLY);
+    struct stat status;
+    if ( file < 0 || fstat(file, &status) != 0 || 0 == status.st_size )
+    {
+        std::cout << "Cannot read the trajectory " << iFileName << std::endl;
+        if ( file >= 0 )
+        {
+            ::close(file);
+        }
+        return false;
+    }
+    mSize = static_cast<size_t>(status.st_size);
+    void* data = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps the file alive.
+    ::close(file);
+    mData = MAP_FAILED != data ? static_cast<const unsigned char*>(data) : NULL;
+#endif
+
+    if ( NULL == mData )
+    {
+        std::cout << "Cannot map the trajectory " << iFileName << std::endl;
+        close();
+        return false;
+    }
+
+    if ( !_readHeader() )
+    {
+        std::cout << iFileName << " is not a complete trajectory file" << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void TrajectoryReader::close()
+{
+#ifdef _WIN32
+    if ( NULL != mData )
+    {
+        UnmapViewOfFile(mData);
+    }
+    if ( NULL != mMapping )
+    {
+        CloseHandle(mMapping);
+    }
+    if ( INVALID_HANDLE_VALUE != mFile )
+    {
+        CloseHandle(mFile);
+    }
+    mMapping = NULL;
+    mFile = INVALID_HANDLE_VALUE;
+#else
+    if ( NULL != mData )
+    {
+        munmap(const_cast<unsigned char*>(mData), mSize);
+    }
+#endif
+
+    mData = NULL;
+    mSize = 0;
+    mPartNames.clear();
+    mCableNames.clear();
+    mFrameCount = 0;
+    mIndex = NULL;
+}
+
+bool TrajectoryReader::_readHeader()
+{
+    const unsigned char* end = mData + mSize;
+    if ( mSize < 8 + kFooterSize || 0 != memcmp(mData, kMagic, 4) || 0 != memcmp(end - 4, kIndexMagic, 4) )
+    {
+        return false;
+    }
+
+    const unsigned char* data = mData + 4;
+    unsigned int version = 0;
+    unsigned int partCount = 0;
+    unsigned int cableCount = 0;
+    if ( !GetU32(data, end, version) || kVersion != version
+        || !GetU32(data, end, mKeyFrameInterval) || 0 == mKeyFrameInterval
+        || !GetF64(data, end, mPositionQuantum)
+        || !GetF64(data, end, mOrientationQuantum)
+        || !GetF64(data, end, mVelocityQuantum)
+        || !GetF64(data, end, mTensionQuantum)
+        || !GetU32(data, end, partCount) )
+    {
+        return false;
+    }
+
+    mPartNames.resize(partCount);
+    for (size_t i=0; i<mPartNames.size(); ++i)
+    {
+        if ( !GetString(data, end, mPartNames[i]) )
+        {
+            return false;
+        }
+    }
+
+    if ( !GetU32(data, end, cableCount) )
+    {
+        return false;
+    }
+    mCableNames.resize(cableCount);
+    for (size_t i=0; i<mCableNames.size(); ++i)
+    {
+        if ( !GetString(data, end, mCableNames[i]) )
+        {
+            return false;
+        }
+    }
+
+    const unsigned char* footer = end - kFooterSize;
+    unsigned long long frameCount = 0;
+    unsigned long long indexOffset = 0;
+    if ( !GetU64(footer, end, frameCount) || !GetU64(footer, end, indexOffset) )
+    {
+        return false;
+    }
+    if ( indexOffset > mSize - kFooterSize || (mSize - kFooterSize - indexOffset) / 8 != frameCount )
+    {
+        return false;
+    }
+
+    mFrameCount = static_cast<size_t>(frameCount);
+    mIndex = mData + indexOffset;
+    return true;
+}
+
+const unsigned char* TrajectoryReader::_getFrameData(size_t iFrame) const
+{
+    const unsigned char* entry = mIndex + 8 * iFrame;
+    unsigned long long offset = 0;
+    GetU64(entry, mIndex + 8 * mFrameCount, offset);
+    return offset < static_cast<unsigned long long>(mIndex - mData) ? mData + offset : NULL;
+}
+
+bool TrajectoryReader::_readParts(const unsigned char*& ioData, bool iKeyFrame, std::vector<long long>& ioValues) const
+{
+    unsigned long long step = 0;
+    double time = 0.0;
+    if ( !GetVarint(ioData, mIndex, step) || !GetF64(ioData, mIndex, time) )
+    {
+        return false;
+    }
+
+    for (size_t i=0; i<ioValues.size(); ++i)
+    {
+        long long value = 0;
+        if ( !GetSigned(ioData, mIndex, value) )
+        {
+            return false;
+        }
+        ioValues[i] = iKeyFrame ? value : ioValues[i] + value;
+    }
+
+    return true;
+}
+
+bool TrajectoryReader::readFrame(size_t iFrame, Frame& oFrame) const
+{
+    if ( iFrame >= mFrameCount )
+    {
+        return false;
+    }
+
+    // Accumulate the part deltas from the key frame.
+    std::vector<long long> values(mPartNames.size() * kPartValueCount, 0);
+    const size_t keyFrame = iFrame - iFrame % mKeyFrameInterval;
+    for (size_t i=keyFrame; i<iFrame; ++i)
+    {
+        const unsigned char* data = _getFrameData(i);
+        if ( NULL == data || !_readParts(data, i == keyFrame, values) )
+        {
+            return false;
+        }
+    }
+
+    // The step and time are read again by _readParts(), which skips them.
+    const unsigned char* data = _getFrameData(iFrame);
+    const unsigned char* header = data;
+    unsigned long long step = 0;
+    if ( NULL == data || !GetVarint(header, mIndex, step) || !GetF64(header, mIndex, oFrame.time) || !_readParts(data, iFrame == keyFrame, values) )
+    {
+        return false;
+    }
+    oFrame.step = static_cast<size_t>(step);
+
+    oFrame.parts.resize(mPartNames.size());
+    for (size_t i=0; i<oFrame.parts.size(); ++i)
+    {
+        const long long* value = &values[i * kPartValueCount];
+        PartState& part = oFrame.parts[i];
+        part.position = Sim::Vec3(value[0], value[1], value[2]) * mPositionQuantum;
+        part.orientation = Sim::Quat(value[3] * mOrientationQuantum, value[4] * mOrientationQuantum, value[5] * mOrientationQuantum, value[6] * mOrientationQuantum);
+        part.linearVelocity = Sim::Vec3(value[7], value[8], value[9]) * mVelocityQuantum;
+        part.angularVelocity = Sim::Vec3(value[10], value[11], value[12]) * mVelocityQuantum;
+    }
+
+    oFrame.cables.resize(mCableNames.size());
+    for (size_t i=0; i<oFrame.cables.size(); ++i)
+    {
+        CableState& cable = oFrame.cables[i];
+        unsigned long long nodeCount = 0;
+        unsigned long long broken = 0;
+        if ( !GetVarint(data, mIndex, nodeCount) || !GetVarint(data, mIndex, broken) || nodeCount > static_cast<unsigned long long>(mIndex - data) )
+        {
+            return false;
+        }
+        cable.broken = 0 != broken;
+
+        cable.nodes.resize(static_cast<size_t>(nodeCount));
+        long long position[3] = { 0, 0, 0 };
+        for (size_t j=0; j<cable.nodes.size(); ++j)
+        {
+            for (int k=0; k<3; ++k)
+            {
+                long long delta = 0;
+                if ( !GetSigned(data, mIndex, delta) )
+                {
+                    return false;
+                }
+                position[k] += delta;
+            }
+            cable.nodes[j] = Sim::Vec3(position[0], position[1], position[2]) * mPositionQuantum;
+        }
+
+        cable.tensions.resize(cable.nodes.empty() ? 0 : cable.nodes.size() - 1);
+        for (size_t j=0; j<cable.tensions.size(); ++j)
+        {
+            long long tension = 0;
+            if ( !GetSigned(data, mIndex, tension) )
+            {
+                return false;
+            }
+            cable.tensions[j] = tension * mTensionQuantum;
+        }
+    }
+
+    return true;
+}
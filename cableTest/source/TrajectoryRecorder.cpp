@@ -0,0 +1,277 @@
+#include "TrajectoryRecorder.h"
+#include "NativeScene.h"
+#include "TrajectoryFormat.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace TrajectoryFormat;
+
+// Size from which the encoded frames are handed to the writer thread.
+static const size_t sChunkSize = 64 * 1024;
+
+static long long Quantize(double iValue, double iQuantum)
+{
+    return static_cast<long long>(floor(iValue / iQuantum + 0.5));
+}
+
+TrajectoryRecorder::Settings::Settings()
+    : positionQuantum(1e-4)
+    , orientationQuantum(1e-6)
+    , velocityQuantum(1e-4)
+    , tensionQuantum(1e-2)
+    , keyFrameInterval(60)
+{
+}
+
+TrajectoryRecorder::TrajectoryRecorder()
+    : mSettings()
+    , mFrameOffsets()
+    , mOffset(0)
+    , mHeaderSize(0)
+    , mPartValues()
+    , mChunk()
+    , mMutex()
+    , mWakeUp()
+    , mPendingChunks()
+    , mFreeChunks()
+    , mClosing(false)
+    , mWriteFailed(false)
+    , mStream()
+    , mThread()
+{
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    close();
+}
+
+bool TrajectoryRecorder::open(const std::string& iFileName, const Sim::NativeScene& iScene, const Settings& iSettings)
+{
+    close();
+
+    mStream.open(iFileName.c_str(), std::ios::binary | std::ios::trunc);
+    if ( !mStream )
+    {
+        std::cout << "Cannot write the trajectory to " << iFileName << std::endl;
+        return false;
+    }
+
+    mSettings = iSettings;
+    if ( 0 == mSettings.keyFrameInterval )
+    {
+        mSettings.keyFrameInterval = 1;
+    }
+
+    std::vector<unsigned char> header;
+    header.insert(header.end(), kMagic, kMagic + 4);
+    PutU32(header, kVersion);
+    PutU32(header, mSettings.keyFrameInterval);
+    PutF64(header, mSettings.positionQuantum);
+    PutF64(header, mSettings.orientationQuantum);
+    PutF64(header, mSettings.velocityQuantum);
+    PutF64(header, mSettings.tensionQuantum);
+    PutU32(header, static_cast<unsigned int>(iScene.getPartCount()));
+    for (size_t i=0; i<iScene.getPartCount(); ++i)
+    {
+        PutString(header, iScene.getPartName(static_cast<Sim::PartId>(i)));
+    }
+    PutU32(header, static_cast<unsigned int>(iScene.getCableCount()));
+    for (size_t i=0; i<iScene.getCableCount(); ++i)
+    {
+        PutString(header, iScene.getCableName(static_cast<Sim::CableId>(i)));
+    }
+    mStream.write(reinterpret_cast<const char*>(&header[0]), header.size());
+
+    mFrameOffsets.clear();
+    mHeaderSize = header.size();
+    mOffset = mHeaderSize;
+    mPartValues.assign(iScene.getPartCount() * kPartValueCount, 0);
+    mChunk.clear();
+    mChunk.reserve(2 * sChunkSize);
+    mClosing = false;
+    mWriteFailed = !mStream.good();
+
+    mThread = std::thread(&TrajectoryRecorder::_writerLoop, this);
+    return true;
+}
+
+void TrajectoryRecorder::record(const Sim::NativeScene& iScene)
+{
+    if ( !isOpen() )
+    {
+        return;
+    }
+
+    const bool keyFrame = 0 == mFrameOffsets.size() % mSettings.keyFrameInterval;
+    const size_t start = mChunk.size();
+
+    mFrameOffsets.push_back(mOffset);
+    _encodeFrame(iScene, keyFrame);
+    mOffset += mChunk.size() - start;
+
+    if ( mChunk.size() >= sChunkSize )
+    {
+        _flushChunk();
+    }
+}
+
+void TrajectoryRecorder::_encodeFrame(const Sim::NativeScene& iScene, bool iKeyFrame)
+{
+    PutVarint(mChunk, iScene.getStepCount());
+    PutF64(mChunk, iScene.getTime());
+
+    for (size_t i=0; i<iScene.getPartCount(); ++i)
+    {
+        const Sim::PartId part = static_cast<Sim::PartId>(i);
+        const Sim::Vec3 position = iScene.getPartPosition(part);
+        const Sim::Quat& orientation = iScene.getPartOrientation(part);
+        const Sim::Vec3& linearVelocity = iScene.getPartLinearVelocity(part);
+        const Sim::Vec3& angularVelocity = iScene.getPartAngularVelocity(part);
+
+        size_t value = i * kPartValueCount;
+        for (int j=0; j<3; ++j)
+        {
+            _putPartValue(value++, position[j], mSettings.positionQuantum, iKeyFrame);
+        }
+        _putPartValue(value++, orientation.w, mSettings.orientationQuantum, iKeyFrame);
+        _putPartValue(value++, orientation.x, mSettings.orientationQuantum, iKeyFrame);
+        _putPartValue(value++, orientation.y, mSettings.orientationQuantum, iKeyFrame);
+        _putPartValue(value++, orientation.z, mSettings.orientationQuantum, iKeyFrame);
+        for (int j=0; j<3; ++j)
+        {
+            _putPartValue(value++, linearVelocity[j], mSettings.velocityQuantum, iKeyFrame);
+        }
+        for (int j=0; j<3; ++j)
+        {
+            _putPartValue(value++, angularVelocity[j], mSettings.velocityQuantum, iKeyFrame);
+        }
+    }
+
+    // The node count changes with the spooling, so the cables are encoded
+    // along the chain rather than against the previous frame.
+    for (size_t i=0; i<iScene.getCableCount(); ++i)
+    {
+        const Sim::CableChain& chain = iScene.getCable(static_cast<Sim::CableId>(i));
+        PutVarint(mChunk, chain.getNodeCount());
+        PutVarint(mChunk, chain.isBroken() ? 1 : 0);
+
+        long long previous[3] = { 0, 0, 0 };
+        for (size_t j=0; j<chain.getNodeCount(); ++j)
+        {
+            const Sim::Vec3 position = chain.getNodePosition(j);
+            for (int k=0; k<3; ++k)
+            {
+                const long long quantized = Quantize(position[k], mSettings.positionQuantum);
+                PutSigned(mChunk, quantized - previous[k]);
+                previous[k] = quantized;
+            }
+        }
+
+        for (size_t j=0; j<chain.getSectionCount(); ++j)
+        {
+            PutSigned(mChunk, Quantize(chain.getSectionTension(j), mSettings.tensionQuantum));
+        }
+    }
+}
+
+void TrajectoryRecorder::_putPartValue(size_t iIndex, double iValue, double iQuantum, bool iKeyFrame)
+{
+    const long long quantized = Quantize(iValue, iQuantum);
+    PutSigned(mChunk, iKeyFrame ? quantized : quantized - mPartValues[iIndex]);
+    mPartValues[iIndex] = quantized;
+}
+
+void TrajectoryRecorder::_flushChunk()
+{
+    if ( mChunk.empty() )
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPendingChunks.push_back(std::vector<unsigned char>());
+        mPendingChunks.back().swap(mChunk);
+        if ( !mFreeChunks.empty() )
+        {
+            mChunk.swap(mFreeChunks.back());
+            mFreeChunks.pop_back();
+        }
+    }
+    mWakeUp.notify_one();
+
+    mChunk.reserve(2 * sChunkSize);
+}
+
+void TrajectoryRecorder::_writerLoop()
+{
+    std::vector<unsigned char> chunk;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if ( !chunk.empty() )
+            {
+                // Give the written chunk back to record().
+                chunk.clear();
+                mFreeChunks.push_back(std::vector<unsigned char>());
+                mFreeChunks.back().swap(chunk);
+            }
+
+            while ( mPendingChunks.empty() && !mClosing )
+            {
+                mWakeUp.wait(lock);
+            }
+            if ( mPendingChunks.empty() )
+            {
+                return;
+            }
+
+            chunk.swap(mPendingChunks.front());
+            mPendingChunks.pop_front();
+        }
+
+        mStream.write(reinterpret_cast<const char*>(&chunk[0]), chunk.size());
+        if ( !mStream.good() )
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mWriteFailed = true;
+        }
+    }
+}
+
+bool TrajectoryRecorder::close()
+{
+    if ( !isOpen() )
+    {
+        return false;
+    }
+
+    _flushChunk();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosing = true;
+    }
+    mWakeUp.notify_one();
+    mThread.join();
+
+    // The writer is done: the index and footer are written from here.
+    std::vector<unsigned char> footer;
+    footer.reserve(mFrameOffsets.size() * 8 + kFooterSize);
+    for (size_t i=0; i<mFrameOffsets.size(); ++i)
+    {
+        PutU64(footer, mFrameOffsets[i]);
+    }
+    PutU64(footer, mFrameOffsets.size());
+    PutU64(footer, mOffset);
+    footer.insert(footer.end(), kIndexMagic, kIndexMagic + 4);
+    mStream.write(reinterpret_cast<const char*>(&footer[0]), footer.size());
+
+    const bool success = !mWriteFailed && mStream.good();
+    mStream.close();
+    mPendingChunks.clear();
+    mFreeChunks.clear();
+    return success;
+}
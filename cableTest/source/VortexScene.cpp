@@ -0,0 +1,447 @@
+#include "VortexScene.h"
+#include "KeyboardExtension.h"
+#include "MyCrane.h"
+
+#include <CableSystems/CableSystemsICD.h>
+#include <CableSystems/DynamicsICD.h>
+
+#ifdef USE_OSG
+#include <CableSystems/GraphicsICD.h>
+
+#include <VxGraphics/ICamera.h>
+#include <VxGraphics/IGraphicICD.h>
+#include <VxGraphicsPlugins/LightICD.h>
+#include <VxGraphicsPlugins/PerspectiveICD.h>
+#endif
+
+#include <VxSim/VxExtensionFactory.h>
+#include <VxSim/VxFactoryKey.h>
+#include <VxSim/VxUuid.h>
+
+#include <VxData/Container.h>
+#include <VxData/FieldArray.h>
+#include <VxData/FieldBase.h>
+
+#include <Vx/VxAssembly.h>
+#include <Vx/VxBox.h>
+#include <Vx/VxCollisionGeometry.h>
+#include <Vx/VxCollisionRule.h>
+#include <Vx/VxConnectionFactory.h>
+#include <Vx/VxCylinder.h>
+#include <Vx/VxHinge.h>
+#include <Vx/VxMessage.h>
+#include <Vx/VxPart.h>
+#include <Vx/VxPlane.h>
+#include <Vx/VxPrismatic.h>
+#include <Vx/VxTransform.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Vx;
+using namespace CableSystems;
+using namespace CableSystems::DynamicsICD;
+
+static VxVector3 ToVx(const Sim::Vec3& v)
+{
+    return VxVector3(v.x, v.y, v.z);
+}
+
+static VxTransform ToVx(const Sim::Pose& pose)
+{
+    return VxTransform(ToVx(pose.position), VxEulerAngles(pose.euler.x, pose.euler.y, pose.euler.z, VxEulerAngles::kXYZ_CounterClockwise_Rotating));
+}
+
+// Convert a list index to the string key used by the VxData lists. The
+// keys are formatted once and shared by all the cables of the process.
+static const std::string& ToKey(size_t index)
+{
+    static std::vector<std::string> sKeys;
+    while ( sKeys.size() <= index )
+    {
+        std::ostringstream key;
+        key << sKeys.size();
+        sKeys.push_back(key.str());
+    }
+    return sKeys[index];
+}
+
+// Containers of a CableSystems definition. They are resolved in one pass
+// over the lists, before any value is written, so that filling the
+// definition does no string lookup nor dynamic_cast per field.
+struct CableDefinitionFields
+{
+    VxData::Container* params;
+    std::vector<VxData::Container*> points;
+    std::vector<VxData::Container*> segments;
+};
+
+static void ResolveFields(VxSim::VxExtension* iCableExtension, const Sim::CableDefinition& iDefinition, CableDefinitionFields& oFields)
+{
+    // The cable system always has a definition.
+    VxData::Container& container = iCableExtension->getParameterContainer();
+    VxData::Container& definition = dynamic_cast<VxData::Container&>(container[kDefinitionID]);
+
+    VxData::FieldBase& fieldBasePoints = definition[CableSystemDefinitionContainerID::kPointDefinitionsID];
+    if ( ! fieldBasePoints["size"].setValue(static_cast<unsigned int>(iDefinition.points.size())) )
+    {
+        VxFatalError(0, "Cannot resize the List of PointDefinition\n");
+    }
+
+    oFields.points.resize(iDefinition.points.size());
+    for (size_t i=0; i<iDefinition.points.size(); ++i)
+    {
+        oFields.points[i] = &dynamic_cast<VxData::Container&>(fieldBasePoints[ToKey(i)]);
+    }
+
+    VxData::FieldBase& fieldBaseSegments = definition[CableSystemDefinitionContainerID::kSegmentDefinitionsID];
+    oFields.segments.resize(iDefinition.segments.size());
+    for (size_t i=0; i<iDefinition.segments.size(); ++i)
+    {
+        oFields.segments[i] = &dynamic_cast<VxData::Container&>(fieldBaseSegments[ToKey(iDefinition.segments[i].index)]);
+    }
+
+    oFields.params = &dynamic_cast<VxData::Container&>(definition[CableSystemDefinitionContainerID::kParamDefinitionID]);
+}
+
+namespace Sim
+{
+    VortexScene::VortexScene(bool iWithGraphics)
+        : mWithGraphics(iWithGraphics)
+        , mControlLog(NULL)
+        , mScene(new VxSim::VxScene())
+    {
+    }
+
+    VortexScene::~VortexScene()
+    {
+    }
+
+    VxSim::VxMechanism* VortexScene::getMechanism(MechanismId iMechanism) const
+    {
+        return mMechanisms[iMechanism].get();
+    }
+
+    VxAssembly* VortexScene::getAssembly(AssemblyId iAssembly) const
+    {
+        return mAssemblies[iAssembly];
+    }
+
+    VxPart* VortexScene::getPart(PartId iPart) const
+    {
+        return mParts[iPart];
+    }
+
+    VxConstraint* VortexScene::getConstraint(ConstraintId iConstraint) const
+    {
+        return mConstraints[iConstraint];
+    }
+
+    VxSim::VxExtension* VortexScene::getCableExtension(CableId iCable) const
+    {
+        return mCables[iCable];
+    }
+
+    MechanismId VortexScene::createMechanism(const std::string& iName)
+    {
+        VxSim::VxMechanism* mechanism = new VxSim::VxMechanism();
+        if ( !iName.empty() )
+        {
+            mechanism->setName(iName.c_str());
+        }
+        mScene->add(mechanism);
+        mMechanisms.push_back(mechanism);
+
+        return static_cast<MechanismId>(mMechanisms.size() - 1);
+    }
+
+    AssemblyId VortexScene::createAssembly(MechanismId iMechanism, const std::string& iName)
+    {
+        VxAssembly* assembly = new VxAssembly();
+        assembly->setName(iName.c_str());
+        getMechanism(iMechanism)->addAssembly(assembly);
+        mAssemblies.push_back(assembly);
+
+        const AssemblyId id = static_cast<AssemblyId>(mAssemblies.size() - 1);
+        mAssemblyNameRegistry.add(iMechanism, iName, id);
+        return id;
+    }
+
+    PartId VortexScene::createPart(AssemblyId iAssembly, const PartDefinition& iDefinition)
+    {
+        VxPart* part = iDefinition.mass > 0.0 ? new VxPart(iDefinition.mass) : new VxPart();
+        if ( !iDefinition.name.empty() )
+        {
+            part->setName(iDefinition.name.c_str());
+        }
+        switch ( iDefinition.control )
+        {
+        case kPartStatic:
+            part->setControl(VxPart::kControlStatic);
+            break;
+        case kPartAnimated:
+            part->setControl(VxPart::kControlAnimated);
+            break;
+        default:
+            part->setControl(VxPart::kControlDynamic);
+            break;
+        }
+        part->setPosition(ToVx(iDefinition.position));
+        getAssembly(iAssembly)->addPart(part);
+        mParts.push_back(part);
+
+        const PartId id = static_cast<PartId>(mParts.size() - 1);
+        mPartNameRegistry.add(iAssembly, iDefinition.name, id);
+        return id;
+    }
+
+    void VortexScene::addBox(PartId iPart, const Vec3& iDimensions, const Pose& iRelative)
+    {
+        VxCollisionGeometry* geometry = new VxCollisionGeometry(new VxBox(iDimensions.x, iDimensions.y, iDimensions.z));
+        geometry->setTransformRelative(ToVx(iRelative));
+        getPart(iPart)->addCollisionGeometry(geometry);
+    }
+
+    void VortexScene::addCylinder(PartId iPart, double iRadius, double iHeight, const Pose& iRelative)
+    {
+        VxCollisionGeometry* geometry = new VxCollisionGeometry(new VxCylinder(iRadius, iHeight));
+        geometry->setTransformRelative(ToVx(iRelative));
+        getPart(iPart)->addCollisionGeometry(geometry);
+    }
+
+    void VortexScene::addPlane(PartId iPart)
+    {
+        getPart(iPart)->addCollisionGeometry(new VxCollisionGeometry(new VxPlane()));
+    }
+
+    void VortexScene::setSelfCollision(AssemblyId iAssembly, bool iEnabled)
+    {
+        VxAssembly* assembly = getAssembly(iAssembly);
+        assembly->appendCollisionRule(VxCollisionRule(assembly, assembly, iEnabled));
+    }
+
+    ConstraintId VortexScene::createHinge(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis)
+    {
+        VxHinge* hinge = new VxHinge(getPart(iPart1), getPart(iPart2), ToVx(iPosition), ToVx(iAxis));
+        hinge->setControl(VxHinge::kAngularCoordinate, VxConstraint::kControlFree);
+        getAssembly(iAssembly)->addConstraint(hinge);
+        mConstraints.push_back(hinge);
+        mConstraintCoordinates.push_back(VxHinge::kAngularCoordinate);
+
+        return static_cast<ConstraintId>(mConstraints.size() - 1);
+    }
+
+    ConstraintId VortexScene::createPrismatic(AssemblyId iAssembly, PartId iPart1, PartId iPart2, const Vec3& iPosition, const Vec3& iAxis)
+    {
+        VxPrismatic* prismatic = new VxPrismatic(getPart(iPart1), getPart(iPart2), ToVx(iPosition), ToVx(iAxis));
+        prismatic->setControl(VxPrismatic::kLinearCoordinate, VxConstraint::kControlFree);
+        getAssembly(iAssembly)->addConstraint(prismatic);
+        mConstraints.push_back(prismatic);
+        mConstraintCoordinates.push_back(VxPrismatic::kLinearCoordinate);
+
+        return static_cast<ConstraintId>(mConstraints.size() - 1);
+    }
+
+    void VortexScene::setConstraintControl(ConstraintId iConstraint, ConstraintControl iControl)
+    {
+        const int coordinate = mConstraintCoordinates[iConstraint];
+        if ( kConstraintMotorized == iControl )
+        {
+            getConstraint(iConstraint)->setControl(coordinate, VxConstraint::kControlMotorized);
+            getConstraint(iConstraint)->setMotorDesiredVelocity(coordinate, 0.0);
+        }
+        else
+        {
+            getConstraint(iConstraint)->setControl(coordinate, VxConstraint::kControlFree);
+        }
+    }
+
+    void VortexScene::setMotorDesiredVelocity(ConstraintId iConstraint, double iVelocity)
+    {
+        getConstraint(iConstraint)->setMotorDesiredVelocity(mConstraintCoordinates[iConstraint], iVelocity);
+    }
+
+    void VortexScene::setLimits(ConstraintId iConstraint, double iLower, double iUpper)
+    {
+        const int coordinate = mConstraintCoordinates[iConstraint];
+        VxConstraint* constraint = getConstraint(iConstraint);
+        constraint->setLowerLimit(coordinate, iLower);
+        constraint->setUpperLimit(coordinate, iUpper);
+        constraint->setLimitsActive(coordinate, true);
+    }
+
+    CableId VortexScene::createCable(MechanismId iMechanism, const CableDefinition& iDefinition)
+    {
+        VxSim::VxExtension* cableSystemExtension = VxSim::VxExtensionFactory::create(CableSystemsICD::Extensions::kDynamicsKey);
+        cableSystemExtension->setName(iDefinition.name.c_str());
+        getMechanism(iMechanism)->add(cableSystemExtension);
+
+        _fillCableDefinition(cableSystemExtension, iDefinition);
+
+        mCables.push_back(cableSystemExtension);
+
+        const CableId id = static_cast<CableId>(mCables.size() - 1);
+        mCableNameRegistry.add(iMechanism, iDefinition.name, id);
+        return id;
+    }
+
+    // Fill the CableSystems definition of the extension from iDefinition.
+    void VortexScene::_fillCableDefinition(VxSim::VxExtension* iCableExtension, const CableDefinition& iDefinition)
+    {
+        CableDefinitionFields fields;
+        ResolveFields(iCableExtension, iDefinition, fields);
+
+        // IMPORTANT: The points must be added in the right order.
+        for (size_t i=0; i<iDefinition.points.size(); ++i)
+        {
+            const CablePointDefinition& pointDefinition = iDefinition.points[i];
+            VxData::Container& point = *fields.points[i];
+            point[PointDefinitionContainerID::kVxPartID].setValue(getPart(pointDefinition.part));
+
+            switch ( pointDefinition.type )
+            {
+            case kCableWinch:
+                point[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kWinch));
+                break;
+
+            case kCablePulley:
+                point[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kPulley));
+                // In some cases, CableSystems might not be able to correctly deduce on which side the cable passes.
+                if ( pointDefinition.inverseWrapping && !point[PulleyDefinitionContainerID::kInverseWrappingID].setValue(true) )
+                {
+                    VxInfo(0, "Cannot set the value of the inverse wrapping in the pulley\n");
+                }
+                break;
+
+            case kCableRing:
+                point[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kRing));
+                point[RingDefinitionContainerID::kRelativePrimaryAxisID].setValue(ToVx(pointDefinition.ringPrimaryAxis));
+                break;
+
+            default:
+                point[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
+                point[PointDefinitionContainerID::kOffsetID].setValue(ToVx(pointDefinition.offset));
+                break;
+            }
+        }
+
+        for (size_t i=0; i<iDefinition.segments.size(); ++i)
+        {
+            const CableSegmentDefinition& segmentDefinition = iDefinition.segments[i];
+            VxData::Container& segment = *fields.segments[i];
+            segment[SegmentDefinitionContainerID::kFlexibleID].setValue(segmentDefinition.flexible);
+            segment[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(segmentDefinition.maxSectionLength);
+            segment[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(segmentDefinition.minSectionLength);
+            if ( segmentDefinition.fixedLength )
+            {
+                segment[SegmentDefinitionContainerID::kFixedLengthID].setValue(true);
+            }
+            if ( segmentDefinition.collisionGeometryType >= 0 )
+            {
+                segment[SegmentDefinitionContainerID::kCollisionGeometryTypeID].setValue(segmentDefinition.collisionGeometryType);
+            }
+        }
+
+        VxData::Container& params = *fields.params;
+        params[CableSystemParamDefinitionContainerID::kAxialStiffnessID].setValue(iDefinition.params.axialStiffness);
+        params[CableSystemParamDefinitionContainerID::kAxialDampingID].setValue(iDefinition.params.axialDamping);
+        if ( iDefinition.params.collisionGeometryType >= 0 )
+        {
+            params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue(iDefinition.params.collisionGeometryType);
+        }
+        if ( iDefinition.params.enableBreakage )
+        {
+            params[CableSystemParamDefinitionContainerID::kEnableBreakageID].setValue(true);
+            params[CableSystemParamDefinitionContainerID::kMaxTensionID].setValue(iDefinition.params.maxTension);
+        }
+    }
+
+    AssemblyId VortexScene::findAssembly(MechanismId iMechanism, const std::string& iName) const
+    {
+        return mAssemblyNameRegistry.find(iMechanism, iName);
+    }
+
+    PartId VortexScene::findPart(AssemblyId iAssembly, const std::string& iName) const
+    {
+        return mPartNameRegistry.find(iAssembly, iName);
+    }
+
+    CableId VortexScene::findCable(MechanismId iMechanism, const std::string& iName) const
+    {
+        return mCableNameRegistry.find(iMechanism, iName);
+    }
+
+    Vec3 VortexScene::getPartPosition(PartId iPart) const
+    {
+        const VxVector3 position = getPart(iPart)->getPosition();
+        return Vec3(position[0], position[1], position[2]);
+    }
+
+    void VortexScene::addCableGraphics(MechanismId iMechanism, CableId iCable, const std::string& iName)
+    {
+#ifdef USE_OSG
+        if ( !mWithGraphics )
+        {
+            return;
+        }
+
+        // The cable system is displayed with a graphic extension since it is not
+        // in Vortex by default, unlike the collision geometries.
+        VxSim::VxExtension* gfxExtension = VxSim::VxExtensionFactory::create(CableSystems::GraphicsICD::kFactoryKey);
+        VxAssert(NULL != gfxExtension, "Cannot create the CableSystem Graphic Plugin\n");
+        gfxExtension->setName(iName.c_str());
+        getMechanism(iMechanism)->add(gfxExtension);
+
+        VxConnectionFactory::create(getCableExtension(iCable)->getOutput(kCablesID), gfxExtension->getInput(kCablesID));
+#endif
+    }
+
+    void VortexScene::addDirectionalLight(const Vec3& iOrientation)
+    {
+#ifdef USE_OSG
+        if ( !mWithGraphics )
+        {
+            return;
+        }
+
+        Vx::VxSmartPtr<VxSim::VxExtension> light = VxSim::VxExtensionFactory::create(VxGraphicsPlugins::LightICD::kDirectionalLightFactoryKey);
+        light->getInput(VxGraphicsPlugins::IGraphicICD::kInputOrientation)->setValue(ToVx(iOrientation));
+        mScene->add(light.get());
+#endif
+    }
+
+    void VortexScene::addCamera(const Pose& iPose)
+    {
+#ifdef USE_OSG
+        if ( !mWithGraphics )
+        {
+            return;
+        }
+
+        Vx::VxSmartPtr<VxSim::VxExtension> freeCameraExtension = VxSim::VxExtensionFactory::create(VxGraphicsPlugins::PerspectiveICD::kExtensionFactoryKey);
+        VxGraphics::ICamera* freeCamera = VxGraphics::ICamera::getInterface(freeCameraExtension.get());
+        freeCamera->setTransform(VxTransform(ToVx(iPose.position), VxEulerAngles(iPose.euler.x, iPose.euler.y, iPose.euler.z)));
+        mScene->add(freeCameraExtension.get());
+#endif
+    }
+
+    // Create the keyboard extension to enable the control of the crane by
+    // pressing keys.
+    void VortexScene::addKeyboardControl(MechanismId iMechanism, MyCrane* iCrane)
+    {
+        // Register the KeyboardExtension 
+        VxSim::VxFactoryKey key(VxSim::VxUuid("5cb789d0-5585-5d40-8db9-20f499692507"), "Tutorials", "KeyboardExtension");
+        VxSim::VxExtensionFactory::registerType<KeyboardExtension>(key);
+
+        // Create the KeyboardExtension that was registered and initialize it.
+        VxSim::VxExtension* keyboard = VxSim::VxExtensionFactory::create(key);
+        KeyboardExtension * myKB = dynamic_cast<KeyboardExtension*>(dynamic_cast<VxSim::VxPluginExtension*>(keyboard)->getIExtension());
+        if(myKB)
+        {
+            myKB->setCrane(iCrane);
+            myKB->setControlLog(mControlLog);
+        }
+        getMechanism(iMechanism)->add(keyboard);
+    }
+}
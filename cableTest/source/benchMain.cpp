@@ -0,0 +1,127 @@
+#include "BenchmarkSuite.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+// Every heap allocation of the process goes through these, so the suite
+// can tell how many a step makes.
+static std::atomic<size_t> sAllocationCount(0);
+
+void* operator new(size_t iSize)
+{
+    sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* memory = malloc(iSize > 0 ? iSize : 1);
+    if ( NULL == memory )
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t iSize)
+{
+    return operator new(iSize);
+}
+
+void operator delete(void* iMemory) noexcept
+{
+    free(iMemory);
+}
+
+void operator delete[](void* iMemory) noexcept
+{
+    free(iMemory);
+}
+
+static size_t GetAllocationCount()
+{
+    return sAllocationCount.load(std::memory_order_relaxed);
+}
+
+static void PrintUsage(const char* iProgramName, const BenchmarkSuite& iSuite)
+{
+    std::cout << "Usage: " << iProgramName << " [--case name[,name...]] [--steps n] [--output file.json] [--baseline file.json]" << std::endl
+              << "Cases:" << std::endl;
+    for (size_t i=0; i<iSuite.getCases().size(); ++i)
+    {
+        const BenchmarkSuite::Case& benchmarkCase = iSuite.getCases()[i];
+        std::cout << "  " << benchmarkCase.name << ": " << benchmarkCase.description << ", " << benchmarkCase.stepCount << " steps" << std::endl;
+    }
+}
+
+// Step-time benchmarks of the native backend.
+//
+// Runs the named cases of BenchmarkSuite (all of them by default), prints
+// their step times, allocations and peak memory, and writes them as JSON.
+// With --baseline, the results are compared to those of a previous run and
+// the exit code is 2 when a case regressed, so that a batch job can fail:
+//
+//   cableTestBench --output baseline.json
+//   cableTestBench --baseline baseline.json --output results.json
+int main (int argc, const char * argv[])
+{
+    BenchmarkSuite suite;
+    suite.setAllocationCounter(GetAllocationCount);
+
+    std::vector<std::string> names;
+    size_t stepCount = 0;
+    std::string outputFileName;
+    std::string baselineFileName;
+    for (int i=1; i<argc; ++i)
+    {
+        const char* option = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if ( 0 == strcmp(option, "--case") && hasValue )
+        {
+            std::istringstream list(argv[++i]);
+            std::string name;
+            while ( std::getline(list, name, ',') )
+            {
+                names.push_back(name);
+            }
+        }
+        else if ( 0 == strcmp(option, "--steps") && hasValue )
+        {
+            stepCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--output") && hasValue )
+        {
+            outputFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--baseline") && hasValue )
+        {
+            baselineFileName = argv[++i];
+        }
+        else
+        {
+            std::cout << "Unknown or incomplete option " << option << std::endl;
+            PrintUsage(argv[0], suite);
+            return 1;
+        }
+    }
+
+    if ( !baselineFileName.empty() && !suite.loadBaseline(baselineFileName) )
+    {
+        return 1;
+    }
+
+    if ( !suite.run(names, stepCount) )
+    {
+        PrintUsage(argv[0], suite);
+        return 1;
+    }
+
+    const bool passed = suite.compare();
+    suite.printResults();
+
+    if ( !outputFileName.empty() && !suite.writeJson(outputFileName) )
+    {
+        return 1;
+    }
+
+    return passed ? 0 : 2;
+}
@@ -1,5 +1,16 @@
-#include "KeyboardExtension.h"
+#include "BatchOptions.h"
+#include "BrickScene.h"
+#include "CableDefinitionLoader.h"
+#include "ControlLog.h"
+#include "CraneController.h"
+#include "FixedRateScheduler.h"
 #include "ExCableSystem.h"
+#include "MyCrane.h"
+#include "ProfilerExtension.h"
+#include "StepProfiler.h"
+#include "StepStatistics.h"
+#include "StressScene.h"
+#include "VortexScene.h"
 
 #include <CableSystems/CableSystemsICD.h>
 #include <CableSystems/DynamicsICD.h>
@@ -15,6 +26,7 @@
 #include <VxSim/VxMechanism.h>
 #include <VxSim/VxSimulatorModuleFactory.h>
 #include <VxSim/VxExtensionFactory.h>
+#include <VxSim/VxPluginExtension.h>
 #include <VxSim/VxDynamicsModuleICD.h>
 
 #include <VxData/FieldArray.h>
@@ -40,7 +52,9 @@
 #include <VxGraphicsPlugins/GraphicsModuleICD_OSG.h>
 #endif
 
+#include <chrono>
 #include <iostream>
+#include <memory>
 using std::cout;
 using std::endl;
 
@@ -48,6 +62,12 @@ int main (int argc, const char * argv[])
 {
 
 	int returnValue = 0;
+
+    BatchOptions options;
+    if ( !options.parse(argc, argv) )
+    {
+        return 1;
+    }
     
 	try
     {
@@ -55,6 +75,8 @@ int main (int argc, const char * argv[])
         Vx::VxSmartPtr<VxSim::VxApplication> application = new VxSim::VxApplication;
 
 #ifdef USE_OSG
+      if ( !options.headless )
+      {
         // Instantiate a Graphic module using OSG and add it to the application.
         VxPluginSystem::VxPluginManager::instance()->load("VxGraphicsModuleOSG");
         Vx::VxSmartPtr<VxSim::VxSimulatorModule> graphicsSimulatorModule = VxSim::VxSimulatorModuleFactory::create(VxGraphicsPlugins::GraphicsModuleICD::kModuleFactoryKey);
@@ -77,6 +99,7 @@ int main (int argc, const char * argv[])
         assert( NULL != graphicModule );
 
         graphicModule->setCamera(freeCamera);
+      }
 #endif
 
         // Create a material.
@@ -111,303 +134,200 @@ int main (int argc, const char * argv[])
         Vx::VxSmartPtr<VxSim::VxSimulatorModule> dynamicsModule = VxSim::VxSimulatorModuleFactory::create(VxSim::VxDynamicsModuleICD::kFactoryKey);
         application->insertModule(dynamicsModule.get());
 
-		/*
-        // Create the crane with the CableSystems and add it to the scene.
-        // Here, a cable system is created.  
-        // Note that we could instead load an existing mechanism file with an existing CableSystems 
-        ExCableSystem cableSystem;
-        VxSim::VxScene* scene = cableSystem.getScene();
-        scene->add(groundMechanism.get());
-
-        // Find the first CableSystem dynamics extension.
-        Vx::VxSmartPtr<VxSim::VxExtension> cableExtension;
-        size_t mechanismCount = scene->getSimObjectCount();
-        for (size_t mechanismIndex = 0; mechanismIndex < mechanismCount; ++mechanismIndex)
+        // The keyboard records the controls in recordedControls; the replayed
+        // controls are applied directly to the crane, so they are not recorded.
+        ControlLog recordedControls;
+        ControlLog replayedControls;
+        if ( !options.replayControlsFileName.empty() && !replayedControls.load(options.replayControlsFileName) )
+        {
+            return 1;
+        }
+
+        // The scenes are built through the Sim::IScene interface.
+        Sim::VortexScene vortexScene(!options.headless);
+        if ( !options.recordControlsFileName.empty() )
+        {
+            vortexScene.setControlLog(&recordedControls);
+        }
+        std::unique_ptr<ExCableSystem> cableSystem;
+        std::unique_ptr<StressScene> stressScene;
+        if ( options.sceneName == "crane" )
         {
-            Vx::VxSmartPtr<VxSim::VxSimObject> mechanism = scene->getSimObject(mechanismIndex);
-            if (mechanism.valid())
+            // Create the crane with the CableSystems and add it to the scene.
+            // Here, a cable system is created.  
+            // Note that we could instead load an existing mechanism file with an existing CableSystems 
+            // With --cable, the definition of the cable is read from a file.
+            Sim::CableDefinitionLoader cableLoader;
+            if ( !options.cableFileName.empty() && !cableLoader.load(options.cableFileName) )
             {
-                std::cout << "****************************" << std::endl << "- Mechanism: " << mechanism->getName() << std::endl;
-
-                size_t extCount = mechanism->getExtensionCount();
-                for (size_t extIndex = 0; extIndex < extCount; ++extIndex)
-                {
-                    Vx::VxSmartPtr<VxSim::VxExtension> ext = mechanism->getExtension(extIndex);
-                    VxSim::VxPluginExtension* pluginExt = dynamic_cast<VxSim::VxPluginExtension*>(ext.get());
-                    if (pluginExt) 
-                    {                    
-                        if (pluginExt->getCreationKey() == CableSystemsICD::Extensions::kDynamicsKey)
-                        {
-                            cableExtension = ext;
-                            break;
-                        }
-                    }
-                }
+                return 1;
             }
+            ExCableSystem::Settings settings;
+            settings.cableLoader = options.cableFileName.empty() ? NULL : &cableLoader;
+            settings.maxSectionLength = options.sectionLength;
+            cableSystem.reset(new ExCableSystem(vortexScene, settings));
+
+            // The cable extensions are found by name through the scene, e.g.
+            // vortexScene.getCableExtension(vortexScene.findCable(mechanism, name)),
+            // rather than by walking every extension of every mechanism.
+        }
+        else if ( options.sceneName == "stress" )
+        {
+            StressScene::Settings settings;
+            settings.craneCount = options.craneCount;
+            settings.cablesPerCrane = options.cablesPerCrane;
+            settings.cableLength = options.cableLength;
+            if ( options.sectionLength > 0.0 )
+            {
+                settings.maxSectionLength = options.sectionLength;
+            }
+            settings.pulleyCount = options.pulleyCount;
+            settings.layout = options.layout;
+            settings.seed = options.seed;
+            stressScene.reset(new StressScene(vortexScene, settings));
+            std::cout << "Stress scene: " << stressScene->getDescription() << std::endl;
+        }
+        else if ( options.sceneName == "bricks" )
+        {
+            CreateBrickScene(vortexScene);
+        }
+        else
+        {
+            std::cout << "Unknown scene " << options.sceneName << std::endl;
+            return 1;
         }
-		*/
-
-	/** Alex's test **/
-    VxSim::VxMechanism* mechanism = new VxSim::VxMechanism();
-    mechanism->setName("cableTestMechanism");
-
-	Vx::VxAssembly* assembly = new Vx::VxAssembly();
-    assembly->setName("cableTestAssembly");
-
-	Vx::VxPart* bPart = new Vx::VxPart();
-	bPart->setName("testBrick");
-	bPart->setPosition(0, 20.0, 3.0);
-	Vx::VxCollisionGeometry* ge = new Vx::VxCollisionGeometry( new Vx::VxBox(0.5, 10.0, 0.5));
-	bPart->addCollisionGeometry(ge);
-	bPart->setControl(Vx::VxPart::kControlAnimated);
-	assembly->addPart(bPart);
-
-	Vx::VxPart*	brick = new Vx::VxPart();
-	Vx::VxPart* brick2 = brick;
-	brick->setName("brick_1");
-	brick->setPosition(5.0, 20.0, 10.0);
-	Vx::VxCollisionGeometry* geom = new Vx::VxCollisionGeometry(new Vx::VxBox(1.0, 1.0, 1.0));
-	brick->addCollisionGeometry(geom);
-	brick->setControl(Vx::VxPart::kControlDynamic);
-//	brick->setControl(Vx::VxPart::kControlAnimated);
-	assembly->addPart(brick);
-
-	brick = new Vx::VxPart();
-	Vx::VxPart* brick3 = brick;
-	brick->setName("brick_3");
-	brick->setPosition(0.0, 30.0, 5.0);
-	geom = new Vx::VxCollisionGeometry(new Vx::VxBox(1.0, 1.0, 1.0));
-	brick->addCollisionGeometry(geom);
-//	brick->setControl(Vx::VxPart::kControlDynamic);
-	brick->setControl(Vx::VxPart::kControlAnimated);
-	assembly->addPart(brick);
-
-	brick = new Vx::VxPart();
-	Vx::VxPart* brick4 = brick;
-	brick->setName("brick_4");
-	brick->setPosition(0.0, 10.0, 5.0);
-	geom = new Vx::VxCollisionGeometry(new Vx::VxBox(1.0, 1.0, 1.0));
-	brick->addCollisionGeometry(geom);
-//	brick->setControl(Vx::VxPart::kControlDynamic);
-	brick->setControl(Vx::VxPart::kControlAnimated);
-	assembly->addPart(brick);
-
-	brick = new Vx::VxPart();
-	brick->setName("brick_2");
-	brick->setPosition(-5.0, 20.0, 10.0);
-	geom = new Vx::VxCollisionGeometry(new Vx::VxBox(1.0, 1.0, 1.0));
-	brick->addCollisionGeometry(geom);
-	brick->setControl(Vx::VxPart::kControlDynamic);
-//	brick->setControl(Vx::VxPart::kControlAnimated);
-	assembly->addPart(brick);
-
-	mechanism->addAssembly(assembly);
-	/*
-	VxSim::VxExtension* cable = VxSim::VxExtensionFactory::create(CableSystemsICD::Extensions::kDynamicsKey);
-	cable->setName("testCableExtension");
-	mechanism->add(cable);
-
-	using namespace Vx;
-	using namespace CableSystems;
-	using namespace CableSystems::DynamicsICD;
-
-	VxData::Container& container = cable->getParameterContainer();
-    VxData::FieldBase& defFieldBase = container[kDefinitionID];
-    VxData::Container& definition = dynamic_cast<VxData::Container&>(defFieldBase);
-    VxData::FieldBase& fieldBasePoints = definition[CableSystemDefinitionContainerID::kPointDefinitionsID];
-    if ( ! fieldBasePoints["size"].setValue(static_cast<unsigned int>(4)) ) // We will set 5 items below
-    {
-        VxFatalError(0, "Cannot resize the List of PointDefinition\n");
-    }
-	
-	const Vx::VxVector3 offset(0.5,0,0); // Needed to attach on the top of the load and not at the center of mass.
-    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["0"]);
-    attachmentPoint[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint[PointDefinitionContainerID::kVxPartID].setValue(brick);
-    attachmentPoint[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint2 = dynamic_cast<VxData::Container&>(fieldBasePoints["1"]);
-    attachmentPoint2[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint2[PointDefinitionContainerID::kVxPartID].setValue(brick2);
-    attachmentPoint2[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-	    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint3 = dynamic_cast<VxData::Container&>(fieldBasePoints["2"]);
-    attachmentPoint3[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint3[PointDefinitionContainerID::kVxPartID].setValue(brick3);
-    attachmentPoint3[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-	    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint4 = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-    attachmentPoint4[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint4[PointDefinitionContainerID::kVxPartID].setValue(brick4);
-    attachmentPoint4[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-	VxData::FieldBase& fieldBaseSegments = definition[CableSystemDefinitionContainerID::kSegmentDefinitionsID];
-    VxData::Container& lastSegmentDefinition = dynamic_cast<VxData::Container&>(fieldBaseSegments["0"]);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(11.0);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	lastSegmentDefinition[SegmentDefinitionContainerID::kFixedLengthID].setValue(true);
-
-	
-    VxData::Container& lastSegmentDefinition2 = dynamic_cast<VxData::Container&>(fieldBaseSegments["1"]);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(11.0);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	lastSegmentDefinition2[SegmentDefinitionContainerID::kFixedLengthID].setValue(true);
-	
-	VxData::FieldBase& fieldBaseParams = definition[CableSystemDefinitionContainerID::kParamDefinitionID];
-    VxData::Container& params = dynamic_cast<VxData::Container&>(fieldBaseParams);
-    params[CableSystemParamDefinitionContainerID::kAxialStiffnessID].setValue(10000.0);
-    params[CableSystemParamDefinitionContainerID::kAxialDampingID].setValue(20.0);
-	//params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue( groundGeom->getCollisionGeometryID() );
-	params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
-	//scene->add(mechanism);
-	*/
-
-	VxSim::VxExtension* cable = VxSim::VxExtensionFactory::create(CableSystemsICD::Extensions::kDynamicsKey);
-	cable->setName("testCableExtension");
-	mechanism->add(cable);
-
-	using namespace Vx;
-	using namespace CableSystems;
-	using namespace CableSystems::DynamicsICD;
-
-	VxData::Container& container = cable->getParameterContainer();
-    VxData::FieldBase& defFieldBase = container[kDefinitionID];
-    VxData::Container& definition = dynamic_cast<VxData::Container&>(defFieldBase);
-    VxData::FieldBase& fieldBasePoints = definition[CableSystemDefinitionContainerID::kPointDefinitionsID];
-    if ( ! fieldBasePoints["size"].setValue(static_cast<unsigned int>(2)) ) // We will set 5 items below
-    {
-        VxFatalError(0, "Cannot resize the List of PointDefinition\n");
-    }
-	
-	const Vx::VxVector3 offset(0.5,0,0); // Needed to attach on the top of the load and not at the center of mass.
-    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["0"]);
-    attachmentPoint[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint[PointDefinitionContainerID::kVxPartID].setValue(brick);
-    attachmentPoint[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint2 = dynamic_cast<VxData::Container&>(fieldBasePoints["1"]);
-    attachmentPoint2[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint2[PointDefinitionContainerID::kVxPartID].setValue(brick2);
-    attachmentPoint2[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-	VxData::FieldBase& fieldBaseSegments = definition[CableSystemDefinitionContainerID::kSegmentDefinitionsID];
-    VxData::Container& lastSegmentDefinition = dynamic_cast<VxData::Container&>(fieldBaseSegments["0"]);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(11.0);
-    lastSegmentDefinition[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	lastSegmentDefinition[SegmentDefinitionContainerID::kFixedLengthID].setValue(true);
-
-		
-	VxData::FieldBase& fieldBaseParams = definition[CableSystemDefinitionContainerID::kParamDefinitionID];
-    VxData::Container& params = dynamic_cast<VxData::Container&>(fieldBaseParams);
-    params[CableSystemParamDefinitionContainerID::kAxialStiffnessID].setValue(100.0);
-    params[CableSystemParamDefinitionContainerID::kAxialDampingID].setValue(20.0);
-	//params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue( groundGeom->getCollisionGeometryID() );
-	params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
-	//scene->add(mechanism);
-
-	
-	
-	
-	VxSim::VxExtension* cable2 = VxSim::VxExtensionFactory::create(CableSystemsICD::Extensions::kDynamicsKey);
-	cable2->setName("testCableExtension2");
-	mechanism->add(cable2);
-
-	VxData::Container& container2 = cable2->getParameterContainer();
-    VxData::FieldBase& defFieldBase2 = container2[kDefinitionID];
-    VxData::Container& definition2 = dynamic_cast<VxData::Container&>(defFieldBase2);
-    VxData::FieldBase& fieldBasePoints2 = definition2[CableSystemDefinitionContainerID::kPointDefinitionsID];
-    if ( ! fieldBasePoints2["size"].setValue(static_cast<unsigned int>(2)) ) // We will set 5 items below
-    {
-        VxFatalError(0, "Cannot resize the List of PointDefinition\n");
-    }
-	
-
-	    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint3 = dynamic_cast<VxData::Container&>(fieldBasePoints2["0"]);
-    attachmentPoint3[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint3[PointDefinitionContainerID::kVxPartID].setValue(brick3);
-    attachmentPoint3[PointDefinitionContainerID::kOffsetID].setValue(offset);
-
-	    //VxData::Container& attachmentPoint = dynamic_cast<VxData::Container&>(fieldBasePoints["3"]);
-	VxData::Container& attachmentPoint4 = dynamic_cast<VxData::Container&>(fieldBasePoints2["1"]);
-    attachmentPoint4[PointDefinitionContainerID::kPointTypeID].setValue(VxEnum(PointDefinitionType::kAttachmentPoint));
-    attachmentPoint4[PointDefinitionContainerID::kVxPartID].setValue(brick4);
-    attachmentPoint4[PointDefinitionContainerID::kOffsetID].setValue(offset);
-		
-	VxData::FieldBase& fieldBaseSegments2 = definition2[CableSystemDefinitionContainerID::kSegmentDefinitionsID];
-    VxData::Container& lastSegmentDefinition2 = dynamic_cast<VxData::Container&>(fieldBaseSegments2["0"]);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kFlexibleID].setValue(true);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMaxSectionLengthID].setValue(11.0);
-    lastSegmentDefinition2[SegmentDefinitionContainerID::kMinSectionLengthID].setValue(0.2);
-	lastSegmentDefinition2[SegmentDefinitionContainerID::kFixedLengthID].setValue(true);
-	
-	VxData::FieldBase& fieldBaseParams2 = definition2[CableSystemDefinitionContainerID::kParamDefinitionID];
-    VxData::Container& params2 = dynamic_cast<VxData::Container&>(fieldBaseParams2);
-    params2[CableSystemParamDefinitionContainerID::kAxialStiffnessID].setValue(100000.0);
-    params2[CableSystemParamDefinitionContainerID::kAxialDampingID].setValue(200.0);
-	//params[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue( groundGeom->getCollisionGeometryID() );
-	params2[CableSystemParamDefinitionContainerID::kCollisionGeometryTypeID].setValue(2);
-	params2[CableSystemParamDefinitionContainerID::kEnableBreakageID].setValue(true);
-	params2[CableSystemParamDefinitionContainerID::kMaxTensionID].setValue(1000.0);
-	//scene->add(mechanism);
-
-	 
-#ifdef USE_OSG
-   // The cable system is displayed with a graphic extension since it is not
-   // in Vortex by default, unlike the collision geometries.
-   VxSim::VxExtension* gfxExtension = VxSim::VxExtensionFactory::create(CableSystems::GraphicsICD::kFactoryKey);
-   VxAssert(NULL != gfxExtension, "Cannot create the CableSystem Graphic Plugin\n");
-   gfxExtension->setName("cableTestGraphics");
-   mechanism->add(gfxExtension);
-   Vx::VxConnectionFactory::create(cable->getOutput(kCablesID), gfxExtension->getInput(kCablesID));
-
-   VxSim::VxExtension* gfxExtension2 = VxSim::VxExtensionFactory::create(CableSystems::GraphicsICD::kFactoryKey);
-   VxAssert(NULL != gfxExtension2, "Cannot create the CableSystem Graphic Plugin\n");
-   gfxExtension2->setName("cableTestGraphics2");
-   mechanism->add(gfxExtension2);
-   Vx::VxConnectionFactory::create(cable2->getOutput(kCablesID), gfxExtension->getInput(kCablesID));
-
-
-#endif
-
 
 #ifdef USE_OSG     
+      if ( !options.headless )
+      {
         // Calls to create and add the dynamics visualizer is done here merely to provide
         // a visual demonstration of the physics associated with the crane.
         // Instantiate the DynamicsVisualizer to view the physics associated with various parts that have no graphics.
         VxSim::VxExtension* dynamicsVisualizer = VxSim::VxExtensionFactory::create(VxGraphicsPlugins::DynamicsVisualizerICD::kExtensionFactoryKey);
         dynamicsVisualizer->getInput(VxGraphicsPlugins::DynamicsVisualizerICD::kDisplayCollisionGeometry)->setValue(true);
         application->add(dynamicsVisualizer);
+      }
 #endif
 
         // Add the scene at start
-        //application->add(scene);        
-
-	
-		Vx::VxSmartPtr<VxSim::VxScene> myScene;
-		myScene = new VxSim::VxScene;
-
+        Vx::VxSmartPtr<VxSim::VxScene> myScene = vortexScene.getScene();
 		myScene->add(groundMechanism.get());
-		myScene->add(mechanism);
 		application->add(myScene.get());
+
+        // Vortex has no substep hook: the motion profiles are applied before
+        // each update, at the middle of the step.
+        std::unique_ptr<CraneController> controller;
+        if ( !options.motionFileName.empty() )
+        {
+            controller.reset(new CraneController(*cableSystem->getCrane()));
+            if ( !controller->load(options.motionFileName) )
+            {
+                return 1;
+            }
+        }
+
+        // The step statistics are preallocated so that recording them does not
+        // disturb the timing of the steps.
+        const size_t maxStepCount = options.getMaxStepCount();
+        StepStatistics statistics;
+        statistics.reserve(maxStepCount > 0 ? maxStepCount : 60 * 60 * 10);
+
+        // The profiler extension publishes the time of the phases of the last step
+        // on its outputs; with --profile, every step is also kept for the dump at exit.
+        VxSim::VxExtensionFactory::registerType<ProfilerExtension>(ProfilerExtension::kFactoryKey);
+        VxSim::VxExtension* profilerExtension = VxSim::VxExtensionFactory::create(ProfilerExtension::kFactoryKey);
+        ProfilerExtension* stepPhases = dynamic_cast<ProfilerExtension*>(dynamic_cast<VxSim::VxPluginExtension*>(profilerExtension)->getIExtension());
+        application->add(profilerExtension);
+
+        std::unique_ptr<StepProfiler> profiler;
+        if ( !options.profileFileName.empty() )
+        {
+            profiler.reset(new StepProfiler(maxStepCount > 0 ? maxStepCount : 60 * 60 * 10));
+            stepPhases->setProfiler(profiler.get());
+        }
 		
+        // The application updates at the rate of the steps, each step being
+        // split in substepCount updates, so that every step advances the
+        // simulated time by the time step whatever the pace of the steps.
+        application->setSimulationFrameRate(options.substepCount / options.timeStep);
+
+        // In real time the steps run in frames paced by the scheduler.
+        FixedRateScheduler::Settings schedulerSettings;
+        schedulerSettings.stepRate = 1.0 / options.timeStep;
+        schedulerSettings.maxCatchUpSteps = options.maxCatchUpSteps;
+        FixedRateScheduler scheduler(schedulerSettings);
+        size_t frameSteps = 0;
+
 		// Run the simulation.
         application->beginMainLoop();
+        if ( options.realTime )
+        {
+            scheduler.start();
+        }
+
+        size_t stepCount = 0; 
+        bool running = true;
+        while ( running && (0 == maxStepCount || stepCount < maxStepCount) )
+        {
+            if ( options.realTime && 0 == frameSteps )
+            {
+                frameSteps = scheduler.waitForSteps();
+            }
+
+            recordedControls.setStep(stepCount, stepCount * options.timeStep);
+            if ( cableSystem )
+            {
+                replayedControls.apply(stepCount, *cableSystem->getCrane());
+            }
+            if ( controller )
+            {
+                controller->apply((stepCount + 0.5) * options.timeStep);
+            }
+
+            const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+            stepPhases->beginUpdate();
+            for (int substep=0; running && substep<options.substepCount; ++substep)
+            {
+                running = application->update();
+            }
+            stepPhases->endUpdate();
+            const std::chrono::steady_clock::time_point stepEnd = std::chrono::steady_clock::now();
+
+            statistics.addStep(std::chrono::duration<double>(stepEnd - stepStart).count());
+            ++stepCount;
 
-        int stepCount = 0; 
-        while(application->update())
+            if ( options.realTime && 0 == --frameSteps )
+            {
+                scheduler.endFrame();
+            }
+        }
+
+        // A frame cut short by the end of the run is not counted.
+        if ( options.realTime )
         {
+            scheduler.printReport();
         }
         application->endMainLoop();
+
+        if ( !options.recordControlsFileName.empty() && !recordedControls.save(options.recordControlsFileName) )
+        {
+            returnValue = 1;
+        }
+
+        statistics.printSummary(options.sceneName);
+        if ( !options.statsFileName.empty() && !statistics.writeSummary(options.statsFileName, options.sceneName) )
+        {
+            returnValue = 1;
+        }
+
+        if ( profiler )
+        {
+            profiler->printSummary();
+            if ( !profiler->writeCsv(options.profileFileName) )
+            {
+                returnValue = 1;
+            }
+        }
     }
     catch(const std::exception& ex )
     {
@@ -423,3 +343,4 @@ int main (int argc, const char * argv[])
     return returnValue;
 
 }
+
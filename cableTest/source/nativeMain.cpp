@@ -0,0 +1,469 @@
+#include "BatchOptions.h"
+#include "BrickScene.h"
+#include "CableMeshBuilder.h"
+#include "CableTelemetry.h"
+#include "CableDefinitionLoader.h"
+#include "ControlLog.h"
+#include "CraneController.h"
+#include "FixedRateScheduler.h"
+#include "ExCableSystem.h"
+#include "MyCrane.h"
+#include "NativeScene.h"
+#include "RenderSnapshot.h"
+#include "SceneExporter.h"
+#include "StepProfiler.h"
+#include "StepStatistics.h"
+#include "StressScene.h"
+#include "ThreadPool.h"
+#include "TrajectoryRecorder.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// Monitoring thread of --telemetry: drains the telemetry into oStream, one
+// line per section, until iSimulating is cleared and the rings are empty.
+static void MonitorTelemetry(CableTelemetry& iTelemetry, const Sim::NativeScene& iScene, std::ostream& oStream, const std::atomic<bool>& iSimulating)
+{
+    CableTelemetry::Frame frame;
+    CableTelemetry::Break event;
+    for (;;)
+    {
+        // Everything published before the flag is cleared is drained below.
+        const bool done = !iSimulating.load(std::memory_order_acquire);
+
+        bool drained = true;
+        while ( iTelemetry.popBreak(event) )
+        {
+            std::cout << "Cable " << iScene.getCableName(event.cable) << " broke at section " << event.section
+                      << ", t = " << event.time << " s" << std::endl;
+            oStream << "# break: step = " << event.step << ", cable = " << event.cable << ", section = " << event.section
+                    << ", tension = " << event.tension << "\n";
+            drained = false;
+        }
+        while ( iTelemetry.pop(frame) )
+        {
+            for (size_t i=0; i<frame.sections.size(); ++i)
+            {
+                const CableTelemetry::Section& section = frame.sections[i];
+                oStream << frame.step << "," << frame.time << "," << frame.cable << "," << i << ","
+                        << section.tension << "," << section.strain << "," << (section.broken ? 1 : 0) << "\n";
+            }
+            drained = false;
+        }
+
+        if ( done )
+        {
+            break;
+        }
+        if ( drained )
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// Counters of the render thread of --render-rate.
+struct RenderCounters
+{
+    size_t frameCount;
+    // Frames that got a snapshot newer than the previous frame.
+    size_t newSnapshotCount;
+    // Steps between the first and the last drawn snapshots.
+    size_t stepSpan;
+};
+
+// Render thread of --render-rate: draws the latest snapshot iRate times per
+// second until iSimulating is cleared. There are no graphics here; drawing
+// builds the tube meshes of the cables a renderer would upload.
+static void RenderSnapshots(TripleBuffer<RenderSnapshot>& iSnapshots, double iRate, const std::atomic<bool>& iSimulating, RenderCounters& oCounters)
+{
+    const std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / iRate));
+    std::chrono::steady_clock::time_point nextFrame = std::chrono::steady_clock::now();
+    size_t firstStep = 0;
+    size_t lastStep = 0;
+    CableMeshBuilder mesh;
+
+    oCounters.frameCount = 0;
+    oCounters.newSnapshotCount = 0;
+    while ( iSimulating.load(std::memory_order_acquire) )
+    {
+        if ( iSnapshots.acquire() )
+        {
+            const RenderSnapshot& snapshot = iSnapshots.getReadBuffer();
+            if ( 0 == oCounters.newSnapshotCount++ )
+            {
+                firstStep = snapshot.step;
+            }
+            lastStep = snapshot.step;
+
+            mesh.buildTubes(snapshot);
+        }
+        ++oCounters.frameCount;
+
+        nextFrame += period;
+        std::this_thread::sleep_until(nextFrame);
+    }
+    oCounters.stepSpan = lastStep - firstStep;
+}
+
+// Print the memory held by iScene, see --memory-report.
+static void PrintMemoryReport(const Sim::NativeScene& iScene)
+{
+    Sim::NativeScene::MemoryReport report;
+    iScene.getMemoryReport(report);
+
+    std::cout << "Memory: " << report.getTotalBytes() / 1024.0 << " KiB" << std::endl;
+    for (size_t i=0; i<report.mechanisms.size(); ++i)
+    {
+        const Sim::NativeScene::MechanismMemory& mechanism = report.mechanisms[i];
+        std::cout << "  mechanism " << i << " " << mechanism.name << ": "
+                  << mechanism.parts.count << " parts " << mechanism.parts.bytes / 1024.0 << " KiB, "
+                  << mechanism.geometries.count << " geometries " << mechanism.geometries.bytes / 1024.0 << " KiB, "
+                  << mechanism.constraints.count << " constraints " << mechanism.constraints.bytes / 1024.0 << " KiB, "
+                  << mechanism.cables.count << " cables " << mechanism.cables.bytes / 1024.0 << " KiB" << std::endl;
+    }
+    std::cout << "  names " << report.nameBytes / 1024.0 << " KiB, solver " << report.solverBytes / 1024.0 << " KiB" << std::endl;
+    std::cout << "  arena: " << report.arenaBlockCount << " blocks, " << report.arenaReservedBytes / 1024.0 << " KiB reserved, "
+              << report.arenaAllocatedBytes / 1024.0 << " KiB allocated, " << report.arenaReleasedBytes / 1024.0 << " KiB released" << std::endl;
+}
+
+// Headless runner of the cableTest scenes on the native reference backend.
+//
+// It takes the same options as cableTest; there is never a window, and
+// when neither --steps nor --sim-time is given it runs 10 seconds of
+// simulated time.
+int main (int argc, const char * argv[])
+{
+    int returnValue = 0;
+
+    BatchOptions options;
+    if ( !options.parse(argc, argv) )
+    {
+        return 1;
+    }
+
+    try
+    {
+        Sim::NativeScene scene;
+
+        // Add a plane, so that the crane has something to run on.
+        Sim::MechanismId groundMechanism = scene.createMechanism("groundMechanism");
+        Sim::AssemblyId ground = scene.createAssembly(groundMechanism, "groundAssembly");
+        Sim::PartId plane = scene.createPart(ground, Sim::PartDefinition("ground", Sim::kPartStatic, Sim::Vec3()));
+        scene.addPlane(plane);
+
+        // There is no keyboard here: the controls can only be replayed.
+        ControlLog replayedControls;
+        if ( !options.replayControlsFileName.empty() && !replayedControls.load(options.replayControlsFileName) )
+        {
+            return 1;
+        }
+
+        std::unique_ptr<ExCableSystem> cableSystem;
+        std::unique_ptr<StressScene> stressScene;
+        if ( options.sceneName == "crane" )
+        {
+            Sim::CableDefinitionLoader cableLoader;
+            if ( !options.cableFileName.empty() && !cableLoader.load(options.cableFileName) )
+            {
+                return 1;
+            }
+            ExCableSystem::Settings settings;
+            settings.cableLoader = options.cableFileName.empty() ? NULL : &cableLoader;
+            settings.adaptiveSections = options.adaptiveSections;
+            settings.implicitCables = options.implicitCables;
+            settings.maxSectionLength = options.sectionLength;
+            cableSystem.reset(new ExCableSystem(scene, settings));
+        }
+        else if ( options.sceneName == "stress" )
+        {
+            StressScene::Settings settings;
+            settings.craneCount = options.craneCount;
+            settings.cablesPerCrane = options.cablesPerCrane;
+            settings.cableLength = options.cableLength;
+            if ( options.sectionLength > 0.0 )
+            {
+                settings.maxSectionLength = options.sectionLength;
+            }
+            settings.pulleyCount = options.pulleyCount;
+            settings.layout = options.layout;
+            settings.seed = options.seed;
+            settings.adaptiveSections = options.adaptiveSections;
+            settings.implicitCables = options.implicitCables;
+            stressScene.reset(new StressScene(scene, settings));
+            std::cout << "Stress scene: " << stressScene->getDescription() << ", " << scene.getPartCount() << " parts" << std::endl;
+        }
+        else if ( options.sceneName == "bricks" )
+        {
+            CreateBrickScene(scene, options.implicitCables);
+        }
+        else
+        {
+            std::cout << "Unknown scene " << options.sceneName << std::endl;
+            return 1;
+        }
+
+        // The checkpoint replaces the state of the scene just built.
+        if ( !options.loadCheckpointFileName.empty() )
+        {
+            const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+            if ( !scene.loadCheckpoint(options.loadCheckpointFileName) )
+            {
+                return 1;
+            }
+            const std::chrono::steady_clock::time_point loadEnd = std::chrono::steady_clock::now();
+            std::cout << "Restored " << options.loadCheckpointFileName << " at t = " << scene.getTime()
+                      << " s in " << std::chrono::duration<double, std::milli>(loadEnd - loadStart).count() << " ms" << std::endl;
+        }
+
+        // The implicit solve keeps the stiff cables at their length with a
+        // tenth of the substeps.
+        if ( options.implicitCables )
+        {
+            scene.setSubstepCount(scene.getSubstepCount() / 10);
+        }
+        if ( options.substepCount > 1 )
+        {
+            scene.setSubstepCount(scene.getSubstepCount() * options.substepCount);
+        }
+
+        // The main thread is the first worker of the pool.
+        std::unique_ptr<ThreadPool> pool;
+        if ( 1 != options.threadCount )
+        {
+            pool.reset(new ThreadPool(options.threadCount));
+            scene.setThreadPool(pool.get());
+        }
+
+        // The motion profiles are applied at every substep.
+        std::unique_ptr<CraneController> controller;
+        if ( !options.motionFileName.empty() )
+        {
+            controller.reset(new CraneController(*cableSystem->getCrane()));
+            if ( !controller->load(options.motionFileName) )
+            {
+                return 1;
+            }
+            scene.setSubstepCallback(controller.get());
+        }
+
+        size_t maxStepCount = options.getMaxStepCount();
+        if ( 0 == maxStepCount )
+        {
+            maxStepCount = static_cast<size_t>(10.0 / options.timeStep);
+        }
+
+        StepStatistics statistics;
+        statistics.reserve(maxStepCount);
+
+        // The ring keeps every step of the run so that the profile file is complete.
+        std::unique_ptr<StepProfiler> profiler;
+        if ( !options.profileFileName.empty() )
+        {
+            profiler.reset(new StepProfiler(maxStepCount));
+            scene.setProfiler(profiler.get());
+        }
+
+        TrajectoryRecorder recorder;
+        if ( !options.recordFileName.empty() && !recorder.open(options.recordFileName, scene) )
+        {
+            return 1;
+        }
+
+        SceneExporter exporter;
+        if ( !options.exportFileName.empty() && !exporter.open(options.exportFileName, scene) )
+        {
+            return 1;
+        }
+        if ( exporter.isOpen() )
+        {
+            exporter.reserve(maxStepCount);
+        }
+
+        // The monitoring thread only reads the names of the cables from the scene.
+        std::ofstream telemetryStream;
+        std::unique_ptr<CableTelemetry> telemetry;
+        std::atomic<bool> simulating(true);
+        std::thread monitor;
+        if ( !options.telemetryFileName.empty() )
+        {
+            telemetryStream.open(options.telemetryFileName.c_str());
+            if ( !telemetryStream )
+            {
+                std::cout << "Cannot write the telemetry to " << options.telemetryFileName << std::endl;
+                return 1;
+            }
+            telemetryStream << "step,time,cable,section,tension,strain,broken\n";
+            telemetry.reset(new CableTelemetry());
+            monitor = std::thread(MonitorTelemetry, std::ref(*telemetry), std::cref(scene), std::ref(telemetryStream), std::cref(simulating));
+        }
+
+        // The snapshots are drawn by the render thread at its own rate.
+        TripleBuffer<RenderSnapshot> snapshots;
+        RenderCounters renderCounters;
+        std::atomic<bool> rendering(true);
+        std::thread renderThread;
+        if ( options.renderRate > 0.0 )
+        {
+            renderThread = std::thread(RenderSnapshots, std::ref(snapshots), options.renderRate, std::cref(rendering), std::ref(renderCounters));
+        }
+
+        // In real time the steps run in frames paced by the scheduler.
+        FixedRateScheduler::Settings schedulerSettings;
+        schedulerSettings.stepRate = 1.0 / options.timeStep;
+        schedulerSettings.maxCatchUpSteps = options.maxCatchUpSteps;
+        FixedRateScheduler scheduler(schedulerSettings);
+        size_t frameSteps = 0;
+        if ( options.realTime )
+        {
+            scheduler.start();
+        }
+
+        for (size_t i=0; i<maxStepCount; ++i)
+        {
+            if ( options.realTime && 0 == frameSteps )
+            {
+                frameSteps = scheduler.waitForSteps();
+            }
+
+            if ( cableSystem )
+            {
+                replayedControls.apply(scene.getStepCount(), *cableSystem->getCrane());
+            }
+
+            if ( profiler )
+            {
+                profiler->beginStep();
+            }
+
+            const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+            scene.step(options.timeStep);
+            const std::chrono::steady_clock::time_point stepEnd = std::chrono::steady_clock::now();
+
+            statistics.addStep(std::chrono::duration<double>(stepEnd - stepStart).count());
+            if ( profiler )
+            {
+                profiler->endStep();
+            }
+
+            recorder.record(scene);
+            exporter.write(scene);
+            if ( telemetry )
+            {
+                telemetry->publish(scene);
+            }
+            if ( renderThread.joinable() )
+            {
+                snapshots.getWriteBuffer().capture(scene);
+                snapshots.publish();
+            }
+
+            if ( options.realTime && 0 == --frameSteps )
+            {
+                scheduler.endFrame();
+            }
+        }
+
+        // A frame cut short by the end of the run is not counted.
+        if ( options.realTime )
+        {
+            scheduler.printReport();
+        }
+
+        if ( renderThread.joinable() )
+        {
+            rendering.store(false, std::memory_order_release);
+            renderThread.join();
+            std::cout << "Render thread: " << renderCounters.frameCount << " frames at " << options.renderRate << " Hz, "
+                      << renderCounters.newSnapshotCount << " with a new snapshot, "
+                      << (renderCounters.newSnapshotCount > 1 ? static_cast<double>(renderCounters.stepSpan) / (renderCounters.newSnapshotCount - 1) : 0.0)
+                      << " steps between them" << std::endl;
+        }
+
+        if ( monitor.joinable() )
+        {
+            simulating.store(false, std::memory_order_release);
+            monitor.join();
+            std::cout << "Telemetry: " << telemetry->getPublishedCount() << " steps published, "
+                      << telemetry->getDroppedCount() << " frames and " << telemetry->getDroppedBreakCount() << " breaks dropped, "
+                      << telemetry->getTruncatedCount() << " frames truncated" << std::endl;
+            if ( !telemetryStream )
+            {
+                std::cout << "Cannot write the telemetry to " << options.telemetryFileName << std::endl;
+                returnValue = 1;
+            }
+        }
+
+        if ( recorder.isOpen() )
+        {
+            const size_t frameCount = recorder.getFrameCount();
+            const double frameBytes = static_cast<double>(recorder.getFrameBytes());
+            if ( !recorder.close() )
+            {
+                std::cout << "Cannot write the trajectory to " << options.recordFileName << std::endl;
+                returnValue = 1;
+            }
+            std::cout << "Recorded " << frameCount << " frames, " << (frameCount > 0 ? frameBytes / frameCount : 0.0) << " bytes per frame" << std::endl;
+        }
+
+        if ( exporter.isOpen() )
+        {
+            const size_t frameCount = exporter.getFrameCount();
+            const double frameBytes = static_cast<double>(exporter.getFrameBytes());
+            if ( !exporter.close() )
+            {
+                std::cout << "Cannot export the scene to " << options.exportFileName << std::endl;
+                returnValue = 1;
+            }
+            std::cout << "Exported " << frameCount << " frames, " << (frameCount > 0 ? frameBytes / frameCount : 0.0) << " bytes per frame" << std::endl;
+        }
+
+        if ( !options.saveCheckpointFileName.empty() && !scene.saveCheckpoint(options.saveCheckpointFileName) )
+        {
+            returnValue = 1;
+        }
+
+        std::cout << "Islands: " << scene.getIslandCount() << ", built " << scene.getIslandBuildCount() << " times, solved on "
+                  << (pool ? pool->getThreadCount() : 1) << " threads" << std::endl;
+
+        for (Sim::CableId cable=0; cable<static_cast<Sim::CableId>(scene.getCableCount()); ++cable)
+        {
+            std::cout << "Cable " << scene.getCableName(cable) << ": length " << scene.getCableLength(cable)
+                      << ", " << scene.getCableSectionCount(cable) << " sections"
+                      << ", " << scene.getCable(cable).getMemoryUsage() / 1024.0 << " KiB"
+                      << (scene.isCableBroken(cable) ? ", broken" : "") << std::endl;
+        }
+
+        if ( options.memoryReport )
+        {
+            PrintMemoryReport(scene);
+        }
+
+        statistics.printSummary(options.sceneName);
+        if ( !options.statsFileName.empty() && !statistics.writeSummary(options.statsFileName, options.sceneName) )
+        {
+            returnValue = 1;
+        }
+
+        if ( profiler )
+        {
+            profiler->printSummary();
+            if ( !profiler->writeCsv(options.profileFileName) )
+            {
+                returnValue = 1;
+            }
+        }
+    }
+    catch(const std::exception& ex )
+    {
+        std::cout << "Error : " << ex.what() << std::endl;
+        returnValue = 1;
+    }
+
+    return returnValue;
+}
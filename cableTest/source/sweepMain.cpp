@@ -0,0 +1,163 @@
+#include "CableDefinitionLoader.h"
+#include "ParameterSweep.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// Parse a comma separated list of numbers, like "100,10000,100000".
+static bool ParseList(const char* iText, std::vector<double>& oValues)
+{
+    oValues.clear();
+
+    std::istringstream stream(iText);
+    std::string item;
+    while ( std::getline(stream, item, ',') )
+    {
+        char* end = NULL;
+        const double value = strtod(item.c_str(), &end);
+        if ( item.empty() || *end != '\0' )
+        {
+            return false;
+        }
+        oValues.push_back(value);
+    }
+
+    return !oValues.empty();
+}
+
+static void PrintUsage(const char* iProgramName)
+{
+    std::cout << "Usage: " << iProgramName
+              << " [--stiffness list] [--damping list] [--section-length list] [--load-mass list] [--time-step list]"
+              << " [--sim-time t] [--winch-speed w] [--max-tension T] [--cable file] [--threads n] [--output file.csv]" << std::endl
+              << "Lists are comma separated, e.g. --stiffness 100,10000,100000; every combination is run." << std::endl;
+}
+
+// Parameter sweep of the crane lift on the native backend.
+//
+// Every combination of the lists given on the command line is simulated in
+// its own scene, the scenes running concurrently on a thread pool, and the
+// results are gathered in one table.
+int main (int argc, const char * argv[])
+{
+    ParameterSweep::Grid grid;
+    double simulationTime = 20.0;
+    double winchSpeed = -0.5;
+    double maxTension = 0.0;
+    size_t threadCount = 0;
+    std::string cableFileName;
+    std::string outputFileName;
+
+    for (int i=1; i<argc; ++i)
+    {
+        const char* option = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        bool valid = true;
+        if ( !hasValue )
+        {
+            valid = false;
+        }
+        else if ( 0 == strcmp(option, "--stiffness") )
+        {
+            valid = ParseList(argv[++i], grid.axialStiffness);
+        }
+        else if ( 0 == strcmp(option, "--damping") )
+        {
+            valid = ParseList(argv[++i], grid.axialDamping);
+        }
+        else if ( 0 == strcmp(option, "--section-length") )
+        {
+            valid = ParseList(argv[++i], grid.maxSectionLength);
+        }
+        else if ( 0 == strcmp(option, "--load-mass") )
+        {
+            valid = ParseList(argv[++i], grid.loadMass);
+        }
+        else if ( 0 == strcmp(option, "--time-step") )
+        {
+            valid = ParseList(argv[++i], grid.timeStep);
+            for (size_t j=0; valid && j<grid.timeStep.size(); ++j)
+            {
+                valid = grid.timeStep[j] > 0.0;
+            }
+        }
+        else if ( 0 == strcmp(option, "--sim-time") )
+        {
+            simulationTime = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--winch-speed") )
+        {
+            winchSpeed = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--max-tension") )
+        {
+            maxTension = atof(argv[++i]);
+        }
+        else if ( 0 == strcmp(option, "--cable") )
+        {
+            cableFileName = argv[++i];
+        }
+        else if ( 0 == strcmp(option, "--threads") )
+        {
+            threadCount = static_cast<size_t>(strtoul(argv[++i], NULL, 10));
+        }
+        else if ( 0 == strcmp(option, "--output") )
+        {
+            outputFileName = argv[++i];
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if ( !valid )
+        {
+            std::cout << "Unknown or invalid option " << option << std::endl;
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    int returnValue = 0;
+
+    try
+    {
+        Sim::CableDefinitionLoader cableLoader;
+        if ( !cableFileName.empty() && !cableLoader.load(cableFileName) )
+        {
+            return 1;
+        }
+
+        ParameterSweep sweep(grid, simulationTime);
+        sweep.setWinchSpeed(winchSpeed);
+        sweep.setMaxTension(maxTension);
+        sweep.setCableLoader(cableFileName.empty() ? NULL : &cableLoader);
+
+        ThreadPool pool(threadCount);
+        std::cout << "Running " << sweep.getPointCount() << " scenes on " << pool.getThreadCount() << " threads" << std::endl;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sweep.run(pool);
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        sweep.printTable();
+        std::cout << "Sweep done in " << elapsed << " s" << std::endl;
+
+        if ( !outputFileName.empty() && !sweep.writeTable(outputFileName) )
+        {
+            returnValue = 1;
+        }
+    }
+    catch(const std::exception& ex )
+    {
+        std::cout << "Error : " << ex.what() << std::endl;
+        returnValue = 1;
+    }
+
+    return returnValue;
+}
@@ -0,0 +1,147 @@
+#include "CableMeshBuilder.h"
+#include "SceneExporter.h"
+#include "SceneReader.h"
+#include "TrajectoryReader.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// True when iFileName starts like a scene written by SceneExporter.
+static bool IsExportedScene(const char* iFileName)
+{
+    std::ifstream stream(iFileName, std::ios::binary);
+    char magic[4];
+    return stream.read(magic, 4) && 0 == memcmp(magic, SceneExporter::kMagic, 4);
+}
+
+static int DumpScene(int argc, const char * argv[])
+{
+    SceneReader reader;
+    if ( !reader.open(argv[1]) )
+    {
+        return 1;
+    }
+
+    std::cout << argv[1] << ": " << reader.getFrameCount() << " frames" << std::endl;
+    if ( argc == 2 )
+    {
+        for (size_t i=0; i<reader.getPartCount(); ++i)
+        {
+            std::cout << "  part " << i << ": " << reader.getPartName(i) << ", " << reader.getPartGeometries(i).size() << " geometries" << std::endl;
+        }
+        for (size_t i=0; i<reader.getCableCount(); ++i)
+        {
+            std::cout << "  cable " << i << ": " << reader.getCableName(i) << ", radius " << reader.getCableRadius(i) << std::endl;
+        }
+        return 0;
+    }
+
+    SceneReader::Frame frame;
+    for (int i=2; i<argc; ++i)
+    {
+        const size_t index = static_cast<size_t>(strtoul(argv[i], NULL, 10));
+        if ( !reader.readFrame(index, frame) )
+        {
+            std::cout << "Cannot read frame " << index << std::endl;
+            return 1;
+        }
+
+        std::cout << "Frame " << index << ": step " << frame.step << ", time " << frame.time << std::endl;
+        for (size_t j=0; j<frame.parts.size(); ++j)
+        {
+            const SceneReader::PartState& part = frame.parts[j];
+            std::cout << "  " << reader.getPartName(j)
+                      << ": position " << part.position.x << " " << part.position.y << " " << part.position.z
+                      << ", orientation " << part.orientation.w << " " << part.orientation.x << " " << part.orientation.y << " " << part.orientation.z << std::endl;
+        }
+        for (size_t j=0; j<frame.cables.size(); ++j)
+        {
+            // The last float of an instance is the length of its section.
+            const std::vector<float>& instances = frame.cables[j].instances;
+            double length = 0.0;
+            for (size_t k=CableMeshBuilder::kInstanceSize - 1; k<instances.size(); k+=CableMeshBuilder::kInstanceSize)
+            {
+                length += instances[k];
+            }
+            std::cout << "  " << reader.getCableName(j) << ": " << instances.size() / CableMeshBuilder::kInstanceSize
+                      << " sections, length " << length << std::endl;
+        }
+    }
+
+    return 0;
+}
+
+// Print frames of a trajectory recorded with cableTestNative --record, or
+// of a scene exported with cableTestNative --export.
+//
+//   cableTestTrajectory <file>               list the parts and cables
+//   cableTestTrajectory <file> <frame>...    print the given frames
+int main (int argc, const char * argv[])
+{
+    if ( argc < 2 )
+    {
+        std::cout << "Usage: " << argv[0] << " file [frame...]" << std::endl;
+        return 1;
+    }
+
+    if ( IsExportedScene(argv[1]) )
+    {
+        return DumpScene(argc, argv);
+    }
+
+    TrajectoryReader reader;
+    if ( !reader.open(argv[1]) )
+    {
+        return 1;
+    }
+
+    std::cout << argv[1] << ": " << reader.getFrameCount() << " frames" << std::endl;
+    if ( argc == 2 )
+    {
+        for (size_t i=0; i<reader.getPartCount(); ++i)
+        {
+            std::cout << "  part " << i << ": " << reader.getPartName(i) << std::endl;
+        }
+        for (size_t i=0; i<reader.getCableCount(); ++i)
+        {
+            std::cout << "  cable " << i << ": " << reader.getCableName(i) << std::endl;
+        }
+        return 0;
+    }
+
+    TrajectoryReader::Frame frame;
+    for (int i=2; i<argc; ++i)
+    {
+        const size_t index = static_cast<size_t>(strtoul(argv[i], NULL, 10));
+        if ( !reader.readFrame(index, frame) )
+        {
+            std::cout << "Cannot read frame " << index << std::endl;
+            return 1;
+        }
+
+        std::cout << "Frame " << index << ": step " << frame.step << ", time " << frame.time << std::endl;
+        for (size_t j=0; j<frame.parts.size(); ++j)
+        {
+            const TrajectoryReader::PartState& part = frame.parts[j];
+            std::cout << "  " << reader.getPartName(j)
+                      << ": position " << part.position.x << " " << part.position.y << " " << part.position.z
+                      << ", orientation " << part.orientation.w << " " << part.orientation.x << " " << part.orientation.y << " " << part.orientation.z
+                      << ", velocity " << part.linearVelocity.x << " " << part.linearVelocity.y << " " << part.linearVelocity.z << std::endl;
+        }
+        for (size_t j=0; j<frame.cables.size(); ++j)
+        {
+            const TrajectoryReader::CableState& cable = frame.cables[j];
+            double maxTension = 0.0;
+            for (size_t k=0; k<cable.tensions.size(); ++k)
+            {
+                maxTension = cable.tensions[k] > maxTension ? cable.tensions[k] : maxTension;
+            }
+            std::cout << "  " << reader.getCableName(j) << ": " << cable.nodes.size() << " nodes, max tension " << maxTension
+                      << (cable.broken ? ", broken" : "") << std::endl;
+        }
+    }
+
+    return 0;
+}